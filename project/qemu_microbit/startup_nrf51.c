@@ -0,0 +1,111 @@
+#include <stdint.h>
+
+// QEMU microbit (nRF51822, Cortex-M0) 启动文件, 配合 nrf51.ld 使用
+
+// 由链接脚本定义
+extern uint32_t _sidata;
+extern uint32_t _sdata;
+extern uint32_t _edata;
+extern uint32_t _sbss;
+extern uint32_t _ebss;
+extern uint32_t _estack;
+
+extern int main(void);
+
+void Reset_Handler(void);
+void Default_Handler(void);
+
+// 内核异常, 未实现的默认进入 Default_Handler
+// Cortex-M0 没有 MemManage, BusFault, UsageFault 和 DebugMon
+void NMI_Handler(void) __attribute__((weak, alias("Default_Handler")));
+void HardFault_Handler(void) __attribute__((weak, alias("Default_Handler")));
+void SVC_Handler(void) __attribute__((weak, alias("Default_Handler")));
+void PendSV_Handler(void) __attribute__((weak, alias("Default_Handler")));
+void SysTick_Handler(void) __attribute__((weak, alias("Default_Handler")));
+
+// 向量表, 第一项为 MSP 的初始值, 链接到 0x00000000, Cortex-M0 没有 VTOR, 不能重定位
+__attribute__((section(".isr_vector"), used)) void (*const g_pfnVectors[16])(void) = {
+    (void (*)(void))&_estack,
+    Reset_Handler,
+    NMI_Handler,
+    HardFault_Handler,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    SVC_Handler,
+    0,
+    0,
+    PendSV_Handler,
+    SysTick_Handler,
+};
+
+// nRF51 UART0, QEMU 将其输出到 -serial (在 -nographic 下即标准输出)
+#define nrf51UART0_STARTTX_REG (*((volatile uint32_t *)0x40002008))
+#define nrf51UART0_TXDRDY_REG (*((volatile uint32_t *)0x4000211C))
+#define nrf51UART0_TXD_REG (*((volatile uint32_t *)0x4000251C))
+#define nrf51UART0_ENABLE_REG (*((volatile uint32_t *)0x40002500))
+#define nrf51UART_ENABLE_ENABLED (4UL)
+
+/**
+ * @brief 复位入口: 拷贝 .data, 清零 .bss, 使能串口发送, 然后进入 main
+ */
+void Reset_Handler(void)
+{
+    uint32_t *pulSrc = &_sidata;
+    uint32_t *pulDest = &_sdata;
+
+    while (pulDest < &_edata)
+    {
+        *pulDest++ = *pulSrc++;
+    }
+
+    for (pulDest = &_sbss; pulDest < &_ebss;)
+    {
+        *pulDest++ = 0UL;
+    }
+
+    nrf51UART0_ENABLE_REG = nrf51UART_ENABLE_ENABLED;
+    nrf51UART0_STARTTX_REG = 1UL;
+
+    (void)main();
+
+    for (;;)
+        ;
+}
+
+/**
+ * @brief newlib 的输出桩函数, 将 printf 等标准输出重定向到 UART0
+ * @param int iFile: 文件描述符, 未使用
+ * @param char *pcBuffer: 待输出的数据
+ * @param int iLength: 数据长度
+ * @returns int: 实际输出的长度
+ */
+int _write(int iFile, char *pcBuffer, int iLength)
+{
+    int i;
+
+    (void)iFile;
+    for (i = 0; i < iLength; i++)
+    {
+        nrf51UART0_TXD_REG = (uint32_t)(uint8_t)pcBuffer[i];
+        // 等待字节发出, 清除 TXDRDY 事件后才能写下一个字节
+        while (nrf51UART0_TXDRDY_REG == 0UL)
+            ;
+        nrf51UART0_TXDRDY_REG = 0UL;
+    }
+
+    return iLength;
+}
+
+/**
+ * @brief 未处理的异常, 停在这里便于用 gdb 查看现场
+ */
+void Default_Handler(void)
+{
+    for (;;)
+        ;
+}
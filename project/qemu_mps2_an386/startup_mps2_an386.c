@@ -0,0 +1,121 @@
+#include <stdint.h>
+
+// QEMU mps2-an386 (Cortex-M4F) 启动文件, 配合 mps2_an386.ld 使用
+
+// 由链接脚本定义
+extern uint32_t _sidata;
+extern uint32_t _sdata;
+extern uint32_t _edata;
+extern uint32_t _sbss;
+extern uint32_t _ebss;
+extern uint32_t _estack;
+
+extern int main(void);
+
+void Reset_Handler(void);
+void Default_Handler(void);
+
+// 内核异常, 未实现的默认进入 Default_Handler
+void NMI_Handler(void) __attribute__((weak, alias("Default_Handler")));
+void HardFault_Handler(void) __attribute__((weak, alias("Default_Handler")));
+void MemManage_Handler(void) __attribute__((weak, alias("Default_Handler")));
+void BusFault_Handler(void) __attribute__((weak, alias("Default_Handler")));
+void UsageFault_Handler(void) __attribute__((weak, alias("Default_Handler")));
+void SVC_Handler(void) __attribute__((weak, alias("Default_Handler")));
+void DebugMon_Handler(void) __attribute__((weak, alias("Default_Handler")));
+void PendSV_Handler(void) __attribute__((weak, alias("Default_Handler")));
+void SysTick_Handler(void) __attribute__((weak, alias("Default_Handler")));
+
+// 向量表, 第一项为 MSP 的初始值, 链接到 0x00000000
+__attribute__((section(".isr_vector"), used)) void (*const g_pfnVectors[16])(void) = {
+    (void (*)(void))&_estack,
+    Reset_Handler,
+    NMI_Handler,
+    HardFault_Handler,
+    MemManage_Handler,
+    BusFault_Handler,
+    UsageFault_Handler,
+    0,
+    0,
+    0,
+    0,
+    SVC_Handler,
+    DebugMon_Handler,
+    0,
+    PendSV_Handler,
+    SysTick_Handler,
+};
+
+// CMSDK UART0, QEMU 将其输出到 -serial (在 -nographic 下即标准输出)
+#define mps2UART0_DATA_REG (*((volatile uint32_t *)0x40004000))
+#define mps2UART0_STATE_REG (*((volatile uint32_t *)0x40004004))
+#define mps2UART0_CTRL_REG (*((volatile uint32_t *)0x40004008))
+#define mps2UART0_BAUDDIV_REG (*((volatile uint32_t *)0x40004010))
+#define mps2UART_CTRL_TX_EN (1UL << 0UL)
+#define mps2UART_STATE_TX_FULL (1UL << 0UL)
+
+// 协处理器访问控制寄存器 CPACR, CP10, CP11 设为完全访问.
+// 以 -mfloat-abi=hard 编译的 main() 和 C 库在调度器启动前就可能使用浮点寄存器
+#define mps2SCB_CPACR_REG (*((volatile uint32_t *)0xE000ED88))
+#define mps2CPACR_CP10_CP11_FULL (0xfUL << 20UL)
+
+/**
+ * @brief 复位入口: 使能 FPU, 拷贝 .data, 清零 .bss, 使能串口发送, 然后进入 main
+ */
+void Reset_Handler(void)
+{
+    uint32_t *pulSrc = &_sidata;
+    uint32_t *pulDest = &_sdata;
+
+    mps2SCB_CPACR_REG |= mps2CPACR_CP10_CP11_FULL;
+    __asm volatile("dsb\n isb" ::: "memory");
+
+    while (pulDest < &_edata)
+    {
+        *pulDest++ = *pulSrc++;
+    }
+
+    for (pulDest = &_sbss; pulDest < &_ebss;)
+    {
+        *pulDest++ = 0UL;
+    }
+
+    mps2UART0_BAUDDIV_REG = 16UL;
+    mps2UART0_CTRL_REG = mps2UART_CTRL_TX_EN;
+
+    (void)main();
+
+    for (;;)
+        ;
+}
+
+/**
+ * @brief newlib 的输出桩函数, 将 printf 等标准输出重定向到 UART0
+ * @param int iFile: 文件描述符, 未使用
+ * @param char *pcBuffer: 待输出的数据
+ * @param int iLength: 数据长度
+ * @returns int: 实际输出的长度
+ */
+int _write(int iFile, char *pcBuffer, int iLength)
+{
+    int i;
+
+    (void)iFile;
+    for (i = 0; i < iLength; i++)
+    {
+        while ((mps2UART0_STATE_REG & mps2UART_STATE_TX_FULL) != 0UL)
+            ;
+        mps2UART0_DATA_REG = (uint32_t)pcBuffer[i];
+    }
+
+    return iLength;
+}
+
+/**
+ * @brief 未处理的异常, 停在这里便于用 gdb 查看现场
+ */
+void Default_Handler(void)
+{
+    for (;;)
+        ;
+}
@@ -0,0 +1,524 @@
+#include "active_object.h"
+#include "task.h"
+#include "queue.h"
+#include "portmacro.h"
+#include "rtos_config.h"
+#include "projectdefs.h"
+
+#if (configUSE_ACTIVE_OBJECTS == 1)
+
+/******************************************************************************/
+// 已注册的事件池, 按块大小升序排列
+static EventPool_t *pxEventPools[configAO_MAX_EVENT_POOLS] = {0};
+static UBaseType_t uxNumOfEventPools = 0U;
+
+// 已启动的活动对象, 下标即活动对象编号
+static ActiveObject_t *pxActiveObjects[configAO_MAX_ACTIVE_OBJECTS] = {0};
+
+// 订阅表, 每个信号对应一个活动对象编号的位图
+static volatile uint32_t ulSubscriberList[configAO_MAX_PUB_SIGNALS] = {0};
+
+// 已启动的时间事件链表, 只在 tick 中摘除
+static TimeEvent_t *pxTimeEventList = NULL;
+
+// 活动对象启动时分发的初始化事件
+static const Event_t xInitEvent = {aoINIT_SIG, 0U, 0U};
+/******************************************************************************/
+
+/******************************************************************************/
+/**
+ * @brief 初始化并注册一个事件池, 事件池须按块大小升序注册
+ * @param EventPool_t *const pxPool: 事件池控制块
+ * @param void *const pvPoolStorage: 事件池存储区, 按指针大小对齐
+ * @param const UBaseType_t uxPoolSize: 存储区大小, 单位为字节
+ * @param const UBaseType_t uxBlockSize: 每块的大小, 单位为字节, 不小于最大的事件
+ */
+void vActiveObjectPoolInit(EventPool_t *const pxPool,
+                           void *const pvPoolStorage,
+                           const UBaseType_t uxPoolSize,
+                           const UBaseType_t uxBlockSize)
+{
+    UBaseType_t uxSize = uxBlockSize;
+    uint8_t *pucBlock = (uint8_t *)pvPoolStorage;
+    void **ppvLink = &(pxPool->pvFreeList);
+
+    configASSERT(uxNumOfEventPools < (UBaseType_t)configAO_MAX_EVENT_POOLS);
+    configASSERT((uxNumOfEventPools == 0U) ||
+                 (pxEventPools[uxNumOfEventPools - 1U]->uxBlockSize < uxBlockSize));
+
+    // 块大小向上对齐到指针大小, 且至少能放下空闲链表的指针
+    if (uxSize < (UBaseType_t)sizeof(void *))
+    {
+        uxSize = (UBaseType_t)sizeof(void *);
+    }
+    uxSize = (uxSize + (UBaseType_t)(sizeof(void *) - 1U)) & ~((UBaseType_t)(sizeof(void *) - 1U));
+
+    pxPool->uxBlockSize = uxSize;
+    pxPool->uxFreeBlocks = 0U;
+
+    // 将存储区切分成块, 串成空闲链表
+    while ((UBaseType_t)((pucBlock + uxSize) - (uint8_t *)pvPoolStorage) <= uxPoolSize)
+    {
+        *ppvLink = (void *)pucBlock;
+        ppvLink = (void **)pucBlock;
+        pucBlock += uxSize;
+        pxPool->uxFreeBlocks++;
+    }
+    *ppvLink = NULL;
+    pxPool->uxMinFreeBlocks = pxPool->uxFreeBlocks;
+
+    taskENTER_CRITICAL();
+    {
+        pxEventPools[uxNumOfEventPools] = pxPool;
+        uxNumOfEventPools++;
+    }
+    taskEXIT_CRITICAL();
+}
+
+/**
+ * @brief 从事件池中分配一个事件, 可在中断中调用
+ * @param const UBaseType_t uxEventSize: 事件大小, 单位为字节, 通常为 sizeof(用户事件类型)
+ * @param const EventSignal_t xSignal: 事件信号
+ * @returns Event_t *: 事件地址, 没有足够大的空闲块时返回 NULL
+ */
+Event_t *pxActiveObjectNewEvent(const UBaseType_t uxEventSize, const EventSignal_t xSignal)
+{
+    Event_t *pxEvent = NULL;
+    EventPool_t *pxPool = NULL;
+    UBaseType_t uxPoolIndex = 0U;
+    uint32_t ulSavedInterruptStatus = 0;
+
+    // 选择第一个放得下该事件的事件池
+    for (uxPoolIndex = 0U; uxPoolIndex < uxNumOfEventPools; uxPoolIndex++)
+    {
+        if (pxEventPools[uxPoolIndex]->uxBlockSize >= uxEventSize)
+        {
+            pxPool = pxEventPools[uxPoolIndex];
+            break;
+        }
+    }
+    configASSERT(pxPool != NULL);
+
+    if (pxPool == NULL)
+    {
+        return NULL;
+    }
+
+    ulSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+    {
+        pxEvent = (Event_t *)pxPool->pvFreeList;
+
+        if (pxEvent != NULL)
+        {
+            pxPool->pvFreeList = *((void **)pxEvent);
+            pxPool->uxFreeBlocks--;
+
+            if (pxPool->uxFreeBlocks < pxPool->uxMinFreeBlocks)
+            {
+                pxPool->uxMinFreeBlocks = pxPool->uxFreeBlocks;
+            }
+        }
+    }
+    taskEXIT_CRITICAL_FROM_ISR(ulSavedInterruptStatus);
+
+    if (pxEvent != NULL)
+    {
+        pxEvent->xSignal = xSignal;
+        pxEvent->ucPoolId = (uint8_t)(uxPoolIndex + 1U);
+        pxEvent->ucRefCount = 0U;
+    }
+
+    return pxEvent;
+}
+
+/**
+ * @brief 私有函数, 增加事件的引用计数
+ * @param const Event_t *const pxEvent
+ */
+static void prvEventReference(const Event_t *const pxEvent)
+{
+    uint32_t ulSavedInterruptStatus = 0;
+
+    if (pxEvent->ucPoolId != 0U)
+    {
+        ulSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+        {
+            ((Event_t *)pxEvent)->ucRefCount++;
+        }
+        taskEXIT_CRITICAL_FROM_ISR(ulSavedInterruptStatus);
+    }
+}
+
+/**
+ * @brief 释放对事件的一次引用, 引用计数归零时将事件归还事件池, 可在中断中调用
+ * @param const Event_t *const pxEvent
+ */
+void vActiveObjectGarbageCollect(const Event_t *const pxEvent)
+{
+    Event_t *const pxMutableEvent = (Event_t *)pxEvent;
+    EventPool_t *pxPool = NULL;
+    uint32_t ulSavedInterruptStatus = 0;
+
+    // 静态事件永不回收
+    if (pxEvent->ucPoolId == 0U)
+    {
+        return;
+    }
+
+    pxPool = pxEventPools[pxEvent->ucPoolId - 1U];
+
+    ulSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+    {
+        if (pxMutableEvent->ucRefCount > 1U)
+        {
+            pxMutableEvent->ucRefCount--;
+        }
+        else
+        {
+            pxMutableEvent->ucRefCount = 0U;
+            *((void **)pxMutableEvent) = pxPool->pvFreeList;
+            pxPool->pvFreeList = (void *)pxMutableEvent;
+            pxPool->uxFreeBlocks++;
+        }
+    }
+    taskEXIT_CRITICAL_FROM_ISR(ulSavedInterruptStatus);
+}
+/******************************************************************************/
+
+/******************************************************************************/
+/**
+ * @brief 私有函数, 活动对象的事件循环: 取事件, 分发, 回收
+ * @param void *pvParameters: 活动对象
+ */
+static void prvActiveObjectThread(void *pvParameters)
+{
+    ActiveObject_t *const pxAO = (ActiveObject_t *)pvParameters;
+    const Event_t *pxEvent = NULL;
+
+    pxAO->pxDispatch(pxAO, &xInitEvent);
+
+    for (;;)
+    {
+        (void)xQueueReceive(pxAO->xQueue, (void *)&pxEvent, portMAX_DELAY);
+
+        pxAO->pxDispatch(pxAO, pxEvent);
+
+        vActiveObjectGarbageCollect(pxEvent);
+    }
+}
+
+/**
+ * @brief 启动活动对象, 创建其事件队列和事件循环任务
+ * @param ActiveObject_t *const pxAO: 活动对象
+ * @param ActiveObjectDispatch_t pxDispatch: 事件分发函数, 启动后首先收到 aoINIT_SIG 事件
+ * @param const char *const pcName: 任务名称
+ * @param UBaseType_t uxPriority: 任务优先级
+ * @param const Event_t **ppxQueueStorage: 事件队列存储区, 长度为 uxQueueLength 的 Event_t 指针数组
+ * @param const UBaseType_t uxQueueLength: 事件队列长度
+ * @param StackType_t *const puxStackBuffer: 任务栈起始地址
+ * @param const uint32_t ulStackDepth: 任务栈大小, 单位为字
+ */
+void vActiveObjectStart(ActiveObject_t *const pxAO,
+                        ActiveObjectDispatch_t pxDispatch,
+                        const char *const pcName,
+                        UBaseType_t uxPriority,
+                        const Event_t **ppxQueueStorage,
+                        const UBaseType_t uxQueueLength,
+                        StackType_t *const puxStackBuffer,
+                        const uint32_t ulStackDepth)
+{
+    UBaseType_t uxId = 0U;
+
+    pxAO->pxDispatch = pxDispatch;
+    pxAO->xQueue = xQueueCreateStatic(uxQueueLength,
+                                      (UBaseType_t)sizeof(Event_t *),
+                                      (uint8_t *)ppxQueueStorage,
+                                      &(pxAO->xQueueBuffer));
+    configASSERT(pxAO->xQueue != NULL);
+
+    taskENTER_CRITICAL();
+    {
+        for (uxId = 0U; uxId < (UBaseType_t)configAO_MAX_ACTIVE_OBJECTS; uxId++)
+        {
+            if (pxActiveObjects[uxId] == NULL)
+            {
+                pxActiveObjects[uxId] = pxAO;
+                break;
+            }
+        }
+    }
+    taskEXIT_CRITICAL();
+    configASSERT(uxId < (UBaseType_t)configAO_MAX_ACTIVE_OBJECTS);
+    pxAO->uxId = uxId;
+
+    pxAO->xTask = xTaskCreateStatic((TaskFuntion_t)prvActiveObjectThread,
+                                    pcName,
+                                    ulStackDepth,
+                                    (void *)pxAO,
+                                    uxPriority,
+                                    puxStackBuffer,
+                                    &(pxAO->xTCB));
+}
+
+/**
+ * @brief 向活动对象投递事件, 只投递指针, 不拷贝事件, 不会阻塞
+ * @param ActiveObject_t *const pxAO: 活动对象
+ * @param const Event_t *const pxEvent: 事件
+ * @returns BaseType_t: pdPASS 投递成功, pdFAIL 事件队列已满
+ */
+BaseType_t xActiveObjectPost(ActiveObject_t *const pxAO, const Event_t *const pxEvent)
+{
+    prvEventReference(pxEvent);
+
+    if (xQueueSend(pxAO->xQueue, (const void *)&pxEvent, 0) != pdPASS)
+    {
+        vActiveObjectGarbageCollect(pxEvent);
+        return pdFAIL;
+    }
+
+    return pdPASS;
+}
+
+/**
+ * @brief 在中断中向活动对象投递事件
+ * @param ActiveObject_t *const pxAO: 活动对象
+ * @param const Event_t *const pxEvent: 事件
+ * @param BaseType_t *const pxHigherPriorityTaskWoken: 唤醒了更高优先级任务时置为 pdTRUE, 中断退出前应调用 portYIELD()
+ * @returns BaseType_t: pdPASS 投递成功, pdFAIL 事件队列已满
+ */
+BaseType_t xActiveObjectPostFromISR(ActiveObject_t *const pxAO,
+                                    const Event_t *const pxEvent,
+                                    BaseType_t *const pxHigherPriorityTaskWoken)
+{
+    prvEventReference(pxEvent);
+
+    if (xQueueSendFromISR(pxAO->xQueue, (const void *)&pxEvent, pxHigherPriorityTaskWoken) != pdPASS)
+    {
+        vActiveObjectGarbageCollect(pxEvent);
+        return pdFAIL;
+    }
+
+    return pdPASS;
+}
+/******************************************************************************/
+
+/******************************************************************************/
+/**
+ * @brief 订阅信号
+ * @param const ActiveObject_t *const pxAO: 活动对象
+ * @param const EventSignal_t xSignal: 信号, 小于 configAO_MAX_PUB_SIGNALS
+ */
+void vActiveObjectSubscribe(const ActiveObject_t *const pxAO, const EventSignal_t xSignal)
+{
+    configASSERT(xSignal < (EventSignal_t)configAO_MAX_PUB_SIGNALS);
+
+    taskENTER_CRITICAL();
+    {
+        ulSubscriberList[xSignal] |= (1UL << pxAO->uxId);
+    }
+    taskEXIT_CRITICAL();
+}
+
+/**
+ * @brief 取消订阅信号
+ * @param const ActiveObject_t *const pxAO: 活动对象
+ * @param const EventSignal_t xSignal: 信号, 小于 configAO_MAX_PUB_SIGNALS
+ */
+void vActiveObjectUnsubscribe(const ActiveObject_t *const pxAO, const EventSignal_t xSignal)
+{
+    configASSERT(xSignal < (EventSignal_t)configAO_MAX_PUB_SIGNALS);
+
+    taskENTER_CRITICAL();
+    {
+        ulSubscriberList[xSignal] &= ~(1UL << pxAO->uxId);
+    }
+    taskEXIT_CRITICAL();
+}
+
+/**
+ * @brief 发布事件, 投递给所有订阅了该信号的活动对象, 所有订阅者共享同一个事件, 只能在任务中调用
+ * @param const Event_t *const pxEvent: 事件
+ */
+void vActiveObjectPublish(const Event_t *const pxEvent)
+{
+    uint32_t ulSubscribers = 0UL;
+    UBaseType_t uxId = 0U;
+
+    configASSERT(pxEvent->xSignal < (EventSignal_t)configAO_MAX_PUB_SIGNALS);
+
+    // 先持有一次引用, 防止先收到事件的订阅者处理完后在投递结束前把事件回收
+    prvEventReference(pxEvent);
+
+    ulSubscribers = ulSubscriberList[pxEvent->xSignal];
+
+    // 按编号从高到低投递
+    while (ulSubscribers != 0UL)
+    {
+        portGET_HIGHEST_PRIORITY(uxId, ulSubscribers);
+        ulSubscribers &= ~(1UL << uxId);
+
+        (void)xActiveObjectPost(pxActiveObjects[uxId], pxEvent);
+    }
+
+    vActiveObjectGarbageCollect(pxEvent);
+}
+/******************************************************************************/
+
+/******************************************************************************/
+/**
+ * @brief 初始化时间事件
+ * @param TimeEvent_t *const pxTimeEvent: 时间事件
+ * @param ActiveObject_t *const pxAO: 到期后投递给的活动对象
+ * @param const EventSignal_t xSignal: 信号
+ */
+void vTimeEventInit(TimeEvent_t *const pxTimeEvent,
+                    ActiveObject_t *const pxAO,
+                    const EventSignal_t xSignal)
+{
+    pxTimeEvent->xSuper.xSignal = xSignal;
+    pxTimeEvent->xSuper.ucPoolId = 0U;
+    pxTimeEvent->xSuper.ucRefCount = 0U;
+    pxTimeEvent->pxAO = pxAO;
+    pxTimeEvent->xCtr = 0U;
+    pxTimeEvent->xInterval = 0U;
+    pxTimeEvent->pxNext = NULL;
+    pxTimeEvent->xLinked = pdFALSE;
+}
+
+/**
+ * @brief 启动时间事件, 已启动的时间事件会被重新计时, 可在中断中调用
+ * @param TimeEvent_t *const pxTimeEvent: 时间事件
+ * @param const TickType_t xTicks: 首次到期的 tick 数, 不能为 0
+ * @param const TickType_t xInterval: 周期, 为 0 表示单次
+ */
+void vTimeEventArm(TimeEvent_t *const pxTimeEvent,
+                   const TickType_t xTicks,
+                   const TickType_t xInterval)
+{
+    uint32_t ulSavedInterruptStatus = 0;
+
+    configASSERT(xTicks != (TickType_t)0U);
+
+    ulSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+    {
+        pxTimeEvent->xCtr = xTicks;
+        pxTimeEvent->xInterval = xInterval;
+
+        if (pxTimeEvent->xLinked == pdFALSE)
+        {
+            pxTimeEvent->pxNext = pxTimeEventList;
+            pxTimeEventList = pxTimeEvent;
+            pxTimeEvent->xLinked = pdTRUE;
+        }
+    }
+    taskEXIT_CRITICAL_FROM_ISR(ulSavedInterruptStatus);
+}
+
+/**
+ * @brief 停止时间事件, 从链表中摘除的动作推迟到下一个 tick 中完成, 可在中断中调用
+ * @param TimeEvent_t *const pxTimeEvent: 时间事件
+ * @returns BaseType_t: 停止前处于启动状态返回 pdTRUE, 否则返回 pdFALSE(可能已经到期并投递)
+ */
+BaseType_t xTimeEventDisarm(TimeEvent_t *const pxTimeEvent)
+{
+    BaseType_t xWasArmed = pdFALSE;
+    uint32_t ulSavedInterruptStatus = 0;
+
+    ulSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+    {
+        xWasArmed = (pxTimeEvent->xCtr != (TickType_t)0U) ? pdTRUE : pdFALSE;
+        pxTimeEvent->xCtr = 0U;
+    }
+    taskEXIT_CRITICAL_FROM_ISR(ulSavedInterruptStatus);
+
+    return xWasArmed;
+}
+
+/**
+ * @brief 时间事件服务, 由 xTaskIncrementTick() 在每个 tick 中调用, 调用时中断已屏蔽
+ */
+void vActiveObjectTickFromISR(void)
+{
+    TimeEvent_t *pxPrevious = NULL;
+    TimeEvent_t *pxTimeEvent = pxTimeEventList;
+    TimeEvent_t *pxNext = NULL;
+
+    while (pxTimeEvent != NULL)
+    {
+        pxNext = pxTimeEvent->pxNext;
+
+        if (pxTimeEvent->xCtr == (TickType_t)0U)
+        {
+            // 已停止或已到期的单次时间事件, 从链表中摘除
+            if (pxPrevious == NULL)
+            {
+                pxTimeEventList = pxNext;
+            }
+            else
+            {
+                pxPrevious->pxNext = pxNext;
+            }
+            pxTimeEvent->xLinked = pdFALSE;
+        }
+        else
+        {
+            pxTimeEvent->xCtr--;
+
+            if (pxTimeEvent->xCtr == (TickType_t)0U)
+            {
+                // 周期时间事件重新装载, 单次时间事件在下一个 tick 中摘除
+                pxTimeEvent->xCtr = pxTimeEvent->xInterval;
+
+                (void)xActiveObjectPostFromISR(pxTimeEvent->pxAO, &(pxTimeEvent->xSuper), NULL);
+            }
+
+            pxPrevious = pxTimeEvent;
+        }
+
+        pxTimeEvent = pxNext;
+    }
+}
+
+#if (configUSE_VIRTUAL_TIME == 1)
+/**
+ * @brief 距离最近一个时间事件到期还有多少个 tick, 调用时中断已屏蔽
+ * @returns TickType_t: 0 表示没有已装载的时间事件
+ */
+TickType_t xActiveObjectTicksToNextEvent(void)
+{
+    TickType_t xTicks = 0U;
+    const TimeEvent_t *pxTimeEvent = NULL;
+
+    for (pxTimeEvent = pxTimeEventList; pxTimeEvent != NULL; pxTimeEvent = pxTimeEvent->pxNext)
+    {
+        if ((pxTimeEvent->xCtr != (TickType_t)0U) &&
+            ((xTicks == (TickType_t)0U) || (pxTimeEvent->xCtr < xTicks)))
+        {
+            xTicks = pxTimeEvent->xCtr;
+        }
+    }
+
+    return xTicks;
+}
+
+/**
+ * @brief 时基跳过若干个 tick 时同步推进时间事件的计数, 跳过的 tick 中不能有时间事件到期
+ * @param const TickType_t xTicksToJump: 跳过的 tick 数
+ */
+void vActiveObjectStepTick(const TickType_t xTicksToJump)
+{
+    TimeEvent_t *pxTimeEvent = NULL;
+
+    for (pxTimeEvent = pxTimeEventList; pxTimeEvent != NULL; pxTimeEvent = pxTimeEvent->pxNext)
+    {
+        if (pxTimeEvent->xCtr != (TickType_t)0U)
+        {
+            configASSERT(pxTimeEvent->xCtr > xTicksToJump);
+            pxTimeEvent->xCtr -= xTicksToJump;
+        }
+    }
+}
+#endif
+/******************************************************************************/
+
+#endif
@@ -0,0 +1,227 @@
+#include "condvar.h"
+#include "task.h"
+#include "portmacro.h"
+#include "rtos_config.h"
+#include "projectdefs.h"
+#include "list.h"
+
+#if (configUSE_CONDITION_VARIABLES == 1)
+
+/******************************************************************************/
+/**
+ * @brief 初始化条件变量
+ * @param CondVar_t *const pxCond
+ */
+void vCondVarInit(CondVar_t *const pxCond)
+{
+    vListInitialise(&(pxCond->xTasksWaiting));
+}
+
+/**
+ * @brief 释放互斥量并等待条件变量, 返回前重新获取互斥量
+ *
+ * 释放互斥量与挂入等待列表在同一个临界段内完成, 期间发出的通知不会丢失.
+ * 返回后调用者应重新检查条件, 超时时刻与通知同时到达时可能报告超时
+ *
+ * @param CondVar_t *const pxCond
+ * @param SemaphoreHandle_t xMutex: 调用者持有的互斥量
+ * @param TickType_t xTicksToWait: 最长等待时间, portMAX_DELAY 表示无限期等待
+ * @returns BaseType_t: pdTRUE 被通知唤醒, pdFALSE 超时
+ */
+BaseType_t xCondVarWait(CondVar_t *const pxCond,
+                        SemaphoreHandle_t xMutex,
+                        TickType_t xTicksToWait)
+{
+    BaseType_t xReturn = pdTRUE;
+    TimeOut_t xTimeOut;
+
+    configASSERT(xSemaphoreGetMutexHolder(xMutex) == xTaskGetCurrentTaskHandle());
+
+    taskENTER_CRITICAL();
+    {
+        vTaskSetTimeOutState(&xTimeOut);
+        (void)xSemaphoreGive(xMutex);
+
+        if (xTicksToWait == (TickType_t)0)
+        {
+            xReturn = pdFALSE;
+        }
+        else
+        {
+            // 退出临界段后 PendSV 立即执行任务切换, 被唤醒或超时后从这里继续
+            vTaskPlaceOnEventList(&(pxCond->xTasksWaiting), xTicksToWait);
+            taskYIELD();
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    if (xReturn != pdFALSE)
+    {
+        taskENTER_CRITICAL();
+        {
+            if (xTaskCheckForTimeOut(&xTimeOut, &xTicksToWait) != pdFALSE)
+            {
+                xReturn = pdFALSE;
+            }
+        }
+        taskEXIT_CRITICAL();
+    }
+
+    (void)xSemaphoreTake(xMutex, portMAX_DELAY);
+
+    return xReturn;
+}
+
+/**
+ * @brief 唤醒等待条件变量的任务中优先级最高的一个
+ * @param CondVar_t *const pxCond
+ * @returns BaseType_t: pdTRUE 唤醒了一个任务, pdFALSE 没有任务在等待
+ */
+BaseType_t xCondVarSignal(CondVar_t *const pxCond)
+{
+    BaseType_t xReturn = pdFALSE;
+
+    taskENTER_CRITICAL();
+    {
+        if (listLIST_IS_EMPTY(&(pxCond->xTasksWaiting)) == pdFALSE)
+        {
+            if (xTaskRemoveFromEventList(&(pxCond->xTasksWaiting)) != pdFALSE)
+            {
+                taskYIELD();
+            }
+            xReturn = pdTRUE;
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    return xReturn;
+}
+
+/**
+ * @brief 唤醒等待条件变量的所有任务, 在一个临界段内遍历一次等待列表
+ * @param CondVar_t *const pxCond
+ * @returns UBaseType_t: 唤醒的任务数
+ */
+UBaseType_t uxCondVarBroadcast(CondVar_t *const pxCond)
+{
+    UBaseType_t uxWoken = 0U;
+    BaseType_t xYieldRequired = pdFALSE;
+
+    taskENTER_CRITICAL();
+    {
+        while (listLIST_IS_EMPTY(&(pxCond->xTasksWaiting)) == pdFALSE)
+        {
+            if (xTaskRemoveFromEventList(&(pxCond->xTasksWaiting)) != pdFALSE)
+            {
+                xYieldRequired = pdTRUE;
+            }
+            uxWoken++;
+        }
+
+        if (xYieldRequired != pdFALSE)
+        {
+            taskYIELD();
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    return uxWoken;
+}
+/******************************************************************************/
+
+/******************************************************************************/
+/**
+ * @brief 初始化屏障
+ * @param Barrier_t *const pxBarrier
+ * @param const UBaseType_t uxParties: 每一轮需要到达的任务数, 至少为 1
+ */
+void vBarrierInit(Barrier_t *const pxBarrier, const UBaseType_t uxParties)
+{
+    configASSERT(uxParties != (UBaseType_t)0U);
+
+    vListInitialise(&(pxBarrier->xTasksWaiting));
+    pxBarrier->uxParties = uxParties;
+    pxBarrier->uxArrived = (UBaseType_t)0U;
+    pxBarrier->ulGeneration = 0UL;
+}
+
+/**
+ * @brief 到达屏障并等待本轮其余任务到达
+ * @param Barrier_t *const pxBarrier
+ * @param TickType_t xTicksToWait: 最长等待时间, portMAX_DELAY 表示无限期等待
+ * @returns BaseType_t: barrierSERIAL_TASK 本任务最后到达并放行了本轮, pdPASS 被放行, pdFAIL 超时, 本任务不再计入本轮
+ */
+BaseType_t xBarrierWait(Barrier_t *const pxBarrier, TickType_t xTicksToWait)
+{
+    BaseType_t xEntryTimeSet = pdFALSE;
+    BaseType_t xYieldRequired = pdFALSE;
+    uint32_t ulGeneration = 0UL;
+    TimeOut_t xTimeOut;
+
+    taskENTER_CRITICAL();
+    {
+        ulGeneration = pxBarrier->ulGeneration;
+        pxBarrier->uxArrived++;
+
+        if (pxBarrier->uxArrived >= pxBarrier->uxParties)
+        {
+            // 最后一个到达, 进入下一轮并一次唤醒所有等待者
+            pxBarrier->uxArrived = (UBaseType_t)0U;
+            pxBarrier->ulGeneration++;
+
+            while (listLIST_IS_EMPTY(&(pxBarrier->xTasksWaiting)) == pdFALSE)
+            {
+                if (xTaskRemoveFromEventList(&(pxBarrier->xTasksWaiting)) != pdFALSE)
+                {
+                    xYieldRequired = pdTRUE;
+                }
+            }
+
+            if (xYieldRequired != pdFALSE)
+            {
+                taskYIELD();
+            }
+
+            taskEXIT_CRITICAL();
+            return barrierSERIAL_TASK;
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    for (;;)
+    {
+        taskENTER_CRITICAL();
+        {
+            if (pxBarrier->ulGeneration != ulGeneration)
+            {
+                taskEXIT_CRITICAL();
+                return pdPASS;
+            }
+
+            if (xEntryTimeSet == pdFALSE)
+            {
+                vTaskSetTimeOutState(&xTimeOut);
+                xEntryTimeSet = pdTRUE;
+            }
+            else if (xTaskCheckForTimeOut(&xTimeOut, &xTicksToWait) != pdFALSE)
+            {
+                xTicksToWait = (TickType_t)0;
+            }
+
+            if (xTicksToWait == (TickType_t)0)
+            {
+                // 放弃本轮, 撤销到达计数
+                pxBarrier->uxArrived--;
+                taskEXIT_CRITICAL();
+                return pdFAIL;
+            }
+
+            vTaskPlaceOnEventList(&(pxBarrier->xTasksWaiting), xTicksToWait);
+            taskYIELD();
+        }
+        taskEXIT_CRITICAL();
+    }
+}
+/******************************************************************************/
+
+#endif
@@ -0,0 +1,223 @@
+#include "futex.h"
+#include "task.h"
+#include "portmacro.h"
+#include "rtos_config.h"
+#include "projectdefs.h"
+#include "list.h"
+
+#if (configUSE_FUTEX == 1)
+
+/******************************************************************************/
+// 等待队列哈希表, 按地址散列, 同一个桶内的任务按优先级排序
+static List_t xFutexWaitQueues[configFUTEX_HASH_SIZE];
+static BaseType_t xFutexWaitQueuesInitialised = pdFALSE;
+
+// 锁状态
+#define futexUNLOCKED ((uint32_t)0UL)
+#define futexLOCKED ((uint32_t)1UL)
+#define futexCONTENDED ((uint32_t)2UL)
+/******************************************************************************/
+
+/******************************************************************************/
+/**
+ * @brief 私有函数, 根据地址找到对应的等待队列, 需在临界段内调用
+ * @param volatile uint32_t *const pulAddress
+ * @returns List_t *
+ */
+static List_t *prvGetWaitQueue(volatile uint32_t *const pulAddress)
+{
+    const uint32_t ulAddress = (uint32_t)(portPOINTER_SIZE_TYPE)pulAddress;
+    UBaseType_t uxIndex = 0U;
+
+    if (xFutexWaitQueuesInitialised == pdFALSE)
+    {
+        for (uxIndex = 0U; uxIndex < (UBaseType_t)configFUTEX_HASH_SIZE; uxIndex++)
+        {
+            vListInitialise(&(xFutexWaitQueues[uxIndex]));
+        }
+        xFutexWaitQueuesInitialised = pdTRUE;
+    }
+
+    // 低 2 位总是 0, 混合高位后取模
+    uxIndex = (UBaseType_t)(((ulAddress >> 2) ^ (ulAddress >> 8)) & (uint32_t)(configFUTEX_HASH_SIZE - 1));
+
+    return &(xFutexWaitQueues[uxIndex]);
+}
+
+/**
+ * @brief 若 *pulAddress 仍等于 ulExpectedValue 则阻塞, 直到被 uxFutexWake() 唤醒或超时
+ *
+ * 比较和阻塞在同一个临界段内完成, 不会错过比较之后发生的唤醒
+ *
+ * @param volatile uint32_t *const pulAddress: 等待的地址
+ * @param const uint32_t ulExpectedValue: 期望值, 不相等时立即返回
+ * @param TickType_t xTicksToWait: 最长等待时间, portMAX_DELAY 表示无限期等待
+ * @returns BaseType_t: pdPASS 被唤醒, pdFAIL 值已改变或超时
+ */
+BaseType_t xFutexWait(volatile uint32_t *const pulAddress,
+                      const uint32_t ulExpectedValue,
+                      TickType_t xTicksToWait)
+{
+    TCB_t *const pxCurrentTask = (TCB_t *)xTaskGetCurrentTaskHandle();
+    BaseType_t xReturn = pdFAIL;
+
+    taskENTER_CRITICAL();
+    {
+        if ((*pulAddress != ulExpectedValue) || (xTicksToWait == (TickType_t)0))
+        {
+            taskEXIT_CRITICAL();
+            return pdFAIL;
+        }
+
+        pxCurrentTask->pulFutexAddress = pulAddress;
+        vTaskPlaceOnEventList(prvGetWaitQueue(pulAddress), xTicksToWait);
+        taskYIELD();
+    }
+    taskEXIT_CRITICAL();
+
+    // 唤醒者会清除等待地址, 仍保留说明是超时返回
+    taskENTER_CRITICAL();
+    {
+        if (pxCurrentTask->pulFutexAddress == NULL)
+        {
+            xReturn = pdPASS;
+        }
+        pxCurrentTask->pulFutexAddress = NULL;
+    }
+    taskEXIT_CRITICAL();
+
+    return xReturn;
+}
+
+/**
+ * @brief 唤醒在 pulAddress 上等待的任务, 优先级高的先唤醒
+ * @param volatile uint32_t *const pulAddress: 等待的地址
+ * @param UBaseType_t uxNumToWake: 最多唤醒的任务数, futexWAKE_ALL 表示全部唤醒
+ * @returns UBaseType_t: 实际唤醒的任务数
+ */
+UBaseType_t uxFutexWake(volatile uint32_t *const pulAddress, UBaseType_t uxNumToWake)
+{
+    List_t *pxWaitQueue = NULL;
+    ListItem_t *pxIterator = NULL;
+    ListItem_t *pxNext = NULL;
+    TCB_t *pxTCB = NULL;
+    UBaseType_t uxWoken = 0U;
+    BaseType_t xYieldRequired = pdFALSE;
+
+    taskENTER_CRITICAL();
+    {
+        pxWaitQueue = prvGetWaitQueue(pulAddress);
+
+        // 同一个桶里可能有等待其它地址的任务, 逐个比较
+        for (pxIterator = listGET_HEAD_ENTRY(pxWaitQueue);
+             (pxIterator != (ListItem_t *)listGET_END_MARKER(pxWaitQueue)) && (uxWoken < uxNumToWake);
+             pxIterator = pxNext)
+        {
+            pxNext = listGET_NEXT(pxIterator);
+            pxTCB = (TCB_t *)listGET_LIST_ITEM_OWNER(pxIterator);
+
+            if (pxTCB->pulFutexAddress == pulAddress)
+            {
+                pxTCB->pulFutexAddress = NULL;
+
+                if (xTaskRemoveFromEventListItem(pxIterator) != pdFALSE)
+                {
+                    xYieldRequired = pdTRUE;
+                }
+                uxWoken++;
+            }
+        }
+
+        if (xYieldRequired != pdFALSE)
+        {
+            taskYIELD();
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    return uxWoken;
+}
+/******************************************************************************/
+
+/******************************************************************************/
+/**
+ * @brief 加锁, 只有锁已被占用时才进入内核阻塞
+ * @param FutexLock_t *const pxLock
+ * @param TickType_t xTicksToWait: 最长等待时间, 0 表示不等待, portMAX_DELAY 表示无限期等待
+ * @returns BaseType_t: pdPASS 加锁成功, pdFAIL 超时
+ */
+BaseType_t xFutexLock(FutexLock_t *const pxLock, TickType_t xTicksToWait)
+{
+    uint32_t ulState = 0UL;
+    TimeOut_t xTimeOut;
+
+    // 快速路径: 0 -> 1
+    if (xPortCompareAndSwap(&(pxLock->ulState), futexLOCKED, futexUNLOCKED) != pdFALSE)
+    {
+        return pdPASS;
+    }
+
+    if (xTicksToWait == (TickType_t)0)
+    {
+        return pdFAIL;
+    }
+
+    vTaskSetTimeOutState(&xTimeOut);
+
+    for (;;)
+    {
+        ulState = pxLock->ulState;
+
+        // 锁已被释放, 以"可能有等待者"的状态获取, 保证解锁时不会漏掉其他等待者
+        if (ulState == futexUNLOCKED)
+        {
+            if (xPortCompareAndSwap(&(pxLock->ulState), futexCONTENDED, futexUNLOCKED) != pdFALSE)
+            {
+                return pdPASS;
+            }
+            continue;
+        }
+
+        // 标记为有等待者, 解锁者据此进入内核唤醒
+        if ((ulState == futexLOCKED) &&
+            (xPortCompareAndSwap(&(pxLock->ulState), futexCONTENDED, futexLOCKED) == pdFALSE))
+        {
+            continue;
+        }
+
+        (void)xFutexWait(&(pxLock->ulState), futexCONTENDED, xTicksToWait);
+
+        taskENTER_CRITICAL();
+        {
+            if (xTaskCheckForTimeOut(&xTimeOut, &xTicksToWait) != pdFALSE)
+            {
+                taskEXIT_CRITICAL();
+                return pdFAIL;
+            }
+        }
+        taskEXIT_CRITICAL();
+    }
+}
+
+/**
+ * @brief 解锁, 只有可能有等待者时才进入内核唤醒一个任务
+ * @param FutexLock_t *const pxLock
+ */
+void vFutexUnlock(FutexLock_t *const pxLock)
+{
+    uint32_t ulState = 0UL;
+
+    do
+    {
+        ulState = pxLock->ulState;
+        configASSERT(ulState != futexUNLOCKED);
+    } while (xPortCompareAndSwap(&(pxLock->ulState), futexUNLOCKED, ulState) == pdFALSE);
+
+    if (ulState == futexCONTENDED)
+    {
+        (void)uxFutexWake(&(pxLock->ulState), 1U);
+    }
+}
+/******************************************************************************/
+
+#endif
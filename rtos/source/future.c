@@ -0,0 +1,269 @@
+#include "future.h"
+#include "task.h"
+#include "portmacro.h"
+#include "rtos_config.h"
+#include "projectdefs.h"
+
+#if (configUSE_FUTURES == 1)
+
+/******************************************************************************/
+/**
+ * @brief 初始化 future 池
+ * @param FuturePool_t *const pxPool
+ * @param Future_t *const pxFutures: future 数组
+ * @param const UBaseType_t uxCount: 数组长度
+ */
+void vFuturePoolInit(FuturePool_t *const pxPool,
+                     Future_t *const pxFutures,
+                     const UBaseType_t uxCount)
+{
+    UBaseType_t x = 0U;
+
+    pxPool->pxFreeList = NULL;
+    pxPool->uxFree = uxCount;
+
+    // 倒序串成空闲链表, 分配时从数组开头取
+    for (x = uxCount; x > (UBaseType_t)0U; x--)
+    {
+        pxFutures[x - 1U].ucState = futureSTATE_FREE;
+        pxFutures[x - 1U].ulResult = 0UL;
+        pxFutures[x - 1U].xWaiter = NULL;
+        pxFutures[x - 1U].pxNextFree = pxPool->pxFreeList;
+        pxPool->pxFreeList = &(pxFutures[x - 1U]);
+    }
+}
+
+/**
+ * @brief 从池中分配一个 future, 可在中断中调用
+ * @param FuturePool_t *const pxPool
+ * @returns Future_t *: 处于等待完成状态的 future, 池已空时返回 NULL
+ */
+Future_t *pxFutureAlloc(FuturePool_t *const pxPool)
+{
+    Future_t *pxFuture = NULL;
+    uint32_t ulSavedInterruptStatus = 0;
+
+    ulSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+    {
+        pxFuture = pxPool->pxFreeList;
+
+        if (pxFuture != NULL)
+        {
+            pxPool->pxFreeList = pxFuture->pxNextFree;
+            pxPool->uxFree--;
+
+            pxFuture->pxNextFree = NULL;
+            pxFuture->ulResult = 0UL;
+            pxFuture->xWaiter = NULL;
+            pxFuture->ucState = futureSTATE_PENDING;
+        }
+    }
+    taskEXIT_CRITICAL_FROM_ISR(ulSavedInterruptStatus);
+
+    return pxFuture;
+}
+
+/**
+ * @brief 将 future 归还到池中, 可在中断中调用; 仍可能被完成方访问的 future 不能归还
+ * @param FuturePool_t *const pxPool
+ * @param Future_t *const pxFuture
+ */
+void vFutureFree(FuturePool_t *const pxPool, Future_t *const pxFuture)
+{
+    uint32_t ulSavedInterruptStatus = 0;
+
+    ulSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+    {
+        configASSERT(pxFuture->ucState != futureSTATE_FREE);
+
+        pxFuture->ucState = futureSTATE_FREE;
+        pxFuture->xWaiter = NULL;
+        pxFuture->pxNextFree = pxPool->pxFreeList;
+        pxPool->pxFreeList = pxFuture;
+        pxPool->uxFree++;
+    }
+    taskEXIT_CRITICAL_FROM_ISR(ulSavedInterruptStatus);
+}
+/******************************************************************************/
+
+/******************************************************************************/
+/**
+ * @brief 私有函数, 填入结果并取出等待者, 需在临界段内调用
+ * @param Future_t *const pxFuture
+ * @param const uint32_t ulResult
+ * @returns TaskHandle_t: 需要通知的等待者, 没有等待者时为 NULL
+ */
+static TaskHandle_t prvComplete(Future_t *const pxFuture, const uint32_t ulResult)
+{
+    TaskHandle_t xWaiter = NULL;
+
+    configASSERT(pxFuture->ucState == futureSTATE_PENDING);
+
+    pxFuture->ulResult = ulResult;
+    pxFuture->ucState = futureSTATE_DONE;
+
+    xWaiter = pxFuture->xWaiter;
+    pxFuture->xWaiter = NULL;
+
+    return xWaiter;
+}
+
+/**
+ * @brief 在任务中完成 future, 唤醒等待者
+ * @param Future_t *const pxFuture
+ * @param const uint32_t ulResult: 结果
+ */
+void vFutureComplete(Future_t *const pxFuture, const uint32_t ulResult)
+{
+    TaskHandle_t xWaiter = NULL;
+
+    taskENTER_CRITICAL();
+    {
+        xWaiter = prvComplete(pxFuture, ulResult);
+
+        if (xWaiter != NULL)
+        {
+            (void)xTaskNotifyGive(xWaiter);
+        }
+    }
+    taskEXIT_CRITICAL();
+}
+
+/**
+ * @brief 在中断中完成 future, 唤醒等待者
+ * @param Future_t *const pxFuture
+ * @param const uint32_t ulResult: 结果
+ * @param BaseType_t *const pxHigherPriorityTaskWoken: 唤醒了更高优先级任务时置为 pdTRUE, 中断退出前应调用 portYIELD()
+ */
+void vFutureCompleteFromISR(Future_t *const pxFuture,
+                            const uint32_t ulResult,
+                            BaseType_t *const pxHigherPriorityTaskWoken)
+{
+    TaskHandle_t xWaiter = NULL;
+    uint32_t ulSavedInterruptStatus = 0;
+
+    ulSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+    {
+        xWaiter = prvComplete(pxFuture, ulResult);
+
+        if (xWaiter != NULL)
+        {
+            vTaskNotifyGiveFromISR(xWaiter, pxHigherPriorityTaskWoken);
+        }
+    }
+    taskEXIT_CRITICAL_FROM_ISR(ulSavedInterruptStatus);
+}
+
+/**
+ * @brief 轮询 future 是否已完成
+ * @param const Future_t *const pxFuture
+ * @returns BaseType_t: pdTRUE 已完成
+ */
+BaseType_t xFutureIsDone(const Future_t *const pxFuture)
+{
+    return (pxFuture->ucState == futureSTATE_DONE) ? pdTRUE : pdFALSE;
+}
+
+/**
+ * @brief 等待 future 完成
+ * @param Future_t *const pxFuture
+ * @param uint32_t *const pulResult: 结果拷贝到的地址, 可以为 NULL
+ * @param TickType_t xTicksToWait: 最长等待时间, 0 表示不等待, portMAX_DELAY 表示无限期等待
+ * @returns BaseType_t: pdPASS 已完成, pdFAIL 超时
+ */
+BaseType_t xFutureAwait(Future_t *const pxFuture,
+                        uint32_t *const pulResult,
+                        TickType_t xTicksToWait)
+{
+    Future_t *const pxFutures[1] = {pxFuture};
+
+    if (pxFutureAwaitAny(pxFutures, (UBaseType_t)1U, xTicksToWait) == NULL)
+    {
+        return pdFAIL;
+    }
+
+    if (pulResult != NULL)
+    {
+        *pulResult = pxFuture->ulResult;
+    }
+
+    return pdPASS;
+}
+
+/**
+ * @brief 等待多个 future 中的任意一个完成
+ *
+ * 当前任务登记为所有未完成 future 的等待者后通过任务通知阻塞, 返回前撤销登记.
+ * 任务通知计数值与其他使用任务通知的接口共用, 被其他通知唤醒时重新检查并继续等待
+ *
+ * @param Future_t *const *const ppxFutures: future 指针数组
+ * @param const UBaseType_t uxCount: 数组长度
+ * @param TickType_t xTicksToWait: 最长等待时间, 0 表示不等待, portMAX_DELAY 表示无限期等待
+ * @returns Future_t *: 第一个(数组下标最小的)已完成的 future, 超时返回 NULL
+ */
+Future_t *pxFutureAwaitAny(Future_t *const *const ppxFutures,
+                           const UBaseType_t uxCount,
+                           TickType_t xTicksToWait)
+{
+    const TaskHandle_t xCurrentTask = xTaskGetCurrentTaskHandle();
+    Future_t *pxDone = NULL;
+    BaseType_t xEntryTimeSet = pdFALSE;
+    TimeOut_t xTimeOut;
+    UBaseType_t x = 0U;
+
+    for (;;)
+    {
+        taskENTER_CRITICAL();
+        {
+            for (x = 0U; x < uxCount; x++)
+            {
+                if (ppxFutures[x]->ucState == futureSTATE_DONE)
+                {
+                    pxDone = ppxFutures[x];
+                    break;
+                }
+            }
+
+            if (xEntryTimeSet == pdFALSE)
+            {
+                vTaskSetTimeOutState(&xTimeOut);
+                xEntryTimeSet = pdTRUE;
+            }
+            else if ((pxDone == NULL) &&
+                     (xTaskCheckForTimeOut(&xTimeOut, &xTicksToWait) != pdFALSE))
+            {
+                xTicksToWait = (TickType_t)0;
+            }
+
+            // 已完成或不再等待, 撤销登记
+            if ((pxDone != NULL) || (xTicksToWait == (TickType_t)0))
+            {
+                for (x = 0U; x < uxCount; x++)
+                {
+                    if (ppxFutures[x]->xWaiter == xCurrentTask)
+                    {
+                        ppxFutures[x]->xWaiter = NULL;
+                    }
+                }
+
+                taskEXIT_CRITICAL();
+                return pxDone;
+            }
+
+            // 一个 future 只能有一个等待者
+            for (x = 0U; x < uxCount; x++)
+            {
+                configASSERT((ppxFutures[x]->xWaiter == NULL) ||
+                             (ppxFutures[x]->xWaiter == xCurrentTask));
+                ppxFutures[x]->xWaiter = xCurrentTask;
+            }
+        }
+        taskEXIT_CRITICAL();
+
+        // 登记之后完成的 future 会递增通知计数值, 不会丢失唤醒
+        (void)ulTaskNotifyTake(pdTRUE, xTicksToWait);
+    }
+}
+/******************************************************************************/
+
+#endif
@@ -0,0 +1,130 @@
+#ifndef _ACTIVE_OBJECT_H_
+#define _ACTIVE_OBJECT_H_
+
+#include "portmacro.h"
+#include "rtos_config.h"
+#include "task.h"
+#include "queue.h"
+
+#if (configUSE_ACTIVE_OBJECTS == 1)
+
+/******************************************************************************/
+// 事件信号
+typedef uint16_t EventSignal_t;
+
+// 框架保留的信号, 活动对象启动时分发给它的第一个事件
+#define aoINIT_SIG ((EventSignal_t)0U)
+// 用户信号从这里开始
+#define aoUSER_SIG ((EventSignal_t)1U)
+
+// 事件基类, 用户事件将其作为第一个成员来"继承"
+// 事件以指针形式在队列中传递, 发布给多个订阅者时不拷贝事件本身
+typedef struct xEVENT Event_t;
+struct xEVENT
+{
+    // 事件信号
+    EventSignal_t xSignal;
+    // 所属事件池编号, 从 1 开始, 为 0 表示静态事件, 永不回收
+    uint8_t ucPoolId;
+    // 引用计数, 每投递到一个事件队列加 1, 分发完成后减 1, 减到 0 时归还事件池
+    volatile uint8_t ucRefCount;
+};
+
+// 事件池, 固定大小的内存块, 空闲块串成单向链表
+typedef struct xEVENT_POOL EventPool_t;
+struct xEVENT_POOL
+{
+    // 空闲块链表
+    void *pvFreeList;
+    // 每块的大小, 单位为字节
+    UBaseType_t uxBlockSize;
+    // 剩余空闲块数
+    UBaseType_t uxFreeBlocks;
+    // 历史最少空闲块数, 用于评估事件池大小是否合适
+    UBaseType_t uxMinFreeBlocks;
+};
+
+// 活动对象
+typedef struct xACTIVE_OBJECT ActiveObject_t;
+
+// 事件分发函数, 即活动对象的状态机, 必须运行至完成, 不能阻塞
+typedef void (*ActiveObjectDispatch_t)(ActiveObject_t *const pxAO, const Event_t *const pxEvent);
+
+struct xACTIVE_OBJECT
+{
+    // 事件分发函数
+    ActiveObjectDispatch_t pxDispatch;
+    // 事件队列, 消息为 Event_t 指针
+    QueueHandle_t xQueue;
+    Queue_t xQueueBuffer;
+    // 执行事件循环的任务
+    TaskHandle_t xTask;
+    TCB_t xTCB;
+    // 在活动对象表中的编号, 用于订阅表的位图
+    UBaseType_t uxId;
+};
+
+// 时间事件, 由 tick 驱动, 到期后投递给所属的活动对象
+typedef struct xTIME_EVENT TimeEvent_t;
+struct xTIME_EVENT
+{
+    // 时间事件本身就是一个静态事件
+    Event_t xSuper;
+    // 到期后投递给的活动对象
+    ActiveObject_t *pxAO;
+    // 距离到期还剩的 tick 数, 为 0 表示未启动
+    volatile TickType_t xCtr;
+    // 周期, 为 0 表示单次
+    TickType_t xInterval;
+    // 已启动的时间事件链表
+    TimeEvent_t *pxNext;
+    // 是否在已启动链表中
+    BaseType_t xLinked;
+};
+/******************************************************************************/
+
+/******************************************************************************/
+void vActiveObjectPoolInit(EventPool_t *const pxPool,
+                           void *const pvPoolStorage,
+                           const UBaseType_t uxPoolSize,
+                           const UBaseType_t uxBlockSize);
+
+Event_t *pxActiveObjectNewEvent(const UBaseType_t uxEventSize, const EventSignal_t xSignal);
+void vActiveObjectGarbageCollect(const Event_t *const pxEvent);
+
+void vActiveObjectStart(ActiveObject_t *const pxAO,
+                        ActiveObjectDispatch_t pxDispatch,
+                        const char *const pcName,
+                        UBaseType_t uxPriority,
+                        const Event_t **ppxQueueStorage,
+                        const UBaseType_t uxQueueLength,
+                        StackType_t *const puxStackBuffer,
+                        const uint32_t ulStackDepth);
+
+BaseType_t xActiveObjectPost(ActiveObject_t *const pxAO, const Event_t *const pxEvent);
+BaseType_t xActiveObjectPostFromISR(ActiveObject_t *const pxAO,
+                                    const Event_t *const pxEvent,
+                                    BaseType_t *const pxHigherPriorityTaskWoken);
+
+void vActiveObjectSubscribe(const ActiveObject_t *const pxAO, const EventSignal_t xSignal);
+void vActiveObjectUnsubscribe(const ActiveObject_t *const pxAO, const EventSignal_t xSignal);
+void vActiveObjectPublish(const Event_t *const pxEvent);
+
+void vTimeEventInit(TimeEvent_t *const pxTimeEvent,
+                    ActiveObject_t *const pxAO,
+                    const EventSignal_t xSignal);
+void vTimeEventArm(TimeEvent_t *const pxTimeEvent,
+                   const TickType_t xTicks,
+                   const TickType_t xInterval);
+BaseType_t xTimeEventDisarm(TimeEvent_t *const pxTimeEvent);
+
+void vActiveObjectTickFromISR(void);
+#if (configUSE_VIRTUAL_TIME == 1)
+TickType_t xActiveObjectTicksToNextEvent(void);
+void vActiveObjectStepTick(const TickType_t xTicksToJump);
+#endif
+/******************************************************************************/
+
+#endif
+
+#endif // _ACTIVE_OBJECT_H_
@@ -0,0 +1,53 @@
+#ifndef _CONDVAR_H_
+#define _CONDVAR_H_
+
+#include "portmacro.h"
+#include "rtos_config.h"
+#include "list.h"
+#include "task.h"
+#include "semphr.h"
+
+#if (configUSE_CONDITION_VARIABLES == 1)
+
+/******************************************************************************/
+// 条件变量, 与互斥量配合使用, 等待者按优先级排序
+typedef struct xCOND_VAR CondVar_t;
+struct xCOND_VAR
+{
+    // 等待的任务, 按优先级排序
+    List_t xTasksWaiting;
+};
+
+void vCondVarInit(CondVar_t *const pxCond);
+BaseType_t xCondVarWait(CondVar_t *const pxCond,
+                        SemaphoreHandle_t xMutex,
+                        TickType_t xTicksToWait);
+BaseType_t xCondVarSignal(CondVar_t *const pxCond);
+UBaseType_t uxCondVarBroadcast(CondVar_t *const pxCond);
+/******************************************************************************/
+
+/******************************************************************************/
+// 可重复使用的 N 方屏障, 最后一个到达的任务唤醒其余所有任务, 屏障随即进入下一轮
+typedef struct xBARRIER Barrier_t;
+struct xBARRIER
+{
+    // 等待的任务, 按优先级排序
+    List_t xTasksWaiting;
+    // 每一轮需要到达的任务数
+    UBaseType_t uxParties;
+    // 本轮已到达的任务数
+    UBaseType_t uxArrived;
+    // 轮次, 每放行一轮加 1, 等待者据此判断是否已被放行
+    uint32_t ulGeneration;
+};
+
+// xBarrierWait() 对本轮最后到达的任务返回该值, 其余任务返回 pdPASS
+#define barrierSERIAL_TASK ((BaseType_t)2)
+
+void vBarrierInit(Barrier_t *const pxBarrier, const UBaseType_t uxParties);
+BaseType_t xBarrierWait(Barrier_t *const pxBarrier, TickType_t xTicksToWait);
+/******************************************************************************/
+
+#endif
+
+#endif // _CONDVAR_H_
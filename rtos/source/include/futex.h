@@ -0,0 +1,40 @@
+#ifndef _FUTEX_H_
+#define _FUTEX_H_
+
+#include "portmacro.h"
+#include "rtos_config.h"
+#include "task.h"
+
+#if (configUSE_FUTEX == 1)
+
+/******************************************************************************/
+BaseType_t xFutexWait(volatile uint32_t *const pulAddress,
+                      const uint32_t ulExpectedValue,
+                      TickType_t xTicksToWait);
+UBaseType_t uxFutexWake(volatile uint32_t *const pulAddress, UBaseType_t uxNumToWake);
+
+// 唤醒在该地址上等待的所有任务
+#define futexWAKE_ALL (~(UBaseType_t)0U)
+/******************************************************************************/
+
+/******************************************************************************/
+// 基于 futex 的轻量锁, 无竞争时加锁解锁只需一次 LDREX/STREX, 不进入内核
+// 状态: 0 未加锁, 1 已加锁且无等待者, 2 已加锁且可能有等待者
+typedef struct xFUTEX_LOCK FutexLock_t;
+struct xFUTEX_LOCK
+{
+    volatile uint32_t ulState;
+};
+
+#define futexLOCK_INIT \
+    {                  \
+        0UL            \
+    }
+
+BaseType_t xFutexLock(FutexLock_t *const pxLock, TickType_t xTicksToWait);
+void vFutexUnlock(FutexLock_t *const pxLock);
+/******************************************************************************/
+
+#endif
+
+#endif // _FUTEX_H_
@@ -0,0 +1,66 @@
+#ifndef _FUTURE_H_
+#define _FUTURE_H_
+
+#include "portmacro.h"
+#include "rtos_config.h"
+#include "task.h"
+
+#if (configUSE_FUTURES == 1)
+
+/******************************************************************************/
+// future: 请求方发出异步请求后拿到一个 future, 完成方(任务或中断)填入结果,
+// 请求方可以轮询, 限时等待, 或同时等待多个 future 中的任意一个.
+// 完成时直接用任务通知唤醒等待者, 不经过中间队列
+typedef struct xFUTURE Future_t;
+struct xFUTURE
+{
+    // 状态, 见 futureSTATE_FREE 等
+    volatile uint8_t ucState;
+    // 结果, 由完成方填入, 含义由请求双方约定, 例如错误码或传输的字节数
+    volatile uint32_t ulResult;
+    // 正在等待该 future 的任务
+    volatile TaskHandle_t xWaiter;
+    // 空闲链表
+    Future_t *pxNextFree;
+};
+
+// future 池, 固定数量, 不做动态分配
+typedef struct xFUTURE_POOL FuturePool_t;
+struct xFUTURE_POOL
+{
+    // 空闲链表
+    Future_t *pxFreeList;
+    // 剩余空闲 future 数
+    UBaseType_t uxFree;
+};
+
+// future 状态
+#define futureSTATE_FREE ((uint8_t)0U)
+#define futureSTATE_PENDING ((uint8_t)1U)
+#define futureSTATE_DONE ((uint8_t)2U)
+/******************************************************************************/
+
+/******************************************************************************/
+void vFuturePoolInit(FuturePool_t *const pxPool,
+                     Future_t *const pxFutures,
+                     const UBaseType_t uxCount);
+Future_t *pxFutureAlloc(FuturePool_t *const pxPool);
+void vFutureFree(FuturePool_t *const pxPool, Future_t *const pxFuture);
+
+void vFutureComplete(Future_t *const pxFuture, const uint32_t ulResult);
+void vFutureCompleteFromISR(Future_t *const pxFuture,
+                            const uint32_t ulResult,
+                            BaseType_t *const pxHigherPriorityTaskWoken);
+
+BaseType_t xFutureIsDone(const Future_t *const pxFuture);
+BaseType_t xFutureAwait(Future_t *const pxFuture,
+                        uint32_t *const pulResult,
+                        TickType_t xTicksToWait);
+Future_t *pxFutureAwaitAny(Future_t *const *const ppxFutures,
+                           const UBaseType_t uxCount,
+                           TickType_t xTicksToWait);
+/******************************************************************************/
+
+#endif
+
+#endif // _FUTURE_H_
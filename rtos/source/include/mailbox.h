@@ -0,0 +1,50 @@
+#ifndef _MAILBOX_H_
+#define _MAILBOX_H_
+
+#include "portmacro.h"
+#include "rtos_config.h"
+#include "list.h"
+#include "task.h"
+#include "seqlock.h"
+
+#if (configUSE_MAILBOXES == 1)
+
+/******************************************************************************/
+// 单槽邮箱, 只保存最新的值, 写入时覆盖旧值, 不会阻塞.
+// 写者在临界段内更新数据, 读者通过顺序锁无锁读取, 不屏蔽中断
+typedef struct xMAILBOX Mailbox_t;
+struct xMAILBOX
+{
+    // 顺序锁, 序号的一半即数据版本号, 每写入一次加 1, 为 0 表示从未写入, 回绕时从 1 重新开始
+    SeqLock_t xLock;
+    // 数据存储区
+    uint8_t *pucData;
+    // 数据大小, 单位为字节
+    UBaseType_t uxDataSize;
+    // 等待新版本的任务, 按优先级排序
+    List_t xTasksWaiting;
+};
+
+// 从未写入时的版本号, 读者的初始版本号设为该值即可等到第一次写入
+#define mailboxNO_VERSION ((uint32_t)0UL)
+/******************************************************************************/
+
+/******************************************************************************/
+void vMailboxInit(Mailbox_t *const pxMailbox,
+                  uint8_t *const pucStorage,
+                  const UBaseType_t uxDataSize);
+void vMailboxOverwrite(Mailbox_t *const pxMailbox, const void *const pvData);
+void vMailboxOverwriteFromISR(Mailbox_t *const pxMailbox,
+                              const void *const pvData,
+                              BaseType_t *const pxHigherPriorityTaskWoken);
+uint32_t ulMailboxGetVersion(const Mailbox_t *const pxMailbox);
+uint32_t ulMailboxPeek(const Mailbox_t *const pxMailbox, void *const pvBuffer);
+BaseType_t xMailboxReceive(Mailbox_t *const pxMailbox,
+                           void *const pvBuffer,
+                           uint32_t *const pulLastVersion,
+                           TickType_t xTicksToWait);
+/******************************************************************************/
+
+#endif
+
+#endif // _MAILBOX_H_
@@ -0,0 +1,58 @@
+#ifndef _MPMC_QUEUE_H_
+#define _MPMC_QUEUE_H_
+
+#include "portmacro.h"
+#include "rtos_config.h"
+#include "list.h"
+
+#if (configUSE_MPMC_QUEUES == 1)
+
+/******************************************************************************/
+// 有界无锁多生产者多消费者队列, 每个单元带一个序号, 生产者和消费者用 LDREX/STREX 抢占读写位置,
+// 入队出队都不进入临界段, 只有消费者需要阻塞或唤醒阻塞的消费者时才进入内核
+typedef struct xMPMC_QUEUE MPMCQueue_t;
+struct xMPMC_QUEUE
+{
+    // 单元存储区, 每个单元为 4 字节序号加上按 4 字节对齐的消息
+    uint8_t *pucCells;
+    // 每个单元的大小, 单位为字节
+    UBaseType_t uxCellSize;
+    // 每条消息的大小, 单位为字节
+    UBaseType_t uxItemSize;
+    // 容量减 1, 容量必须为 2 的幂
+    uint32_t ulMask;
+    // 下一个写入位置
+    volatile uint32_t ulEnqueuePos;
+    // 下一个读出位置
+    volatile uint32_t ulDequeuePos;
+    // 已阻塞或正准备阻塞的消费者数, 为 0 时生产者不进入内核
+    volatile uint32_t ulWaitingConsumers;
+    // 阻塞的消费者, 按优先级排序
+    List_t xConsumersWaiting;
+};
+
+// 单元大小和存储区大小, 单位为字节
+#define mpmcCELL_SIZE(uxItemSize) \
+    (sizeof(uint32_t) + ((((uxItemSize) + 3U) / 4U) * 4U))
+#define mpmcSTORAGE_SIZE(uxCapacity, uxItemSize) \
+    ((uxCapacity) * mpmcCELL_SIZE(uxItemSize))
+/******************************************************************************/
+
+/******************************************************************************/
+void vMPMCQueueInit(MPMCQueue_t *const pxQueue,
+                    uint8_t *const pucStorage,
+                    const UBaseType_t uxCapacity,
+                    const UBaseType_t uxItemSize);
+BaseType_t xMPMCQueueSend(MPMCQueue_t *const pxQueue, const void *const pvItem);
+BaseType_t xMPMCQueueSendFromISR(MPMCQueue_t *const pxQueue,
+                                 const void *const pvItem,
+                                 BaseType_t *const pxHigherPriorityTaskWoken);
+BaseType_t xMPMCQueueTryReceive(MPMCQueue_t *const pxQueue, void *const pvBuffer);
+BaseType_t xMPMCQueueReceive(MPMCQueue_t *const pxQueue,
+                             void *const pvBuffer,
+                             TickType_t xTicksToWait);
+/******************************************************************************/
+
+#endif
+
+#endif // _MPMC_QUEUE_H_
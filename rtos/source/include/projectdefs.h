@@ -10,4 +10,7 @@ typedef void (*TaskFuntion_t)(void *);
 #define pdFAIL (pdFALSE)
 #define pdPASS (pdTRUE)
 
+#define errQUEUE_EMPTY ((BaseType_t)0)
+#define errQUEUE_FULL ((BaseType_t)0)
+
 #endif // _PROJECTDEFS_H_
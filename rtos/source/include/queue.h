@@ -0,0 +1,144 @@
+#ifndef _QUEUE_H_
+#define _QUEUE_H_
+
+#include "portmacro.h"
+#include "rtos_config.h"
+#include "list.h"
+
+// 队列控制块, 静态创建时由用户提供内存
+typedef struct QueueDefinition Queue_t;
+struct QueueDefinition
+{
+    // 队列存储区起始地址
+    int8_t *pcHead;
+    // 队列存储区结束地址, 指向存储区之后的第一个字节
+    int8_t *pcTail;
+    // 下一个写入位置
+    int8_t *pcWriteTo;
+    // 上一次读出的位置
+    int8_t *pcReadFrom;
+    // 等待发送(队列满)的任务, 按优先级排序
+    List_t xTasksWaitingToSend;
+    // 等待接收(队列空)的任务, 按优先级排序
+    List_t xTasksWaitingToReceive;
+    // 当前队列中的消息数
+    volatile UBaseType_t uxMessagesWaiting;
+    // 队列长度, 即最多能容纳的消息数
+    UBaseType_t uxLength;
+    // 每条消息的大小, 单位为字节
+    UBaseType_t uxItemSize;
+    // 队列类型, 见 queueQUEUE_TYPE_BASE 等
+    uint8_t ucQueueType;
+#if (configUSE_MUTEXES == 1)
+    // 互斥量的持有者, 互斥量空闲或队列不是互斥量时为 NULL
+    void *pxMutexHolder;
+    // 优先级天花板互斥量的天花板优先级
+    UBaseType_t uxCeilingPriority;
+    // 优先级天花板互斥量被持有时挂入持有者的 xCeilingMutexesHeld, 排序值为 configMAX_PRIORITIES - 天花板优先级
+    ListItem_t xCeilingListItem;
+    // 递归互斥量被持有者重复获取的次数
+    UBaseType_t uxRecursiveCallCount;
+#endif
+#if (configUSE_QUEUE_SETS == 1)
+    // 所属的队列集, 不属于任何队列集时为 NULL
+    struct QueueDefinition *pxQueueSetContainer;
+#endif
+};
+
+typedef void *QueueHandle_t;
+// 队列集句柄, 队列集本身是存放成员句柄的队列
+typedef void *QueueSetHandle_t;
+// 队列集成员句柄, 可以是队列或信号量
+typedef void *QueueSetMemberHandle_t;
+
+// 写入位置
+#define queueSEND_TO_BACK ((BaseType_t)0)
+#define queueSEND_TO_FRONT ((BaseType_t)1)
+
+// 队列类型
+#define queueQUEUE_TYPE_BASE ((uint8_t)0U)
+#define queueQUEUE_TYPE_MUTEX ((uint8_t)1U)
+#define queueQUEUE_TYPE_CEILING_MUTEX ((uint8_t)2U)
+#define queueQUEUE_TYPE_RECURSIVE_MUTEX ((uint8_t)3U)
+
+QueueHandle_t xQueueCreateStatic(const UBaseType_t uxQueueLength,
+                                 const UBaseType_t uxItemSize,
+                                 uint8_t *pucQueueStorage,
+                                 Queue_t *pxQueueBuffer);
+
+BaseType_t xQueueGenericSend(QueueHandle_t xQueue,
+                             const void *const pvItemToQueue,
+                             TickType_t xTicksToWait,
+                             const BaseType_t xCopyPosition);
+BaseType_t xQueueGenericSendFromISR(QueueHandle_t xQueue,
+                                    const void *const pvItemToQueue,
+                                    BaseType_t *const pxHigherPriorityTaskWoken,
+                                    const BaseType_t xCopyPosition);
+BaseType_t xQueueReceive(QueueHandle_t xQueue,
+                         void *const pvBuffer,
+                         TickType_t xTicksToWait);
+BaseType_t xQueueReceiveFromISR(QueueHandle_t xQueue,
+                                void *const pvBuffer,
+                                BaseType_t *const pxHigherPriorityTaskWoken);
+UBaseType_t uxQueueMessagesWaiting(const QueueHandle_t xQueue);
+
+UBaseType_t uxQueueSendMultiple(QueueHandle_t xQueue,
+                                const void *const pvItemsToQueue,
+                                const UBaseType_t uxItemCount,
+                                TickType_t xTicksToWait);
+UBaseType_t uxQueueSendMultipleFromISR(QueueHandle_t xQueue,
+                                       const void *const pvItemsToQueue,
+                                       const UBaseType_t uxItemCount,
+                                       BaseType_t *const pxHigherPriorityTaskWoken);
+UBaseType_t uxQueueReceiveMultiple(QueueHandle_t xQueue,
+                                   void *const pvBuffer,
+                                   const UBaseType_t uxMaxItems,
+                                   TickType_t xTicksToWait);
+UBaseType_t uxQueueReceiveMultipleFromISR(QueueHandle_t xQueue,
+                                          void *const pvBuffer,
+                                          const UBaseType_t uxMaxItems,
+                                          BaseType_t *const pxHigherPriorityTaskWoken);
+
+QueueHandle_t xQueueCreateCountingSemaphoreStatic(const UBaseType_t uxMaxCount,
+                                                  const UBaseType_t uxInitialCount,
+                                                  Queue_t *pxStaticQueue);
+BaseType_t xQueueSemaphoreTake(QueueHandle_t xQueue, TickType_t xTicksToWait);
+
+#if (configUSE_MUTEXES == 1)
+QueueHandle_t xQueueCreateMutexStatic(const uint8_t ucQueueType, Queue_t *pxStaticQueue);
+QueueHandle_t xQueueCreateCeilingMutexStatic(const UBaseType_t uxCeilingPriority,
+                                             Queue_t *pxStaticQueue);
+void *xQueueGetMutexHolder(QueueHandle_t xSemaphore);
+BaseType_t xQueueTakeMutexRecursive(QueueHandle_t xMutex, TickType_t xTicksToWait);
+BaseType_t xQueueGiveMutexRecursive(QueueHandle_t xMutex);
+#endif
+
+#if (configUSE_QUEUE_SETS == 1)
+// 队列集存储区大小, uxEventQueueLength 不小于所有成员的长度之和
+#define queueSET_STORAGE_SIZE(uxEventQueueLength) \
+    ((uxEventQueueLength) * sizeof(Queue_t *))
+
+QueueSetHandle_t xQueueCreateSetStatic(const UBaseType_t uxEventQueueLength,
+                                       uint8_t *pucQueueSetStorage,
+                                       Queue_t *pxQueueSetBuffer);
+BaseType_t xQueueAddToSet(QueueSetMemberHandle_t xQueueOrSemaphore,
+                          QueueSetHandle_t xQueueSet);
+BaseType_t xQueueRemoveFromSet(QueueSetMemberHandle_t xQueueOrSemaphore,
+                               QueueSetHandle_t xQueueSet);
+QueueSetMemberHandle_t xQueueSelectFromSet(QueueSetHandle_t xQueueSet,
+                                           TickType_t const xTicksToWait);
+QueueSetMemberHandle_t xQueueSelectFromSetFromISR(QueueSetHandle_t xQueueSet);
+#endif
+
+#define xQueueSend(xQueue, pvItemToQueue, xTicksToWait) \
+    xQueueGenericSend((xQueue), (pvItemToQueue), (xTicksToWait), queueSEND_TO_BACK)
+#define xQueueSendToBack(xQueue, pvItemToQueue, xTicksToWait) \
+    xQueueGenericSend((xQueue), (pvItemToQueue), (xTicksToWait), queueSEND_TO_BACK)
+#define xQueueSendToFront(xQueue, pvItemToQueue, xTicksToWait) \
+    xQueueGenericSend((xQueue), (pvItemToQueue), (xTicksToWait), queueSEND_TO_FRONT)
+#define xQueueSendFromISR(xQueue, pvItemToQueue, pxHigherPriorityTaskWoken) \
+    xQueueGenericSendFromISR((xQueue), (pvItemToQueue), (pxHigherPriorityTaskWoken), queueSEND_TO_BACK)
+#define xQueueSendToFrontFromISR(xQueue, pvItemToQueue, pxHigherPriorityTaskWoken) \
+    xQueueGenericSendFromISR((xQueue), (pvItemToQueue), (pxHigherPriorityTaskWoken), queueSEND_TO_FRONT)
+
+#endif // _QUEUE_H_
@@ -13,6 +13,8 @@ struct taskTaskControlBlock
     volatile StackType_t *pxTopOfStack;
     // 任务节点
     ListItem_t xStateListItem;
+    // 事件节点, 任务阻塞在队列等内核对象上时挂入对象的等待列表, 按优先级排序
+    ListItem_t xEventListItem;
     // 任务栈起始地址
     StackType_t *pxStack;
     // 任务名称, 字符串
@@ -21,6 +23,49 @@ struct taskTaskControlBlock
     TickType_t xTicksToDelay;
     // 优先级, 数字越大优先级越高
     UBaseType_t uxPriority;
+#if (configUSE_TASK_NOTIFICATIONS == 1)
+    // 任务通知计数值
+    volatile uint32_t ulNotifiedValue;
+    // 任务通知状态, 见 task.c 中的 taskNOT_WAITING_NOTIFICATION 等
+    volatile uint8_t ucNotifyState;
+#endif
+#if (configUSE_MUTEXES == 1)
+    // 基础优先级, 优先级继承结束后恢复到该优先级
+    UBaseType_t uxBasePriority;
+    // 当前持有的互斥量数量, 包括优先级天花板互斥量, 全部释放后才恢复基础优先级
+    UBaseType_t uxMutexesHeld;
+    // 持有互斥量期间通过优先级继承得到的最高优先级, 全部释放后清零
+    UBaseType_t uxInheritedPriority;
+    // 持有的优先级天花板互斥量, 按天花板优先级从高到低排序
+    List_t xCeilingMutexesHeld;
+#endif
+#if (configUSE_FUTEX == 1)
+    // 阻塞在 futex 上时等待的地址, 被唤醒时清零
+    volatile uint32_t *pulFutexAddress;
+#endif
+#if (configUSE_BASIC_TASKS == 1)
+    // 任务类型, tskEXTENDED_TASK: 独占任务栈, tskBASIC_TASK: 运行至完成, 共享任务栈
+    UBaseType_t uxTaskType;
+    // 基本任务是否已经在共享栈上建立了栈帧(即已开始运行, 尚未结束)
+    BaseType_t xBasicStarted;
+    // 基本任务入口和形参, 每次激活后在共享栈上重新构建栈帧
+    TaskFuntion_t pxTaskCode;
+    void *pvParameters;
+    // 被本任务抢占的基本任务, 共享栈上的嵌套链
+    struct taskTaskControlBlock *pxPreemptedBasicTask;
+#endif
+#if (configGENERATE_RUN_TIME_STATS == 1)
+    // 累计运行时间, 单位为周期计数器的计数
+    configRUN_TIME_COUNTER_TYPE ulRunTimeCounter;
+    // 所有任务按创建顺序串成的链表, 用于输出统计
+    struct taskTaskControlBlock *pxNextCreatedTask;
+#endif
+#if (configUSE_TRACE_FACILITY == 1)
+    // 跟踪编号, 任务创建时分配, 见 trace.h
+    uint8_t ucTraceId;
+#endif
 };
 
+#include "trace.h"
+
 #endif // _RTOS_H_
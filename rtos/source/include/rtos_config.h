@@ -5,8 +5,10 @@
 
 // #define DEBUG___
 
-// 配置成与硬件的系统时钟一样
+// 配置成与硬件的系统时钟一样, 其他板子(如 QEMU)可在编译选项中覆盖
+#ifndef configCPU_CLOCK_HZ
 #define configCPU_CLOCK_HZ ((unsigned long)72000000)
+#endif
 // SysTick 每秒中断多少次, 目前配置为 100, 即每 10ms 中断一次
 #define configTICK_RATE_HZ ((TickType_t)100)
 
@@ -27,6 +29,144 @@
 
 #define configUSE_PORT_OPTIMISED_TASK_SELECTION 1
 
+// 任务通知和互斥量默认打开, 其余可选功能默认关闭, 在编译选项中定义为 1 打开, 例如 -DconfigUSE_TOPICS=1
+
+// 基本任务(basic task): 运行至完成, 不能阻塞, 所有基本任务共享同一个任务栈
+#ifndef configUSE_BASIC_TASKS
+#define configUSE_BASIC_TASKS 0
+#endif
+// 基本任务共享栈大小, 单位为字, 需容纳同时嵌套的所有基本任务的栈帧
+#define configBASIC_TASK_STACK_SIZE ((unsigned short)256)
+
+// 任务通知: 每个任务自带一个计数值, 可代替二值/计数信号量直接唤醒任务
+#ifndef configUSE_TASK_NOTIFICATIONS
+#define configUSE_TASK_NOTIFICATIONS 1
+#endif
+
+// 活动对象(active object)框架: 每个活动对象拥有一个事件队列和一个事件分发函数
+#ifndef configUSE_ACTIVE_OBJECTS
+#define configUSE_ACTIVE_OBJECTS 0
+#endif
+// 活动对象的最大数量, 即发布-订阅时的订阅者数量上限, 不超过 32
+#define configAO_MAX_ACTIVE_OBJECTS 8
+// 可发布-订阅的事件信号数量, 信号值小于该值的事件才能被发布
+#define configAO_MAX_PUB_SIGNALS 32
+// 事件池的最大数量, 事件池按块大小升序注册
+#define configAO_MAX_EVENT_POOLS 3
+
+// 互斥量, 带优先级继承
+#ifndef configUSE_MUTEXES
+#define configUSE_MUTEXES 1
+#endif
+
+// 队列集: 一个任务同时阻塞在多个队列和信号量上
+#ifndef configUSE_QUEUE_SETS
+#define configUSE_QUEUE_SETS 0
+#endif
+
+// 单槽最新值邮箱, 写入覆盖旧值, 读者按版本号跳过未变化的数据
+#ifndef configUSE_MAILBOXES
+#define configUSE_MAILBOXES 0
+#endif
+
+// 工作队列: 中断和定时器推迟的小任务由一组工作线程执行
+#ifndef configUSE_WORK_QUEUES
+#define configUSE_WORK_QUEUES 0
+#endif
+
+// future: 任务间异步请求/应答, 完成时通过任务通知唤醒等待者, 依赖 configUSE_TASK_NOTIFICATIONS
+#ifndef configUSE_FUTURES
+#define configUSE_FUTURES 0
+#endif
+
+// 条件变量与屏障, 依赖 configUSE_MUTEXES
+#ifndef configUSE_CONDITION_VARIABLES
+#define configUSE_CONDITION_VARIABLES 0
+#endif
+
+// 发布-订阅主题总线, 等待新数据的订阅者通过任务通知唤醒, 依赖 configUSE_TASK_NOTIFICATIONS
+#ifndef configUSE_TOPICS
+#define configUSE_TOPICS 0
+#endif
+
+// 读写锁, 无竞争时读者只用 LDREX/STREX 加锁解锁
+#ifndef configUSE_RWLOCKS
+#define configUSE_RWLOCKS 0
+#endif
+
+// futex: 用户态原子操作处理无竞争情况, 只在需要阻塞或唤醒时进入内核
+#ifndef configUSE_FUTEX
+#define configUSE_FUTEX 0
+#endif
+// futex 等待队列哈希表的大小, 必须为 2 的幂
+#define configFUTEX_HASH_SIZE 8
+
+// 无锁多生产者多消费者队列, 生产者可以是多个中断
+#ifndef configUSE_MPMC_QUEUES
+#define configUSE_MPMC_QUEUES 0
+#endif
+
+// 时基钩子: 每次时基中断中 xTickCount 加 1 后调用 vApplicationTickHook(), 运行在中断上下文, 只能调用 FromISR 接口
+#ifndef configUSE_TICK_HOOK
+#define configUSE_TICK_HOOK 0
+#endif
+
+// 内核跟踪: 任务切换, 就绪, 阻塞, 时基和中断事件以带时间戳的定长记录写入 RAM 环形缓冲区, 见 trace.h
+#ifndef configUSE_TRACE_FACILITY
+#define configUSE_TRACE_FACILITY 0
+#endif
+// 跟踪缓冲区的记录数, 每条记录 8 字节, 必须为 2 的幂
+#ifndef configTRACE_BUFFER_SIZE
+#define configTRACE_BUFFER_SIZE 1024
+#endif
+// 跟踪中记录名称的任务数上限(含不用的编号 0), 不超过 256
+#define configTRACE_MAX_TASKS 16
+
+// 运行时间统计: 每次任务切换时用 portGET_CYCLE_COUNT() 累计被切出任务的运行时间, 见 vTaskGetRunTimeStats()
+#ifndef configGENERATE_RUN_TIME_STATS
+#define configGENERATE_RUN_TIME_STATS 0
+#endif
+// 运行时间累计值的类型, 64 位在 72MHz 下数千年不会溢出
+#ifndef configRUN_TIME_COUNTER_TYPE
+#define configRUN_TIME_COUNTER_TYPE uint64_t
+#endif
+
+// 虚拟时间: 所有任务都阻塞时时基直接跳到下一个定时事件, 不使用真实时钟, 调度顺序完全确定, 仅 POSIX 模拟器移植支持
+#ifndef configUSE_VIRTUAL_TIME
+#define configUSE_VIRTUAL_TIME 0
+#endif
+
+/******************************************************************************/
+// 配置检查
+#if ((configUSE_FUTURES == 1) && (configUSE_TASK_NOTIFICATIONS == 0))
+#error "configUSE_FUTURES requires configUSE_TASK_NOTIFICATIONS"
+#endif
+
+#if ((configUSE_TOPICS == 1) && (configUSE_TASK_NOTIFICATIONS == 0))
+#error "configUSE_TOPICS requires configUSE_TASK_NOTIFICATIONS"
+#endif
+
+#if ((configUSE_CONDITION_VARIABLES == 1) && (configUSE_MUTEXES == 0))
+#error "configUSE_CONDITION_VARIABLES requires configUSE_MUTEXES"
+#endif
+
+#if ((configUSE_ACTIVE_OBJECTS == 1) && (configAO_MAX_ACTIVE_OBJECTS > 32))
+#error "configAO_MAX_ACTIVE_OBJECTS must not exceed 32"
+#endif
+
+#if ((configUSE_FUTEX == 1) && ((configFUTEX_HASH_SIZE & (configFUTEX_HASH_SIZE - 1)) != 0))
+#error "configFUTEX_HASH_SIZE must be a power of 2"
+#endif
+
+#if ((configUSE_TRACE_FACILITY == 1) && ((configTRACE_BUFFER_SIZE & (configTRACE_BUFFER_SIZE - 1)) != 0))
+#error "configTRACE_BUFFER_SIZE must be a power of 2"
+#endif
+
+#if ((configUSE_TRACE_FACILITY == 1) && (configTRACE_MAX_TASKS > 256))
+#error "configTRACE_MAX_TASKS must not exceed 256"
+#endif
+/******************************************************************************/
+
 #ifndef configASSERT
 #define configASSERT(x)
 #define configASSERT_DEFINED 0
@@ -0,0 +1,47 @@
+#ifndef _RWLOCK_H_
+#define _RWLOCK_H_
+
+#include "portmacro.h"
+#include "rtos_config.h"
+#include "list.h"
+#include "task.h"
+
+#if (configUSE_RWLOCKS == 1)
+
+/******************************************************************************/
+// 读写锁状态字
+// 写者持有锁
+#define rwlockWRITER ((uint32_t)0x80000000UL)
+// 有写者在等待, 新的读者不能走快速路径, 写者优先
+#define rwlockWRITER_WAITING ((uint32_t)0x40000000UL)
+// 有读者在等待
+#define rwlockREADER_WAITING ((uint32_t)0x20000000UL)
+// 持有锁的读者数
+#define rwlockREADER_MASK ((uint32_t)0x1FFFFFFFUL)
+
+// 读写锁, 读者之间并发, 写者独占, 写者优先
+typedef struct xRWLOCK RWLock_t;
+struct xRWLOCK
+{
+    // 状态字, 无竞争时读者和写者只用 LDREX/STREX 修改它, 不进入临界段
+    volatile uint32_t ulState;
+    // 持有锁的写者, 写者释放锁时直接将锁移交给等待的写者
+    volatile TaskHandle_t xWriter;
+    // 等待的读者, 按优先级排序
+    List_t xReadersWaiting;
+    // 等待的写者, 按优先级排序
+    List_t xWritersWaiting;
+};
+/******************************************************************************/
+
+/******************************************************************************/
+void vRWLockInit(RWLock_t *const pxLock);
+BaseType_t xRWLockReadLock(RWLock_t *const pxLock, TickType_t xTicksToWait);
+void vRWLockReadUnlock(RWLock_t *const pxLock);
+BaseType_t xRWLockWriteLock(RWLock_t *const pxLock, TickType_t xTicksToWait);
+void vRWLockWriteUnlock(RWLock_t *const pxLock);
+/******************************************************************************/
+
+#endif
+
+#endif // _RWLOCK_H_
@@ -0,0 +1,52 @@
+#ifndef _SEMPHR_H_
+#define _SEMPHR_H_
+
+#include "queue.h"
+
+// 信号量基于只计数(消息大小为 0)的队列实现
+typedef QueueHandle_t SemaphoreHandle_t;
+typedef Queue_t StaticSemaphore_t;
+
+// 释放信号量不阻塞
+#define semGIVE_BLOCK_TIME ((TickType_t)0U)
+
+/******************************************************************************/
+// 二值信号量, 创建后为空, 需先释放一次才能获取
+#define xSemaphoreCreateBinaryStatic(pxSemaphoreBuffer) \
+    xQueueCreateCountingSemaphoreStatic((UBaseType_t)1U, (UBaseType_t)0U, (pxSemaphoreBuffer))
+// 计数信号量
+#define xSemaphoreCreateCountingStatic(uxMaxCount, uxInitialCount, pxSemaphoreBuffer) \
+    xQueueCreateCountingSemaphoreStatic((uxMaxCount), (uxInitialCount), (pxSemaphoreBuffer))
+
+#if (configUSE_MUTEXES == 1)
+// 互斥量, 带优先级继承, 只能在任务中使用, 且必须由持有者释放
+#define xSemaphoreCreateMutexStatic(pxMutexBuffer) \
+    xQueueCreateMutexStatic(queueQUEUE_TYPE_MUTEX, (pxMutexBuffer))
+// 递归互斥量, 带优先级继承, 持有者可以重复获取, 获取几次就要释放几次
+#define xSemaphoreCreateRecursiveMutexStatic(pxMutexBuffer) \
+    xQueueCreateMutexStatic(queueQUEUE_TYPE_RECURSIVE_MUTEX, (pxMutexBuffer))
+#define xSemaphoreTakeRecursive(xMutex, xBlockTime) \
+    xQueueTakeMutexRecursive((xMutex), (xBlockTime))
+#define xSemaphoreGiveRecursive(xMutex) \
+    xQueueGiveMutexRecursive((xMutex))
+// 优先级天花板互斥量(立即天花板协议): 获得时持有者立即提升到天花板优先级, 释放时降到仍持有的互斥量所需的优先级,
+// 可以与其他互斥量嵌套, 释放顺序不限.
+// 天花板优先级不低于所有会使用它的任务且持有期间不阻塞时, 获取不会遇到竞争; 否则获取者按等待时间阻塞, 不发生优先级继承
+#define xSemaphoreCreateCeilingMutexStatic(uxCeilingPriority, pxMutexBuffer) \
+    xQueueCreateCeilingMutexStatic((uxCeilingPriority), (pxMutexBuffer))
+#define xSemaphoreGetMutexHolder(xSemaphore) \
+    xQueueGetMutexHolder((xSemaphore))
+#endif
+
+#define xSemaphoreTake(xSemaphore, xBlockTime) \
+    xQueueSemaphoreTake((xSemaphore), (xBlockTime))
+#define xSemaphoreGive(xSemaphore) \
+    xQueueGenericSend((QueueHandle_t)(xSemaphore), NULL, semGIVE_BLOCK_TIME, queueSEND_TO_BACK)
+// 在中断中释放信号量, 不能用于互斥量
+#define xSemaphoreGiveFromISR(xSemaphore, pxHigherPriorityTaskWoken) \
+    xQueueGenericSendFromISR((QueueHandle_t)(xSemaphore), NULL, (pxHigherPriorityTaskWoken), queueSEND_TO_BACK)
+#define uxSemaphoreGetCount(xSemaphore) \
+    uxQueueMessagesWaiting((QueueHandle_t)(xSemaphore))
+/******************************************************************************/
+
+#endif // _SEMPHR_H_
@@ -0,0 +1,133 @@
+#ifndef _SEQLOCK_H_
+#define _SEQLOCK_H_
+
+#include "portmacro.h"
+#include "rtos_config.h"
+#include "projectdefs.h"
+
+/******************************************************************************/
+// 顺序锁(seqlock): 写者在更新数据前后各将序号加 1, 序号为奇数表示正在写.
+// 读者不加锁, 不屏蔽中断, 读之前和读之后的序号相同且为偶数时读到的数据才是完整的, 否则重试.
+// 使用限制:
+// 1. 每个顺序锁只能有一个写者, 通常是中断; 写者是任务时, 写的过程要放在临界段内, 防止被读者抢占
+// 2. 读者不能抢占写者(例如优先级更高的中断读, 优先级更低的中断写), 否则读者会一直等待写者完成
+typedef struct xSEQLOCK SeqLock_t;
+struct xSEQLOCK
+{
+    // 序号, 奇数表示正在写
+    volatile uint32_t ulSequence;
+};
+
+#define seqlockINIT \
+    {               \
+        0UL         \
+    }
+
+/**
+ * @brief 初始化顺序锁
+ * @param SeqLock_t *const pxLock
+ */
+static portFORCE_INLINE void vSeqLockInit(SeqLock_t *const pxLock)
+{
+    pxLock->ulSequence = 0UL;
+}
+
+/**
+ * @brief 写者开始更新数据
+ * @param SeqLock_t *const pxLock
+ */
+static portFORCE_INLINE void vSeqLockWriteBegin(SeqLock_t *const pxLock)
+{
+    pxLock->ulSequence++;
+    // 序号先于数据可见
+    portMEMORY_BARRIER();
+}
+
+/**
+ * @brief 写者完成更新数据
+ * @param SeqLock_t *const pxLock
+ */
+static portFORCE_INLINE void vSeqLockWriteEnd(SeqLock_t *const pxLock)
+{
+    // 数据先于序号可见
+    portMEMORY_BARRIER();
+    pxLock->ulSequence++;
+}
+
+/**
+ * @brief 读者开始读取数据, 写者正在写时等待其完成
+ * @param const SeqLock_t *const pxLock
+ * @returns uint32_t: 开始读取时的序号, 传给 xSeqLockReadRetry()
+ */
+static portFORCE_INLINE uint32_t ulSeqLockReadBegin(const SeqLock_t *const pxLock)
+{
+    uint32_t ulSequence = 0UL;
+
+    do
+    {
+        ulSequence = pxLock->ulSequence;
+    } while ((ulSequence & 1UL) != 0UL);
+
+    portMEMORY_BARRIER();
+
+    return ulSequence;
+}
+
+/**
+ * @brief 读者读取完成后检查读取期间数据是否被改写
+ * @param const SeqLock_t *const pxLock
+ * @param const uint32_t ulSequence: ulSeqLockReadBegin() 的返回值
+ * @returns BaseType_t: pdTRUE 数据被改写, 需重新读取; pdFALSE 读到的数据完整
+ */
+static portFORCE_INLINE BaseType_t xSeqLockReadRetry(const SeqLock_t *const pxLock,
+                                                     const uint32_t ulSequence)
+{
+    portMEMORY_BARRIER();
+
+    return (pxLock->ulSequence != ulSequence) ? pdTRUE : pdFALSE;
+}
+/******************************************************************************/
+
+/******************************************************************************/
+/**
+ * 定义受顺序锁保护的快照类型及其读写函数, 例如:
+ *     seqlockDEFINE_SNAPSHOT(ImuSnapshot, ImuSample_t)
+ * 展开为类型 ImuSnapshot_t 和函数:
+ *     void vImuSnapshotInit(ImuSnapshot_t *pxSnapshot);
+ *     void vImuSnapshotWrite(ImuSnapshot_t *pxSnapshot, const ImuSample_t *pxValue);
+ *     void vImuSnapshotRead(const ImuSnapshot_t *pxSnapshot, ImuSample_t *pxValue);
+ */
+#define seqlockDEFINE_SNAPSHOT(Name, Type)                                                   \
+    typedef struct                                                                           \
+    {                                                                                        \
+        SeqLock_t xLock;                                                                     \
+        Type xValue;                                                                         \
+    } Name##_t;                                                                              \
+                                                                                             \
+    static portFORCE_INLINE void v##Name##Init(Name##_t *const pxSnapshot)                   \
+    {                                                                                        \
+        vSeqLockInit(&(pxSnapshot->xLock));                                                  \
+    }                                                                                        \
+                                                                                             \
+    static portFORCE_INLINE void v##Name##Write(Name##_t *const pxSnapshot,                  \
+                                                const Type *const pxValue)                   \
+    {                                                                                        \
+        vSeqLockWriteBegin(&(pxSnapshot->xLock));                                            \
+        pxSnapshot->xValue = *pxValue;                                                       \
+        vSeqLockWriteEnd(&(pxSnapshot->xLock));                                              \
+    }                                                                                        \
+                                                                                             \
+    static portFORCE_INLINE void v##Name##Read(const Name##_t *const pxSnapshot,             \
+                                               Type *const pxValue)                          \
+    {                                                                                        \
+        uint32_t ulSequence = 0UL;                                                           \
+                                                                                             \
+        do                                                                                   \
+        {                                                                                    \
+            ulSequence = ulSeqLockReadBegin(&(pxSnapshot->xLock));                           \
+            *pxValue = pxSnapshot->xValue;                                                   \
+        } while (xSeqLockReadRetry(&(pxSnapshot->xLock), ulSequence) != pdFALSE);            \
+    }
+/******************************************************************************/
+
+#endif // _SEQLOCK_H_
@@ -21,6 +21,22 @@ TaskHandle_t xTaskCreateStatic(TaskFuntion_t pxTaskCode,
                                TCB_t *const pxTaskBuffer);
 
 #endif
+
+#if (configUSE_BASIC_TASKS == 1)
+// 任务类型
+#define tskEXTENDED_TASK ((UBaseType_t)0U)
+#define tskBASIC_TASK ((UBaseType_t)1U)
+
+TaskHandle_t xTaskCreateBasic(TaskFuntion_t pxTaskCode,
+                              const char *const pcName,
+                              void *const pvParameters,
+                              UBaseType_t uxPriority,
+                              TCB_t *const pxTaskBuffer);
+
+BaseType_t xTaskActivate(TaskHandle_t xTaskToActivate);
+BaseType_t xTaskActivateFromISR(TaskHandle_t xTaskToActivate,
+                                BaseType_t *const pxHigherPriorityTaskWoken);
+#endif
 /******************************************************************************/
 
 /******************************************************************************/
@@ -32,6 +48,66 @@ void vTaskStartScheduler(void);
 void vTaskSwitchContext(void);
 
 void vTaskDelay(const TickType_t xTicksToDelay);
+
+void xTaskIncrementTick(void);
+#if (configUSE_TICK_HOOK == 1)
+// 由应用实现
+void vApplicationTickHook(void);
+#endif
+#if (configUSE_VIRTUAL_TIME == 1)
+TickType_t xTaskGetTicksToNextEvent(void);
+void vTaskStepTick(const TickType_t xTicksToJump);
+#endif
+/******************************************************************************/
+
+/******************************************************************************/
+// 阻塞超时记录, 任务被唤醒但条件仍不满足时据此计算剩余的等待时间
+typedef struct xTIME_OUT TimeOut_t;
+struct xTIME_OUT
+{
+    // 记录时 xTickCount 的溢出次数
+    BaseType_t xOverflowCount;
+    // 记录时 xTickCount 的值
+    TickType_t xTimeOnEntering;
+};
+
+void vTaskPlaceOnEventList(List_t *const pxEventList, const TickType_t xTicksToWait);
+BaseType_t xTaskRemoveFromEventList(const List_t *const pxEventList);
+BaseType_t xTaskRemoveFromEventListItem(ListItem_t *const pxEventListItem);
+void vTaskSetTimeOutState(TimeOut_t *const pxTimeOut);
+BaseType_t xTaskCheckForTimeOut(TimeOut_t *const pxTimeOut, TickType_t *const pxTicksToWait);
+TaskHandle_t xTaskGetCurrentTaskHandle(void);
+TaskHandle_t xTaskGetIdleTaskHandle(void);
+/******************************************************************************/
+
+/******************************************************************************/
+#if (configGENERATE_RUN_TIME_STATS == 1)
+configRUN_TIME_COUNTER_TYPE ulTaskGetRunTimeCounter(TaskHandle_t xTask);
+configRUN_TIME_COUNTER_TYPE ulTaskGetIdleRunTimeCounter(void);
+configRUN_TIME_COUNTER_TYPE ulTaskGetTotalRunTime(void);
+void vTaskGetRunTimeStats(char *pcWriteBuffer, size_t xBufferLength);
+#endif
+/******************************************************************************/
+
+/******************************************************************************/
+#if (configUSE_MUTEXES == 1)
+TaskHandle_t pvTaskIncrementMutexHeldCount(void);
+BaseType_t xTaskPriorityInherit(TaskHandle_t const pxMutexHolder);
+BaseType_t xTaskPriorityDisinherit(TaskHandle_t const pxMutexHolder);
+void vTaskPriorityDisinheritAfterTimeout(TaskHandle_t const pxMutexHolder,
+                                         UBaseType_t uxHighestPriorityWaitingTask);
+void vTaskPriorityCeilingRaise(ListItem_t *const pxCeilingListItem);
+BaseType_t xTaskPriorityCeilingRestore(ListItem_t *const pxCeilingListItem);
+#endif
+/******************************************************************************/
+
+/******************************************************************************/
+#if (configUSE_TASK_NOTIFICATIONS == 1)
+BaseType_t xTaskNotifyGive(TaskHandle_t xTaskToNotify);
+void vTaskNotifyGiveFromISR(TaskHandle_t xTaskToNotify,
+                            BaseType_t *const pxHigherPriorityTaskWoken);
+uint32_t ulTaskNotifyTake(BaseType_t xClearCountOnExit, TickType_t xTicksToWait);
+#endif
 /******************************************************************************/
 
 /******************************************************************************/
@@ -102,7 +178,6 @@ extern UBaseType_t uxTopReadyPriority;
         if (uxTopReadyPriority != 0UL)                                                  \
             portGET_HIGHEST_PRIORITY(uxTopPriority, uxTopReadyPriority);                \
         listGET_OWNER_OF_NEXT_ENTRY(pxCurrentTCB, &(pxReadyTasksLists[uxTopPriority])); \
-        uxTopReadyPriority = uxTopPriority;                                             \
     } while (0);
 
 #if 0
@@ -143,6 +218,7 @@ extern UBaseType_t uxTopReadyPriority;
 #define prvAddTaskToReadyList(pxTCB)                              \
     do                                                            \
     {                                                             \
+        traceMOVED_TASK_TO_READY_STATE(pxTCB);                    \
         taskRECORD_READY_PRIORITY((pxTCB)->uxPriority);           \
         vListInsertEnd(&(pxReadyTasksLists[(pxTCB)->uxPriority]), \
                        &((pxTCB)->xStateListItem));               \
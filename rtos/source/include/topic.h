@@ -0,0 +1,72 @@
+#ifndef _TOPIC_H_
+#define _TOPIC_H_
+
+#include "portmacro.h"
+#include "rtos_config.h"
+#include "task.h"
+
+#if (configUSE_TOPICS == 1)
+
+/******************************************************************************/
+typedef struct xTOPIC_SUBSCRIBER TopicSubscriber_t;
+
+// 主题, 发布者把样本写入主题自带的环形缓冲区, 订阅者按需读取, 样本只写一次
+typedef struct xTOPIC Topic_t;
+struct xTOPIC
+{
+    // 主题名称
+    const char *pcName;
+    // 样本缓冲区, 共 uxQueueSize + 1 个槽位, 多出的一个槽位留给正在写入的样本
+    uint8_t *pucBuffer;
+    // 每个样本的大小, 单位为字节
+    UBaseType_t uxSampleSize;
+    // 订阅者能回看的历史样本数, 至少为 1
+    UBaseType_t uxQueueSize;
+    // 已发布的样本数(代数), 第 n 个样本存放在第 n % (uxQueueSize + 1) 个槽位
+    volatile uint32_t ulGeneration;
+    // 正在等待新样本的订阅者
+    TopicSubscriber_t *pxWaitingList;
+};
+
+// 订阅者
+struct xTOPIC_SUBSCRIBER
+{
+    // 订阅的主题
+    Topic_t *pxTopic;
+    // 下一个要读取的样本的代数, 等于主题的 ulGeneration 时表示没有新样本
+    uint32_t ulGeneration;
+    // 读取历史样本时因读得太慢而被覆盖的样本数
+    uint32_t ulLostSamples;
+    // 正在等待新样本的任务, 没有等待时为 NULL
+    TaskHandle_t xWaitingTask;
+    // 等待链表
+    TopicSubscriber_t *pxNextWaiting;
+};
+
+// 主题缓冲区大小, 单位为字节
+#define topicBUFFER_SIZE(uxSampleSize, uxQueueSize) \
+    (((uxQueueSize) + 1U) * (uxSampleSize))
+/******************************************************************************/
+
+/******************************************************************************/
+void vTopicInit(Topic_t *const pxTopic,
+                const char *const pcName,
+                const UBaseType_t uxSampleSize,
+                const UBaseType_t uxQueueSize,
+                uint8_t *const pucBuffer);
+
+void vTopicPublish(Topic_t *const pxTopic, const void *const pvSample);
+void vTopicPublishFromISR(Topic_t *const pxTopic,
+                          const void *const pvSample,
+                          BaseType_t *const pxHigherPriorityTaskWoken);
+
+void vTopicSubscribe(TopicSubscriber_t *const pxSubscriber, Topic_t *const pxTopic);
+BaseType_t xTopicUpdated(const TopicSubscriber_t *const pxSubscriber);
+BaseType_t xTopicCopyLatest(TopicSubscriber_t *const pxSubscriber, void *const pvBuffer);
+BaseType_t xTopicCopyNext(TopicSubscriber_t *const pxSubscriber, void *const pvBuffer);
+BaseType_t xTopicWait(TopicSubscriber_t *const pxSubscriber, TickType_t xTicksToWait);
+/******************************************************************************/
+
+#endif
+
+#endif // _TOPIC_H_
@@ -0,0 +1,200 @@
+#ifndef _TRACE_H_
+#define _TRACE_H_
+
+#include "portmacro.h"
+#include "rtos_config.h"
+#include "projectdefs.h"
+#include "rtos.h"
+
+/******************************************************************************/
+// 内核跟踪钩子. 应用可以在包含内核头文件之前自行定义任意一个 traceXXX 宏接入其他跟踪工具,
+// 未定义的钩子在 configUSE_TRACE_FACILITY 为 1 时写入内置的跟踪记录器, 否则展开为空, 不产生任何代码
+//
+// 内置记录器: 每个事件为 8 字节定长记录, 写入 RAM 中的环形缓冲区 xTraceRecorder, 缓冲区满后覆盖最旧的记录.
+// 写入位置用 xPortCompareAndSwap() 抢占, 任务和各级中断可以同时写入, 不进入临界段.
+// 时间戳取自 portGET_CYCLE_COUNT(), 32 位回绕, 主机工具按相邻记录的差值展开, 相邻两条记录间隔不能超过回绕周期的一半.
+// 取出数据: 用调试器导出 xTraceRecorder 整个结构体, 例如 gdb 中 dump binary value trace.bin xTraceRecorder,
+// 再用 tools/trace2perfetto.py 转换为 Perfetto/Chrome 跟踪格式(JSON)
+#if (configUSE_TRACE_FACILITY == 1)
+
+// 导出文件的标识 "RTRC" 和格式版本, 格式变化时主机工具据此识别
+#define traceMAGIC (0x43525452UL)
+#define traceVERSION (1UL)
+
+// 事件类型, 0 表示空记录
+#define traceEVT_TASK_CREATE ((uint8_t)1)       // 参数: 优先级
+#define traceEVT_TASK_SWITCHED_IN ((uint8_t)2)  // 参数: 优先级
+#define traceEVT_TASK_SWITCHED_OUT ((uint8_t)3) // 参数: 优先级
+#define traceEVT_TASK_READY ((uint8_t)4)        // 参数: 优先级
+#define traceEVT_TASK_DELAYED ((uint8_t)5)      // 参数: 延时时基数, 0xffff 表示无限期或超过 0xfffe
+#define traceEVT_TICK ((uint8_t)6)              // 参数: xTickCount 的低 16 位
+#define traceEVT_ISR_ENTER ((uint8_t)7)         // 参数: 异常号
+#define traceEVT_ISR_EXIT ((uint8_t)8)          // 参数: 异常号
+
+// 任务编号 0 表示中断或内核本身, 任务从 1 开始编号, 编号小于 configTRACE_MAX_TASKS 的任务记录名称
+#define traceNO_TASK ((uint8_t)0)
+
+// SysTick 的异常号, 移植层时基中断的 traceISR_ENTER()/traceISR_EXIT() 参数
+#define traceIRQ_SYSTICK (15U)
+
+// 跟踪记录, 8 字节
+typedef struct xTRACE_RECORD TraceRecord_t;
+struct xTRACE_RECORD
+{
+    // 时间戳, 周期计数器的值
+    uint32_t ulTimestamp;
+    // Bit 0-7: 事件类型, Bit 8-15: 任务编号, Bit 16-31: 事件参数, 合成一个字一次写入
+    uint32_t ulEvent;
+};
+
+// 跟踪记录器, 整个结构体即为导出格式, 头部均为 32 位字, 主机工具按小端解析
+typedef struct xTRACE_RECORDER TraceRecorder_t;
+struct xTRACE_RECORDER
+{
+    // traceMAGIC
+    uint32_t ulMagic;
+    // traceVERSION
+    uint32_t ulVersion;
+    // 记录数, configTRACE_BUFFER_SIZE
+    uint32_t ulCapacity;
+    // 名称表的行数, configTRACE_MAX_TASKS
+    uint32_t ulMaxTasks;
+    // 名称表每行的长度, configMAX_TASK_NAME_LEN
+    uint32_t ulNameLength;
+    // 时间戳的频率, portCYCLE_COUNTER_HZ
+    uint32_t ulCycleHz;
+    // 已写入的记录总数, 下一条记录写入 xRecords[ulHead % ulCapacity]
+    volatile uint32_t ulHead;
+    // 下一个分配的任务编号
+    uint32_t ulNextTaskId;
+    // 任务名称表, 按任务编号索引, 第 0 行不用
+    char pcTaskNames[configTRACE_MAX_TASKS][configMAX_TASK_NAME_LEN];
+    // 环形缓冲区
+    TraceRecord_t xRecords[configTRACE_BUFFER_SIZE];
+};
+
+extern TraceRecorder_t xTraceRecorder;
+// vTaskSwitchContext() 开始时的任务, 调用时中断已屏蔽, 不需要保护
+extern TCB_t *pxTraceSwitchedOutTCB;
+
+/**
+ * @brief 写入一条跟踪记录, 任务和中断中都可以调用
+ * @param const uint8_t ucEvent: 事件类型 traceEVT_XXX
+ * @param const uint8_t ucTask: 任务编号
+ * @param const uint32_t ulParam: 事件参数, 只保留低 16 位
+ */
+static portFORCE_INLINE void vTraceRecord(const uint8_t ucEvent, const uint8_t ucTask, const uint32_t ulParam)
+{
+    uint32_t ulHead = 0UL;
+    TraceRecord_t *pxRecord = NULL;
+
+    // 抢占写入位置, 被更高优先级的中断打断时重试
+    do
+    {
+        ulHead = xTraceRecorder.ulHead;
+    } while (xPortCompareAndSwap(&(xTraceRecorder.ulHead), ulHead + 1UL, ulHead) == pdFALSE);
+
+    pxRecord = &(xTraceRecorder.xRecords[ulHead & (uint32_t)(configTRACE_BUFFER_SIZE - 1)]);
+    pxRecord->ulTimestamp = portGET_CYCLE_COUNT();
+    pxRecord->ulEvent = (uint32_t)ucEvent | ((uint32_t)ucTask << 8UL) | (ulParam << 16UL);
+}
+
+void vTraceTaskCreate(TCB_t *const pxTCB);
+
+// 参数截断到 16 位, 超出范围的延时记为 0xffff
+#define traceCLAMP_PARAM(x) \
+    (((uint32_t)(x) > 0xffffUL) ? 0xffffUL : (uint32_t)(x))
+
+#ifndef traceTASK_CREATE
+#define traceTASK_CREATE(pxNewTCB) vTraceTaskCreate(pxNewTCB)
+#endif
+
+// 只在真正换了任务时记录切出和切入, 空闲任务反复让出给自己不会冲掉缓冲区
+#ifndef traceTASK_SWITCHED_OUT
+#define traceTASK_SWITCHED_OUT() pxTraceSwitchedOutTCB = pxCurrentTCB
+#endif
+
+#ifndef traceTASK_SWITCHED_IN
+#define traceTASK_SWITCHED_IN()                                                      \
+    do                                                                               \
+    {                                                                                \
+        if (pxCurrentTCB != pxTraceSwitchedOutTCB)                                   \
+        {                                                                            \
+            vTraceRecord(traceEVT_TASK_SWITCHED_OUT, pxTraceSwitchedOutTCB->ucTraceId, \
+                         pxTraceSwitchedOutTCB->uxPriority);                         \
+            vTraceRecord(traceEVT_TASK_SWITCHED_IN, pxCurrentTCB->ucTraceId,         \
+                         pxCurrentTCB->uxPriority);                                  \
+        }                                                                            \
+    } while (0)
+#endif
+
+#ifndef traceMOVED_TASK_TO_READY_STATE
+#define traceMOVED_TASK_TO_READY_STATE(pxTCB) \
+    vTraceRecord(traceEVT_TASK_READY, (pxTCB)->ucTraceId, (pxTCB)->uxPriority)
+#endif
+
+#ifndef traceTASK_DELAYED
+#define traceTASK_DELAYED(xTicksToWait) \
+    vTraceRecord(traceEVT_TASK_DELAYED, pxCurrentTCB->ucTraceId, traceCLAMP_PARAM(xTicksToWait))
+#endif
+
+#ifndef traceTASK_INCREMENT_TICK
+#define traceTASK_INCREMENT_TICK(xTickCount) \
+    vTraceRecord(traceEVT_TICK, traceNO_TASK, (uint32_t)(xTickCount) & 0xffffUL)
+#endif
+
+#ifndef traceISR_ENTER
+#define traceISR_ENTER(uxIrq) vTraceRecord(traceEVT_ISR_ENTER, traceNO_TASK, (uxIrq))
+#endif
+
+#ifndef traceISR_EXIT
+#define traceISR_EXIT(uxIrq) vTraceRecord(traceEVT_ISR_EXIT, traceNO_TASK, (uxIrq))
+#endif
+
+#endif // configUSE_TRACE_FACILITY
+/******************************************************************************/
+
+/******************************************************************************/
+// 未使用跟踪或应用没有定义的钩子展开为空
+
+// 任务创建完成, 在临界段中调用
+#ifndef traceTASK_CREATE
+#define traceTASK_CREATE(pxNewTCB)
+#endif
+
+// vTaskSwitchContext() 选择新任务之前, pxCurrentTCB 为被切出的任务
+#ifndef traceTASK_SWITCHED_OUT
+#define traceTASK_SWITCHED_OUT()
+#endif
+
+// vTaskSwitchContext() 选择新任务之后, pxCurrentTCB 为将要运行的任务
+#ifndef traceTASK_SWITCHED_IN
+#define traceTASK_SWITCHED_IN()
+#endif
+
+// 任务加入就绪列表
+#ifndef traceMOVED_TASK_TO_READY_STATE
+#define traceMOVED_TASK_TO_READY_STATE(pxTCB)
+#endif
+
+// 当前任务进入阻塞, xTicksToWait 为 portMAX_DELAY 时无限期等待
+#ifndef traceTASK_DELAYED
+#define traceTASK_DELAYED(xTicksToWait)
+#endif
+
+// xTickCount 加 1 之后
+#ifndef traceTASK_INCREMENT_TICK
+#define traceTASK_INCREMENT_TICK(xTickCount)
+#endif
+
+// 中断服务函数的入口和出口, 移植层的时基中断已调用, 应用的中断服务函数可自行调用
+#ifndef traceISR_ENTER
+#define traceISR_ENTER(uxIrq)
+#endif
+
+#ifndef traceISR_EXIT
+#define traceISR_EXIT(uxIrq)
+#endif
+/******************************************************************************/
+
+#endif // _TRACE_H_
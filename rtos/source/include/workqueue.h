@@ -0,0 +1,101 @@
+#ifndef _WORKQUEUE_H_
+#define _WORKQUEUE_H_
+
+#include "portmacro.h"
+#include "rtos_config.h"
+#include "list.h"
+#include "task.h"
+
+#if (configUSE_WORK_QUEUES == 1)
+
+/******************************************************************************/
+// 工作项, 由用户定义并初始化, 提交时直接链入工作队列, 不分配内存
+typedef struct xWORK Work_t;
+
+// 工作项处理函数, 在工作线程中执行, 可以阻塞
+typedef void (*WorkHandler_t)(Work_t *const pxWork);
+
+struct xWORK
+{
+    // 挂入工作队列待处理列表的节点
+    ListItem_t xListItem;
+    // 处理函数
+    WorkHandler_t pxHandler;
+    // 最近一次提交到的工作队列
+    struct xWORK_QUEUE *pxQueue;
+    // 状态, 见 workSTATE_QUEUED 等
+    volatile uint8_t ucState;
+};
+
+// 可延时工作项, 到期后由 tick 提交到工作队列
+typedef struct xDELAYABLE_WORK DelayableWork_t;
+struct xDELAYABLE_WORK
+{
+    // 工作项本身, 必须是第一个成员, 处理函数收到的指针可转换为 DelayableWork_t
+    Work_t xWork;
+    // 挂入延时工作列表的节点, 排序值为到期时刻
+    ListItem_t xTimerItem;
+};
+
+// 工作队列, 由一个或多个工作线程处理
+typedef struct xWORK_QUEUE WorkQueue_t;
+struct xWORK_QUEUE
+{
+    // 待处理的工作项, 先进先出
+    List_t xPendingWork;
+    // 空闲的工作线程, 按优先级排序
+    List_t xIdleWorkers;
+    // 等待队列排空的任务, 按优先级排序
+    List_t xFlushWaiting;
+    // 正在执行处理函数的工作线程数
+    volatile UBaseType_t uxRunning;
+};
+
+// 工作项状态
+// 在待处理列表中
+#define workSTATE_QUEUED ((uint8_t)0x01U)
+// 在延时工作列表中
+#define workSTATE_DELAYED ((uint8_t)0x02U)
+// 处理函数正在执行
+#define workSTATE_RUNNING ((uint8_t)0x04U)
+
+// 可延时工作项的处理函数中取回 DelayableWork_t
+#define workDELAYABLE_FROM_WORK(pxWork) ((DelayableWork_t *)(pxWork))
+/******************************************************************************/
+
+/******************************************************************************/
+void vWorkInit(Work_t *const pxWork, WorkHandler_t pxHandler);
+void vDelayableWorkInit(DelayableWork_t *const pxDelayableWork, WorkHandler_t pxHandler);
+void vWorkQueueInit(WorkQueue_t *const pxQueue);
+TaskHandle_t xWorkQueueStartWorker(WorkQueue_t *const pxQueue,
+                                   const char *const pcName,
+                                   const uint32_t ulStackDepth,
+                                   UBaseType_t uxPriority,
+                                   StackType_t *const puxStackBuffer,
+                                   TCB_t *const pxTaskBuffer);
+
+BaseType_t xWorkSubmit(WorkQueue_t *const pxQueue, Work_t *const pxWork);
+BaseType_t xWorkSubmitFromISR(WorkQueue_t *const pxQueue,
+                              Work_t *const pxWork,
+                              BaseType_t *const pxHigherPriorityTaskWoken);
+BaseType_t xWorkSchedule(WorkQueue_t *const pxQueue,
+                         DelayableWork_t *const pxDelayableWork,
+                         const TickType_t xDelay);
+BaseType_t xWorkScheduleFromISR(WorkQueue_t *const pxQueue,
+                                DelayableWork_t *const pxDelayableWork,
+                                const TickType_t xDelay,
+                                BaseType_t *const pxHigherPriorityTaskWoken);
+BaseType_t xWorkCancel(Work_t *const pxWork);
+BaseType_t xWorkCancelDelayable(DelayableWork_t *const pxDelayableWork);
+BaseType_t xWorkIsBusy(const Work_t *const pxWork);
+BaseType_t xWorkQueueFlush(WorkQueue_t *const pxQueue, TickType_t xTicksToWait);
+
+void vWorkQueueTickFromISR(void);
+#if (configUSE_VIRTUAL_TIME == 1)
+TickType_t xWorkQueueTicksToNextEvent(void);
+#endif
+/******************************************************************************/
+
+#endif
+
+#endif // _WORKQUEUE_H_
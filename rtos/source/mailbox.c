@@ -0,0 +1,189 @@
+#include <string.h>
+
+#include "mailbox.h"
+#include "task.h"
+#include "portmacro.h"
+#include "rtos_config.h"
+#include "projectdefs.h"
+#include "list.h"
+
+#if (configUSE_MAILBOXES == 1)
+
+/******************************************************************************/
+/**
+ * @brief 初始化邮箱
+ * @param Mailbox_t *const pxMailbox
+ * @param uint8_t *const pucStorage: 数据存储区, 大小为 uxDataSize 字节
+ * @param const UBaseType_t uxDataSize: 数据大小, 单位为字节
+ */
+void vMailboxInit(Mailbox_t *const pxMailbox,
+                  uint8_t *const pucStorage,
+                  const UBaseType_t uxDataSize)
+{
+    vSeqLockInit(&(pxMailbox->xLock));
+    pxMailbox->pucData = pucStorage;
+    pxMailbox->uxDataSize = uxDataSize;
+    vListInitialise(&(pxMailbox->xTasksWaiting));
+}
+
+/**
+ * @brief 私有函数, 写入新值并唤醒所有等待新版本的任务, 需在临界段内调用
+ * @param Mailbox_t *const pxMailbox
+ * @param const void *const pvData
+ * @returns BaseType_t: 唤醒了比当前任务优先级更高的任务时返回 pdTRUE
+ */
+static BaseType_t prvOverwrite(Mailbox_t *const pxMailbox, const void *const pvData)
+{
+    BaseType_t xYieldRequired = pdFALSE;
+
+    // 写者都在临界段内, 顺序锁不会有并发的写者
+    vSeqLockWriteBegin(&(pxMailbox->xLock));
+    // 版本号回绕时跳过 mailboxNO_VERSION, 否则读者会把新值当作从未写入. 序号仍为奇数, 读者照常等待写入完成
+    if (pxMailbox->xLock.ulSequence == 0xffffffffUL)
+    {
+        pxMailbox->xLock.ulSequence = 1UL;
+    }
+    (void)memcpy(pxMailbox->pucData, pvData, (size_t)pxMailbox->uxDataSize);
+    vSeqLockWriteEnd(&(pxMailbox->xLock));
+
+    while (listLIST_IS_EMPTY(&(pxMailbox->xTasksWaiting)) == pdFALSE)
+    {
+        if (xTaskRemoveFromEventList(&(pxMailbox->xTasksWaiting)) != pdFALSE)
+        {
+            xYieldRequired = pdTRUE;
+        }
+    }
+
+    return xYieldRequired;
+}
+
+/**
+ * @brief 在任务中写入新值, 覆盖旧值, 不会阻塞
+ * @param Mailbox_t *const pxMailbox
+ * @param const void *const pvData: 数据地址, 按值拷贝进邮箱
+ */
+void vMailboxOverwrite(Mailbox_t *const pxMailbox, const void *const pvData)
+{
+    taskENTER_CRITICAL();
+    {
+        if (prvOverwrite(pxMailbox, pvData) != pdFALSE)
+        {
+            taskYIELD();
+        }
+    }
+    taskEXIT_CRITICAL();
+}
+
+/**
+ * @brief 在中断中写入新值, 覆盖旧值, 不会阻塞
+ * @param Mailbox_t *const pxMailbox
+ * @param const void *const pvData: 数据地址, 按值拷贝进邮箱
+ * @param BaseType_t *const pxHigherPriorityTaskWoken: 唤醒了更高优先级任务时置为 pdTRUE, 中断退出前应调用 portYIELD()
+ */
+void vMailboxOverwriteFromISR(Mailbox_t *const pxMailbox,
+                              const void *const pvData,
+                              BaseType_t *const pxHigherPriorityTaskWoken)
+{
+    uint32_t ulSavedInterruptStatus = 0;
+
+    ulSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+    {
+        if ((prvOverwrite(pxMailbox, pvData) != pdFALSE) && (pxHigherPriorityTaskWoken != NULL))
+        {
+            *pxHigherPriorityTaskWoken = pdTRUE;
+        }
+    }
+    taskEXIT_CRITICAL_FROM_ISR(ulSavedInterruptStatus);
+}
+
+/**
+ * @brief 获取当前数据的版本号, 不拷贝数据, 读者据此跳过未变化的数据
+ * @param const Mailbox_t *const pxMailbox
+ * @returns uint32_t: 版本号, mailboxNO_VERSION 表示从未写入; 正在写入时返回写入前的版本号
+ */
+uint32_t ulMailboxGetVersion(const Mailbox_t *const pxMailbox)
+{
+    return pxMailbox->xLock.ulSequence >> 1;
+}
+
+/**
+ * @brief 读取当前值, 不会阻塞
+ * @param const Mailbox_t *const pxMailbox
+ * @param void *const pvBuffer: 数据拷贝到的地址
+ * @returns uint32_t: 读到的数据的版本号, mailboxNO_VERSION 表示从未写入, 此时不拷贝数据
+ */
+uint32_t ulMailboxPeek(const Mailbox_t *const pxMailbox, void *const pvBuffer)
+{
+    uint32_t ulSequence = 0UL;
+
+    do
+    {
+        ulSequence = ulSeqLockReadBegin(&(pxMailbox->xLock));
+
+        if (ulSequence == 0UL)
+        {
+            return mailboxNO_VERSION;
+        }
+
+        (void)memcpy(pvBuffer, pxMailbox->pucData, (size_t)pxMailbox->uxDataSize);
+    } while (xSeqLockReadRetry(&(pxMailbox->xLock), ulSequence) != pdFALSE);
+
+    return ulSequence >> 1;
+}
+
+/**
+ * @brief 读取比 *pulLastVersion 更新的值, 没有新版本时阻塞等待
+ * @param Mailbox_t *const pxMailbox
+ * @param void *const pvBuffer: 数据拷贝到的地址
+ * @param uint32_t *const pulLastVersion: 读者上一次读到的版本号, 读到新值后更新
+ * @param TickType_t xTicksToWait: 最长等待时间, 0 表示不等待, portMAX_DELAY 表示无限期等待
+ * @returns BaseType_t: pdPASS 读到新值, pdFAIL 超时
+ */
+BaseType_t xMailboxReceive(Mailbox_t *const pxMailbox,
+                           void *const pvBuffer,
+                           uint32_t *const pulLastVersion,
+                           TickType_t xTicksToWait)
+{
+    BaseType_t xEntryTimeSet = pdFALSE;
+    TimeOut_t xTimeOut;
+
+    for (;;)
+    {
+        // 版本号未变时不拷贝数据
+        if (ulMailboxGetVersion(pxMailbox) != *pulLastVersion)
+        {
+            *pulLastVersion = ulMailboxPeek(pxMailbox, pvBuffer);
+            return pdPASS;
+        }
+
+        if (xTicksToWait == (TickType_t)0)
+        {
+            return pdFAIL;
+        }
+
+        taskENTER_CRITICAL();
+        {
+            if (xEntryTimeSet == pdFALSE)
+            {
+                vTaskSetTimeOutState(&xTimeOut);
+                xEntryTimeSet = pdTRUE;
+            }
+            else if (xTaskCheckForTimeOut(&xTimeOut, &xTicksToWait) != pdFALSE)
+            {
+                taskEXIT_CRITICAL();
+                return pdFAIL;
+            }
+
+            // 写者都在临界段内, 此处看到的版本号是稳定的
+            if (ulMailboxGetVersion(pxMailbox) == *pulLastVersion)
+            {
+                vTaskPlaceOnEventList(&(pxMailbox->xTasksWaiting), xTicksToWait);
+                taskYIELD();
+            }
+        }
+        taskEXIT_CRITICAL();
+    }
+}
+/******************************************************************************/
+
+#endif
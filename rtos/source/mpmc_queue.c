@@ -0,0 +1,294 @@
+#include <string.h>
+
+#include "mpmc_queue.h"
+#include "task.h"
+#include "portmacro.h"
+#include "rtos_config.h"
+#include "projectdefs.h"
+#include "list.h"
+
+#if (configUSE_MPMC_QUEUES == 1)
+
+/******************************************************************************/
+// 单元的序号
+#define mpmcCELL_SEQUENCE(pxQueue, ulPos) \
+    ((volatile uint32_t *)((pxQueue)->pucCells + (((ulPos) & (pxQueue)->ulMask) * (pxQueue)->uxCellSize)))
+// 单元中的消息
+#define mpmcCELL_DATA(pulSequence) ((void *)((pulSequence) + 1))
+/******************************************************************************/
+
+/******************************************************************************/
+/**
+ * @brief 初始化队列
+ * @param MPMCQueue_t *const pxQueue: 队列
+ * @param uint8_t *const pucStorage: 存储区, 4 字节对齐, 大小为 mpmcSTORAGE_SIZE(uxCapacity, uxItemSize)
+ * @param const UBaseType_t uxCapacity: 容量, 必须为 2 的幂
+ * @param const UBaseType_t uxItemSize: 每条消息的大小, 单位为字节
+ */
+void vMPMCQueueInit(MPMCQueue_t *const pxQueue,
+                    uint8_t *const pucStorage,
+                    const UBaseType_t uxCapacity,
+                    const UBaseType_t uxItemSize)
+{
+    uint32_t ulPos = 0UL;
+
+    configASSERT((uxCapacity >= 2U) && ((uxCapacity & (uxCapacity - 1U)) == 0U));
+
+    pxQueue->pucCells = pucStorage;
+    pxQueue->uxCellSize = (UBaseType_t)mpmcCELL_SIZE(uxItemSize);
+    pxQueue->uxItemSize = uxItemSize;
+    pxQueue->ulMask = (uint32_t)uxCapacity - 1UL;
+    pxQueue->ulEnqueuePos = 0UL;
+    pxQueue->ulDequeuePos = 0UL;
+    pxQueue->ulWaitingConsumers = 0UL;
+    vListInitialise(&(pxQueue->xConsumersWaiting));
+
+    // 第 i 个单元的序号初始化为 i, 表示可以写入第 i 条消息
+    for (ulPos = 0UL; ulPos < (uint32_t)uxCapacity; ulPos++)
+    {
+        *mpmcCELL_SEQUENCE(pxQueue, ulPos) = ulPos;
+    }
+}
+
+/**
+ * @brief 私有函数, 无锁入队
+ *
+ * 单元序号等于写入位置时可写, 生产者先用 CAS 抢占写入位置, 再写消息, 最后将序号加 1 发布给消费者
+ *
+ * @param MPMCQueue_t *const pxQueue
+ * @param const void *const pvItem
+ * @returns BaseType_t: pdPASS 入队成功, errQUEUE_FULL 队列已满
+ */
+static BaseType_t prvEnqueue(MPMCQueue_t *const pxQueue, const void *const pvItem)
+{
+    volatile uint32_t *pulSequence = NULL;
+    uint32_t ulPos = pxQueue->ulEnqueuePos;
+    int32_t lDiff = 0;
+
+    for (;;)
+    {
+        pulSequence = mpmcCELL_SEQUENCE(pxQueue, ulPos);
+        lDiff = (int32_t)(*pulSequence - ulPos);
+
+        if (lDiff == 0)
+        {
+            if (xPortCompareAndSwap(&(pxQueue->ulEnqueuePos), ulPos + 1UL, ulPos) != pdFALSE)
+            {
+                break;
+            }
+        }
+        else if (lDiff < 0)
+        {
+            // 该单元上一圈的消息还没有被读走
+            return errQUEUE_FULL;
+        }
+
+        // 写入位置已被其他生产者抢走, 重新读取
+        ulPos = pxQueue->ulEnqueuePos;
+    }
+
+    (void)memcpy(mpmcCELL_DATA(pulSequence), pvItem, (size_t)pxQueue->uxItemSize);
+    portMEMORY_BARRIER();
+    *pulSequence = ulPos + 1UL;
+
+    return pdPASS;
+}
+
+/**
+ * @brief 私有函数, 检查读出位置的单元是否已发布
+ * @param const MPMCQueue_t *const pxQueue
+ * @returns BaseType_t: pdTRUE 队列为空
+ */
+static BaseType_t prvIsEmpty(const MPMCQueue_t *const pxQueue)
+{
+    const uint32_t ulPos = pxQueue->ulDequeuePos;
+
+    return ((int32_t)(*mpmcCELL_SEQUENCE(pxQueue, ulPos) - (ulPos + 1UL)) < 0) ? pdTRUE : pdFALSE;
+}
+
+/**
+ * @brief 私有函数, 入队后唤醒一个阻塞的消费者, 需在临界段内调用
+ * @param MPMCQueue_t *const pxQueue
+ * @returns BaseType_t: 唤醒了比当前任务优先级更高的任务时返回 pdTRUE
+ */
+static BaseType_t prvWakeConsumer(MPMCQueue_t *const pxQueue)
+{
+    if (listLIST_IS_EMPTY(&(pxQueue->xConsumersWaiting)) != pdFALSE)
+    {
+        return pdFALSE;
+    }
+
+    return xTaskRemoveFromEventList(&(pxQueue->xConsumersWaiting));
+}
+
+/**
+ * @brief 在任务中发送消息, 不会阻塞
+ * @param MPMCQueue_t *const pxQueue
+ * @param const void *const pvItem: 消息地址, 按值拷贝进队列
+ * @returns BaseType_t: pdPASS 发送成功, errQUEUE_FULL 队列已满
+ */
+BaseType_t xMPMCQueueSend(MPMCQueue_t *const pxQueue, const void *const pvItem)
+{
+    if (prvEnqueue(pxQueue, pvItem) != pdPASS)
+    {
+        return errQUEUE_FULL;
+    }
+
+    portMEMORY_BARRIER();
+
+    if (pxQueue->ulWaitingConsumers != 0UL)
+    {
+        taskENTER_CRITICAL();
+        {
+            if (prvWakeConsumer(pxQueue) != pdFALSE)
+            {
+                taskYIELD();
+            }
+        }
+        taskEXIT_CRITICAL();
+    }
+
+    return pdPASS;
+}
+
+/**
+ * @brief 在中断中发送消息, 多个中断可以同时向同一个队列发送
+ * @param MPMCQueue_t *const pxQueue
+ * @param const void *const pvItem: 消息地址, 按值拷贝进队列
+ * @param BaseType_t *const pxHigherPriorityTaskWoken: 唤醒了更高优先级任务时置为 pdTRUE, 中断退出前应调用 portYIELD()
+ * @returns BaseType_t: pdPASS 发送成功, errQUEUE_FULL 队列已满
+ */
+BaseType_t xMPMCQueueSendFromISR(MPMCQueue_t *const pxQueue,
+                                 const void *const pvItem,
+                                 BaseType_t *const pxHigherPriorityTaskWoken)
+{
+    uint32_t ulSavedInterruptStatus = 0;
+
+    if (prvEnqueue(pxQueue, pvItem) != pdPASS)
+    {
+        return errQUEUE_FULL;
+    }
+
+    portMEMORY_BARRIER();
+
+    // 没有消费者阻塞时不屏蔽中断
+    if (pxQueue->ulWaitingConsumers != 0UL)
+    {
+        ulSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+        {
+            if ((prvWakeConsumer(pxQueue) != pdFALSE) && (pxHigherPriorityTaskWoken != NULL))
+            {
+                *pxHigherPriorityTaskWoken = pdTRUE;
+            }
+        }
+        taskEXIT_CRITICAL_FROM_ISR(ulSavedInterruptStatus);
+    }
+
+    return pdPASS;
+}
+
+/**
+ * @brief 无锁出队, 不会阻塞, 可在中断中调用
+ *
+ * 单元序号等于读出位置加 1 时可读, 消费者先用 CAS 抢占读出位置, 再读消息,
+ * 最后将序号设为读出位置加容量, 即下一圈的写入位置, 把单元还给生产者
+ *
+ * @param MPMCQueue_t *const pxQueue
+ * @param void *const pvBuffer: 消息拷贝到的地址
+ * @returns BaseType_t: pdPASS 接收成功, errQUEUE_EMPTY 队列为空
+ */
+BaseType_t xMPMCQueueTryReceive(MPMCQueue_t *const pxQueue, void *const pvBuffer)
+{
+    volatile uint32_t *pulSequence = NULL;
+    uint32_t ulPos = pxQueue->ulDequeuePos;
+    int32_t lDiff = 0;
+
+    for (;;)
+    {
+        pulSequence = mpmcCELL_SEQUENCE(pxQueue, ulPos);
+        lDiff = (int32_t)(*pulSequence - (ulPos + 1UL));
+
+        if (lDiff == 0)
+        {
+            if (xPortCompareAndSwap(&(pxQueue->ulDequeuePos), ulPos + 1UL, ulPos) != pdFALSE)
+            {
+                break;
+            }
+        }
+        else if (lDiff < 0)
+        {
+            return errQUEUE_EMPTY;
+        }
+
+        ulPos = pxQueue->ulDequeuePos;
+    }
+
+    portMEMORY_BARRIER();
+    (void)memcpy(pvBuffer, mpmcCELL_DATA(pulSequence), (size_t)pxQueue->uxItemSize);
+    portMEMORY_BARRIER();
+    *pulSequence = ulPos + pxQueue->ulMask + 1UL;
+
+    return pdPASS;
+}
+
+/**
+ * @brief 在任务中接收消息, 队列为空时阻塞
+ * @param MPMCQueue_t *const pxQueue
+ * @param void *const pvBuffer: 消息拷贝到的地址
+ * @param TickType_t xTicksToWait: 最长等待时间, 0 表示不等待, portMAX_DELAY 表示无限期等待
+ * @returns BaseType_t: pdPASS 接收成功, errQUEUE_EMPTY 超时
+ */
+BaseType_t xMPMCQueueReceive(MPMCQueue_t *const pxQueue,
+                             void *const pvBuffer,
+                             TickType_t xTicksToWait)
+{
+    BaseType_t xEntryTimeSet = pdFALSE;
+    TimeOut_t xTimeOut;
+
+    for (;;)
+    {
+        if (xMPMCQueueTryReceive(pxQueue, pvBuffer) == pdPASS)
+        {
+            return pdPASS;
+        }
+
+        if (xTicksToWait == (TickType_t)0)
+        {
+            return errQUEUE_EMPTY;
+        }
+
+        taskENTER_CRITICAL();
+        {
+            if (xEntryTimeSet == pdFALSE)
+            {
+                vTaskSetTimeOutState(&xTimeOut);
+                xEntryTimeSet = pdTRUE;
+            }
+            else if (xTaskCheckForTimeOut(&xTimeOut, &xTicksToWait) != pdFALSE)
+            {
+                taskEXIT_CRITICAL();
+                return errQUEUE_EMPTY;
+            }
+
+            // 先登记再检查: 生产者发布消息后才读取等待数, 二者至少有一方能看到对方
+            pxQueue->ulWaitingConsumers++;
+            portMEMORY_BARRIER();
+
+            if (prvIsEmpty(pxQueue) != pdFALSE)
+            {
+                vTaskPlaceOnEventList(&(pxQueue->xConsumersWaiting), xTicksToWait);
+                taskYIELD();
+            }
+        }
+        taskEXIT_CRITICAL();
+
+        taskENTER_CRITICAL();
+        {
+            pxQueue->ulWaitingConsumers--;
+        }
+        taskEXIT_CRITICAL();
+    }
+}
+/******************************************************************************/
+
+#endif
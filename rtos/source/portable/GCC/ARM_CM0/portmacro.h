@@ -0,0 +1,205 @@
+#ifndef _PORTMACRO_H_
+#define _PORTMACRO_H_
+
+#include "stdint.h"
+#include "stddef.h"
+#include "projectdefs.h"
+#include "rtos_config.h"
+
+// "??"为带有疑问的语句
+
+// object oriented
+// #define OO(name)                  \
+//     typedef struct name name##_t; \
+//     struct name
+
+#define portCHAR char
+#define portFLOAT float
+#define portDOUBLE double
+#define portLONG long
+#define portSHORT short
+
+// 4B
+#define portSTACK_TYPE uint32_t
+typedef portSTACK_TYPE StackType_t;
+
+// 8B??
+#define portBASE_TYPE long
+typedef long BaseType_t;
+typedef unsigned long UBaseType_t;
+
+// 与指针等宽的整数类型, 用于对指针做位运算
+#define portPOINTER_SIZE_TYPE uint32_t
+
+#if (configUSE_16_BIT_TICKS == 1)
+typedef uint16_t TickType_t;
+#define portMAX_DELAY (TickType_t)0xffff
+#else
+typedef uint32_t TickType_t;
+#define portMAX_DELAY (TickType_t)0xffffffffUL
+#endif
+
+/******************************************************************************/
+
+StackType_t *pxPortInitialiseStack(StackType_t *pxTopOfStack,
+                                   TaskFuntion_t pxCode,
+                                   void *pvParameters);
+BaseType_t xPortStartScheduler(void);
+/******************************************************************************/
+
+/******************************************************************************/
+#define portNVIC_INT_CTRL_REG (*((volatile uint32_t *)0xE000ED04))
+#define portNVIC_PENDSVSET_BIT (1UL << 28UL)
+#define portSY_FULL_READ_WRITE (15)
+
+// 触发上下文切换, 将 PendSV 的悬起位置 1, 当没有其它中断运行的时候响应 PendSV 中断, 去执行写好的 PendSV断服务函数, 在里面实现任务切换
+#define portYIELD()                                     \
+    {                                                   \
+        /* 触发PendSV, 产生上下文切换 */                \
+        portNVIC_INT_CTRL_REG = portNVIC_PENDSVSET_BIT; \
+        __asm volatile("dsb" ::: "memory");             \
+        __asm volatile("isb");                          \
+    }
+
+// 编译器及处理器内存屏障, 保证屏障前后的内存访问不被重排, 用于无锁数据结构
+#define portMEMORY_BARRIER() __asm volatile("dmb" ::: "memory")
+/******************************************************************************/
+
+/******************************************************************************/
+// 周期计数器, 用于基准测试和运行时间统计, 32 位回绕, 两次读数相减即为间隔
+// Cortex-M0 没有 DWT CYCCNT, 由 SysTick 当前值和回绕次数拼出周期数
+#define configUSE_SYSTICK_CYCLE_COUNTER 1
+uint32_t ulPortGetSysTickCycleCount(void);
+#define portGET_CYCLE_COUNT() ulPortGetSysTickCycleCount()
+// 周期计数器的频率, 与 SysTick 的时钟相同
+#ifdef configSYSTICK_CLOCK_HZ
+#define portCYCLE_COUNTER_HZ (configSYSTICK_CLOCK_HZ)
+#else
+#define portCYCLE_COUNTER_HZ (configCPU_CLOCK_HZ)
+#endif
+/******************************************************************************/
+
+/******************************************************************************/
+// 临界段保护, 用于保护全局变量操作或者其他不能被打断的过程
+#ifndef portFORCE_INLINE
+#define portFORCE_INLINE inline __attribute__((always_inline))
+#endif
+
+// 仅被汇编代码引用的函数和变量, 防止被链接器优化掉
+#ifndef portDONT_DISCARD
+#define portDONT_DISCARD __attribute__((used))
+#endif
+
+// Cortex-M0 没有 BASEPRI, 临界段通过 PRIMASK 屏蔽所有可屏蔽中断
+
+// 无中断保护关中断, 开中断, 进临界段, 出临界段
+// 不带返回值的关中断函数, 不能嵌套, 不能在中断里面使用
+#define portDISABLE_INTERRUPTS() __asm volatile("cpsid i" ::: "memory")
+void vPortEnterCritical(void);
+// 不带返回值的进临界段函数, 不能嵌套, 不能在中断里面使用
+#define portENTER_CRITICAL() vPortEnterCritical()
+// 不带中断保护的开中断函数
+#define portENABLE_INTERRUPTS() __asm volatile("cpsie i" ::: "memory")
+void vPortExitCritical(void);
+// 不带中断保护的退出临界段函数
+#define portEXIT_CRITICAL() vPortExitCritical()
+
+// 有中断保护关中断, 开中断, 进临界段, 出临界段
+// 带返回值的关中断函数, 可以嵌套, 可以在中断里面使用
+#define portSET_INTERRUPT_MASK_FROM_ISR() ulPortSetPRIMASK()
+/**
+ * @brief 带返回值的关中断函数, 先保存 PRIMASK 再关中断, 返回的值作为形参传入开中断函数
+ * @returns uint32_t ulReturn: PRIMASK 的原始值
+ */
+static portFORCE_INLINE uint32_t ulPortSetPRIMASK(void)
+{
+    uint32_t ulReturn;
+
+    __asm volatile(
+        "   mrs %0, primask \n"
+        "   cpsid i         \n"
+        : "=r"(ulReturn)
+        :
+        : "memory");
+
+    return ulReturn;
+}
+// 带中断保护的开中断函数
+#define portCLEAR_INTERRUPT_MASK_FROM_ISR(x) vPortRestorePRIMASK(x)
+
+/**
+ * @brief 开中断函数, 恢复上一次关中断时保存的 PRIMASK, 与 portSET_INTERRUPT_MASK_FROM_ISR()成对使用
+ * @param uint32_t ulPRIMASK
+ */
+static portFORCE_INLINE void vPortRestorePRIMASK(uint32_t ulPRIMASK)
+{
+    __asm volatile("msr primask, %0" ::"r"(ulPRIMASK) : "memory");
+}
+/******************************************************************************/
+
+/******************************************************************************/
+/**
+ * @brief 原子比较并交换, ARMv6-M 没有 LDREX/STREX, 通过短暂关中断实现
+ * @param volatile uint32_t *pulDestination: 目标地址
+ * @param uint32_t ulExchange: *pulDestination 等于 ulComparand 时写入的新值
+ * @param uint32_t ulComparand: 期望的旧值
+ * @returns BaseType_t: pdTRUE 交换成功, pdFALSE *pulDestination 不等于 ulComparand
+ */
+static portFORCE_INLINE BaseType_t xPortCompareAndSwap(volatile uint32_t *pulDestination,
+                                                      uint32_t ulExchange,
+                                                      uint32_t ulComparand)
+{
+    BaseType_t xReturn = pdFALSE;
+    const uint32_t ulPRIMASK = ulPortSetPRIMASK();
+
+    if (*pulDestination == ulComparand)
+    {
+        *pulDestination = ulExchange;
+        xReturn = pdTRUE;
+    }
+
+    vPortRestorePRIMASK(ulPRIMASK);
+
+    return xReturn;
+}
+/******************************************************************************/
+
+/******************************************************************************/
+// ARMv6-M 没有 CLZ 指令, 最高优先级通过 256 项查找表逐字节确定
+// ucPortHighestBitTable[x] 为字节 x 中最高置位的位号, x 为 0 时无意义
+extern const uint8_t ucPortHighestBitTable[256];
+
+/**
+ * @brief 查找 32 位就绪位图中最高置位的位号, 从高字节开始, 最多查表一次
+ * @param uint32_t ulReadyPriorities: 就绪位图, 不能为 0
+ * @returns uint32_t: 最高置位的位号
+ */
+static portFORCE_INLINE uint32_t ulPortHighestSetBit(uint32_t ulReadyPriorities)
+{
+    if ((ulReadyPriorities & 0xffff0000UL) != 0UL)
+    {
+        if ((ulReadyPriorities & 0xff000000UL) != 0UL)
+        {
+            return 24UL + ucPortHighestBitTable[ulReadyPriorities >> 24];
+        }
+        return 16UL + ucPortHighestBitTable[(ulReadyPriorities >> 16) & 0xffUL];
+    }
+
+    if ((ulReadyPriorities & 0x0000ff00UL) != 0UL)
+    {
+        return 8UL + ucPortHighestBitTable[ulReadyPriorities >> 8];
+    }
+    return ucPortHighestBitTable[ulReadyPriorities];
+}
+
+// 将 uxPriority 标记到 uxReadyPriorities(uint32_t) 的某一位上
+#define portRECORD_READY_PRIORITY(uxPriority, uxReadyPriorities) \
+    (uxReadyPriorities) |= (1UL << (uxPriority))
+// 按照 uxPriority 将 uxReadyPriorities(uint32_t) 的某一位清零
+#define portRESET_READY_PRIORITY(uxPriority, uxReadyPriorities) \
+    (uxReadyPriorities) &= ~(1UL << (uxPriority))
+// 查表法寻找最高优先级
+#define portGET_HIGHEST_PRIORITY(uxTopPriority, uxReadyPriorities) \
+    (uxTopPriority) = ulPortHighestSetBit((uint32_t)(uxReadyPriorities))
+/******************************************************************************/
+#endif // _PORTMACRO_H_
@@ -0,0 +1,358 @@
+#include "portmacro.h"
+#include "projectdefs.h"
+#include "rtos_config.h"
+#include "task.h"
+
+// 临界段嵌套计数器, 默认初始化为 0xaaaaaaaa, 在调度器启动时会被重新初始化为 0 ：vTaskStartScheduler()->xPortStartScheduler()->uxCriticalNesting = 0
+static uint32_t uxCriticalNesting = 0xaaaaaaaa;
+
+#if (configUSE_SYSTICK_CYCLE_COUNTER == 1)
+// SysTick 回绕次数, 只在 SysTick 中断中累加, 不受手动推进 xTickCount 的影响
+static volatile uint32_t ulSysTickWraps = 0;
+#endif
+
+extern List_t pxReadyTasksLists[configMAX_PRIORITIES];
+
+/******************************************************************************/
+// SysTick init
+// SysTick 控制寄存器
+#define portNVIC_SYSTICK_CTRL_REG (*((volatile uint32_t *)0xE000E010))
+// SysTick 重装载寄存器寄存器
+#define portNVIC_SYSTICK_LOAD_REG (*((volatile uint32_t *)0xE000E014))
+
+#ifndef configSYSTICK_CLOCK_HZ
+#define configSYSTICK_CLOCK_HZ configCPU_CLOCK_HZ
+// 确保 SysTick 的时钟与内核时钟一致
+#define portNVIC_SYSTICK_CLK_BIT (1ul << 2ul)
+#else
+#define portNVIC_SYSTICK_CLK_BIT (0)
+#endif
+
+#define portNVIC_SYSTICK_INT_BIT (1UL << 1UL)
+#define portNVIC_SYSTICK_ENABLE_BIT (1UL << 0UL)
+
+/**
+ * @brief SysTick 初始化
+ */
+void vPortSetupTimerInterrupt(void)
+{
+    // 设置重装载寄存器的值
+    portNVIC_SYSTICK_LOAD_REG = (configSYSTICK_CLOCK_HZ / configTICK_RATE_HZ) - 1UL;
+
+    // 设置系统定时器(??SysTick)的时钟等于内核时钟, 使能 SysTick 定时器中断, 使能 SysTick 定时器
+    portNVIC_SYSTICK_CTRL_REG = (portNVIC_SYSTICK_CLK_BIT |
+                                 portNVIC_SYSTICK_INT_BIT |
+                                 portNVIC_SYSTICK_ENABLE_BIT);
+}
+
+// 按照startup中的向量表重新定义函数的名字
+#define xPortSysTickHandler SysTick_Handler
+
+/**
+ * @brief SysTick call back, 实现延时
+ */
+void xPortSysTickHandler(void)
+// void SysTick_Handler(void)
+{
+    traceISR_ENTER(traceIRQ_SYSTICK);
+
+    // vPortRaiseBASEPRI();
+    portDISABLE_INTERRUPTS();
+
+#if (configUSE_SYSTICK_CYCLE_COUNTER == 1)
+    ulSysTickWraps++;
+#endif
+    xTaskIncrementTick();
+
+    // portENABLE_INTERRUPTS()
+    // vPortClearBASEPRIFromISR();
+    portENABLE_INTERRUPTS();
+
+    traceISR_EXIT(traceIRQ_SYSTICK);
+}
+/******************************************************************************/
+
+/******************************************************************************/
+#if (configUSE_SYSTICK_CYCLE_COUNTER == 1)
+// SysTick 当前值寄存器
+#define portNVIC_SYSTICK_CURRENT_VALUE_REG (*((volatile uint32_t *)0xE000E018))
+// ICSR Bit 26 PENDSTSET: SysTick 中断挂起
+#define portNVIC_PENDSTSET_BIT (1UL << 26UL)
+
+/**
+ * @brief 由 SysTick 回绕次数和当前值拼出周期数
+ * @returns uint32_t: 调度器启动以来 SysTick 的时钟周期数, 32 位回绕
+ */
+uint32_t ulPortGetSysTickCycleCount(void)
+{
+    uint32_t ulWraps, ulCurrent;
+    const uint32_t ulMask = portSET_INTERRUPT_MASK_FROM_ISR();
+
+    ulWraps = ulSysTickWraps;
+    ulCurrent = portNVIC_SYSTICK_CURRENT_VALUE_REG;
+
+    // SysTick 已经回绕但中断还没有执行(正在临界段中), 重新读取当前值并补上这一次回绕
+    if ((portNVIC_INT_CTRL_REG & portNVIC_PENDSTSET_BIT) != 0UL)
+    {
+        ulCurrent = portNVIC_SYSTICK_CURRENT_VALUE_REG;
+        ulWraps++;
+    }
+
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(ulMask);
+
+    return (ulWraps * (portNVIC_SYSTICK_LOAD_REG + 1UL)) + (portNVIC_SYSTICK_LOAD_REG - ulCurrent);
+}
+
+/**
+ * @brief SysTick 由 vPortSetupTimerInterrupt() 启动, 不需要额外初始化
+ */
+static void prvInitCycleCounter(void)
+{
+}
+#else
+// 调试异常和监视控制寄存器 DEMCR, Bit 24 TRCENA: 使能 DWT 和 ITM
+#define portDEMCR_REG (*((volatile uint32_t *)0xE000EDFC))
+#define portDEMCR_TRCENA_BIT (1UL << 24UL)
+// DWT 控制寄存器, Bit 0 CYCCNTENA: 使能周期计数器
+#define portDWT_CTRL_REG (*((volatile uint32_t *)0xE0001000))
+#define portDWT_CYCCNTENA_BIT (1UL << 0UL)
+
+/**
+ * @brief 使能 DWT 周期计数器. 不清零计数值, 调度器启动前的读数(运行时间统计的起点)与之后的读数相减仍然正确
+ */
+static void prvInitCycleCounter(void)
+{
+    portDEMCR_REG |= portDEMCR_TRCENA_BIT;
+    portDWT_CTRL_REG |= portDWT_CYCCNTENA_BIT;
+}
+#endif
+/******************************************************************************/
+
+/******************************************************************************/
+// xPSR 寄存器的初始值
+#define portINITIAL_XPSR (0x01000000L)
+#define portSTART_ADDRESS_MASK ((StackType_t)0xfffffffeUL)
+
+/**
+ * @brief 异常发生之后, 任务函数最终进入的函数
+ */
+static void prvTaskExitError(void)
+{
+
+    for (;;)
+        ;
+}
+
+/**
+ * @brief 任务栈初始化, 构建异常上下文, 与体系结构相关!
+ * @param StackType_t *pxTopOfStack: 栈顶
+ * @param TaskFuntion_t pxCode: 任务入口
+ * @param void *pvParameters: 任务形参
+ * @returns StackType_t pxTopOfStack: 此时 pxTopOfStack 指向空闲栈
+ */
+StackType_t *pxPortInitialiseStack(StackType_t *pxTopOfStack,
+                                   TaskFuntion_t pxCode,
+                                   void *pvParameters)
+{
+    // 注意:
+    // Cortex-M3 的栈是由高地址向低地址生长的,
+    // 因此可以看到任务栈在初始化时 pxTopOfStack 这个指针一直在递减,
+    // 而堆是从低地址向高地址生长的,
+    // pxTopOfStack 这些变量仅仅表示指针, 并不一定表示 pxTopOfStack 就一定在高地址.
+    // 异常: 中断,系统调用,任务切换等
+    // 异常发生时, 以下栈中写入的内容(异常上下文)会被自动加载到 CPU 寄存器内:
+    // CPU 自动从栈中加载到 CPU 寄存器的内容,
+    // 包括 8 个寄存器, 分别为 R0,R1,R2,R3,R12,R14,R15 和 xPSR 的位 24
+    pxTopOfStack--;
+    // xPSR 的第 24 位, 必须置 1
+    *pxTopOfStack = portINITIAL_XPSR;
+    pxTopOfStack--;
+    // R15(PC) 指向任务函数, 即任务入口地址
+    *pxTopOfStack = ((StackType_t)pxCode) & portSTART_ADDRESS_MASK;
+    pxTopOfStack--;
+    // R14(LR) 任务的异常返回地址, 通常任务是不会返回的,
+    // 如果返回了就跳转到 prvTaskExitError, 该函数是一个无限循环
+    *pxTopOfStack = (StackType_t)prvTaskExitError;
+    // R12, R3, R2 and R1 默认初始化为 0
+    pxTopOfStack -= 5;
+    // R0
+    *pxTopOfStack = (StackType_t)pvParameters;
+
+    // 异常发生时, 以下栈中写入内容被手动加载到 CPU 寄存器内
+    // 即软件弹栈
+    pxTopOfStack -= 8;
+
+    // 返回栈顶指针, 此时 pxTopOfStack 指向栈中代表 R4 的位置
+    return pxTopOfStack;
+}
+
+/**
+ * @brief 1. 更新 MSP 的值,
+ * @brief 2. 产生 SVC 系统调用, 然后去到 SVC 的中断服务函数里面真正切换到第一个任务
+ * @brief 寄存器说明见 RVDS 移植中的同名函数
+ */
+static void prvStartFirstTask(void) __attribute__((naked));
+static void prvStartFirstTask(void)
+{
+    __asm volatile(
+        "   ldr r0, =0xE000ED08 \n" /* SCB_VTOR 寄存器的地址 */
+        "   ldr r0, [r0]        \n" /* 向量表的起始地址 */
+        "   ldr r0, [r0]        \n" /* 向量表第一项为 MSP 的初始值 */
+        "   msr msp, r0         \n" /* 设置主堆栈指针 msp 的值 */
+        "   cpsie i             \n" /* 使能全局中断 */
+        "   cpsie f             \n"
+        "   dsb                 \n"
+        "   isb                 \n"
+        "   svc 0               \n" /* 调用 SVC 去启动第一个任务 */
+        "   nop                 \n"
+        "   .ltorg              \n");
+}
+
+// PM0056:
+// The SHPR1-SHPR3 registers set the priority level,
+// 0 to 15 of the exception handlers that have configurable priority.
+// SHPR1-SHPR3 are byte accessible.
+// Each PRI_N field is 8 bits wide,
+// but the processor implements only bits[7:4] of each field,
+// and bits[3:0] read as zero and ignore writes.
+// System handler priority register 3 (SCB_SHPR3)
+// Address: 0xE000 ED20
+// Reset value: 0x0000 0000
+// Required privilege: Privileged
+// Bits 31:24 PRI_15[7:0]: Priority of system handler 15, SysTick exception
+// Bits 23:16 PRI_14[7:0]: Priority of system handler 14, PendSV
+// Bits 15:0 Reserved, must be kept cleared
+#define portNVIC_SYSPRI2_REG (*((volatile uint32_t *)0xe000ed20))
+#define portNVIC_PENDSV_PRI (((uint32_t)configKERNEL_INTERRUPT_PRIORITY) << 16UL)
+#define portNVIC_SYSTICK_PRI (((uint32_t)configKERNEL_INTERRUPT_PRIORITY) << 24UL)
+
+/**
+ * @brief 启动调度器
+ * @returns BaseType_t 0: 不应该有返回值
+ */
+BaseType_t xPortStartScheduler(void)
+{
+    // 配置 PendSV 和 SysTick 的中断优先级为最低,
+    // SysTick 和 PendSV 都会涉及到系统调度, 系统调度的优先级要低于系统的其它硬件中断优先级,
+    // 即优先响应系统中的外部硬件中断
+    portNVIC_SYSPRI2_REG |= portNVIC_SYSTICK_PRI;
+    portNVIC_SYSPRI2_REG |= portNVIC_PENDSV_PRI;
+
+    uxCriticalNesting = 0;
+
+    // 初始化 SysTick
+    vPortSetupTimerInterrupt();
+
+    // 使能周期计数器
+    prvInitCycleCounter();
+
+    // 启动第一个任务, 不再返回
+    prvStartFirstTask();
+
+    // 不应该运行到这里
+    return 0;
+}
+
+// 按照startup中的向量表重新定义函数的名字
+#define xPortPendSVHandler PendSV_Handler
+#define vPortSVCHandler SVC_Handler
+
+/**
+ * @brief SVC call back, vPortSVCHandler()函数开始真正启动第一个任务,  不再返回
+ */
+void vPortSVCHandler(void) __attribute__((naked));
+void vPortSVCHandler(void)
+{
+    __asm volatile(
+        "   ldr r3, pxCurrentTCBConst2  \n"
+        "   ldr r1, [r3]                \n"
+        "   ldr r0, [r1]                \n" /* r0 = pxTopOfStack */
+        "   ldmia r0!, {r4-r11}         \n" /* 软件弹栈, 恢复 r4~r11 */
+        "   msr psp, r0                 \n" /* 任务执行的时候使用的堆栈指针是 psp */
+        "   isb                         \n"
+        "   mov r0, #0                  \n"
+        "   msr basepri, r0             \n" /* 打开所有中断 */
+        "   orr r14, #0xd               \n" /* 异常返回后进入线程模式, 使用 psp */
+        "   bx r14                      \n" /* 硬件弹栈: xPSR, PC, R14, R12, R3, R2, R1, R0 */
+        "                               \n"
+        "   .align 4                    \n"
+        "pxCurrentTCBConst2: .word pxCurrentTCB \n");
+}
+
+/**
+ * @brief PendSV call back, 实现任务切换
+ *
+ * 快速路径: 选回同一个任务且栈帧没有重建时, 不保存也不恢复 r4~r11, 不更新 PSP, 原理见 RVDS 移植
+ */
+void xPortPendSVHandler(void) __attribute__((naked));
+void xPortPendSVHandler(void)
+{
+    /* 在此之前, CPU已经对上一个任务自动压栈: xPSR, PC(任务入口地址), R14, R12, R3, R2, R1, R0(任务的形参) */
+    __asm volatile(
+        "   mrs r0, psp                 \n" /* PSP此时指向任务栈中代表 R0 的位置 */
+        "   isb                         \n"
+        "                               \n"
+        "   ldr r3, pxCurrentTCBConst   \n" /* 上文TCB */
+        "   ldr r2, [r3]                \n"
+        "                               \n"
+        "   sub r0, r0, #32             \n" /* 在任务栈中为 r4~r11 预留空间 */
+        "   str r0, [r2]                \n" /* 保存上一个任务的栈顶指针 pxTopOfStack, r4~r11 暂不写入 */
+        "                               \n"
+        "   stmdb sp!, {r0, r2, r3, r14} \n" /* 上文栈顶, 上文TCB, R3 和 R14 临时压入主堆栈 */
+        "   mov r0, %0                  \n"
+        "   msr basepri, r0             \n" /* 关中断, 进入临界段, 接下来要更新 pxCurrentTCB */
+        "   dsb                         \n"
+        "   isb                         \n"
+        "   bl vTaskSwitchContext       \n"
+        "   mov r0, #0                  \n" /* 退出临界段, 开中断 */
+        "   msr basepri, r0             \n"
+        "   ldmia sp!, {r0, r2, r3, r14} \n"
+        "                               \n"
+        "   ldr r1, [r3]                \n" /* 下文TCB */
+        "   ldr r12, [r1]               \n" /* 下文栈顶 */
+        "   cmp r1, r2                  \n"
+        "   it eq                       \n"
+        "   cmpeq r12, r0               \n"
+        "   it eq                       \n"
+        "   bxeq r14                    \n" /* 下文就是上文: r4~r11 仍在寄存器中, 直接返回 */
+        "                               \n"
+        "   stmia r0, {r4-r11}          \n" /* 确定切换, 将上文的 r4~r11 写入预留的空间 */
+        "   ldmia r12!, {r4-r11}        \n"
+        "   msr psp, r12                \n"
+        "   isb                         \n"
+        "   bx r14                      \n"
+        "                               \n"
+        "   .align 4                    \n"
+        "pxCurrentTCBConst: .word pxCurrentTCB \n" ::"i"(configMAX_SYSCALL_INTERRUPT_PRIORITY));
+}
+/******************************************************************************/
+
+/******************************************************************************/
+// Masks off all bits but the VECTACTIVE bits in the ICSR register.
+#define portVECTACTIVE_MASK (0xFFUL)
+
+/**
+ * @brief 进入临界段, 无中断保护
+ */
+void vPortEnterCritical(void)
+{
+    portDISABLE_INTERRUPTS();
+    uxCriticalNesting++;
+
+    // 如果 uxCriticalNesting 等于 1, 即一层嵌套, 要确保当前没有中断活跃, 即内核外设 SCB 中的中断和控制寄存器 SCB_ICSR 的低 8 位要等于 0
+    if (uxCriticalNesting == 1)
+        configASSERT((portNVIC_INT_CTRL_REG & portVECTACTIVE_MASK) == 0);
+}
+
+/**
+ * @brief 退出临界段, 无中断保护
+ */
+void vPortExitCritical(void)
+{
+    configASSERT(uxCriticalNesting);
+    uxCriticalNesting--;
+
+    if (uxCriticalNesting == 0)
+        portENABLE_INTERRUPTS();
+}
+/******************************************************************************/
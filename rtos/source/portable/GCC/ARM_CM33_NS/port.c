@@ -0,0 +1,578 @@
+#include "portmacro.h"
+#include "projectdefs.h"
+#include "rtos_config.h"
+#include "task.h"
+
+#if (configUSE_SECURE_CONTEXT == 1)
+#include "secure_context.h"
+#endif
+
+// 临界段嵌套计数器, 默认初始化为 0xaaaaaaaa, 在调度器启动时会被重新初始化为 0 ：vTaskStartScheduler()->xPortStartScheduler()->uxCriticalNesting = 0
+static uint32_t uxCriticalNesting = 0xaaaaaaaa;
+
+#if (configUSE_SYSTICK_CYCLE_COUNTER == 1)
+// SysTick 回绕次数, 只在 SysTick 中断中累加, 不受手动推进 xTickCount 的影响
+static volatile uint32_t ulSysTickWraps = 0;
+#endif
+
+extern List_t pxReadyTasksLists[configMAX_PRIORITIES];
+
+#if (configUSE_SECURE_CONTEXT == 1)
+// 当前任务的安全上下文句柄, 作为任务上下文的一部分在切换时保存到任务栈和从任务栈恢复
+portDONT_DISCARD volatile SecureContextHandle_t xSecureContext = portNO_SECURE_CONTEXT;
+#endif
+
+/******************************************************************************/
+// SysTick init
+// SysTick 控制寄存器
+#define portNVIC_SYSTICK_CTRL_REG (*((volatile uint32_t *)0xE000E010))
+// SysTick 重装载寄存器寄存器
+#define portNVIC_SYSTICK_LOAD_REG (*((volatile uint32_t *)0xE000E014))
+
+#ifndef configSYSTICK_CLOCK_HZ
+#define configSYSTICK_CLOCK_HZ configCPU_CLOCK_HZ
+// 确保 SysTick 的时钟与内核时钟一致
+#define portNVIC_SYSTICK_CLK_BIT (1ul << 2ul)
+#else
+#define portNVIC_SYSTICK_CLK_BIT (0)
+#endif
+
+#define portNVIC_SYSTICK_INT_BIT (1UL << 1UL)
+#define portNVIC_SYSTICK_ENABLE_BIT (1UL << 0UL)
+
+/**
+ * @brief SysTick 初始化
+ */
+void vPortSetupTimerInterrupt(void)
+{
+    // 设置重装载寄存器的值
+    portNVIC_SYSTICK_LOAD_REG = (configSYSTICK_CLOCK_HZ / configTICK_RATE_HZ) - 1UL;
+
+    // 设置系统定时器(??SysTick)的时钟等于内核时钟, 使能 SysTick 定时器中断, 使能 SysTick 定时器
+    portNVIC_SYSTICK_CTRL_REG = (portNVIC_SYSTICK_CLK_BIT |
+                                 portNVIC_SYSTICK_INT_BIT |
+                                 portNVIC_SYSTICK_ENABLE_BIT);
+}
+
+// 按照startup中的向量表重新定义函数的名字
+#define xPortSysTickHandler SysTick_Handler
+
+/**
+ * @brief SysTick call back, 实现延时
+ */
+void xPortSysTickHandler(void)
+// void SysTick_Handler(void)
+{
+    traceISR_ENTER(traceIRQ_SYSTICK);
+
+    // vPortRaiseBASEPRI();
+    portDISABLE_INTERRUPTS();
+
+#if (configUSE_SYSTICK_CYCLE_COUNTER == 1)
+    ulSysTickWraps++;
+#endif
+    xTaskIncrementTick();
+
+    // portENABLE_INTERRUPTS()
+    // vPortClearBASEPRIFromISR();
+    portENABLE_INTERRUPTS();
+
+    traceISR_EXIT(traceIRQ_SYSTICK);
+}
+/******************************************************************************/
+
+/******************************************************************************/
+#if (configUSE_SYSTICK_CYCLE_COUNTER == 1)
+// SysTick 当前值寄存器
+#define portNVIC_SYSTICK_CURRENT_VALUE_REG (*((volatile uint32_t *)0xE000E018))
+// ICSR Bit 26 PENDSTSET: SysTick 中断挂起
+#define portNVIC_PENDSTSET_BIT (1UL << 26UL)
+
+/**
+ * @brief 由 SysTick 回绕次数和当前值拼出周期数
+ * @returns uint32_t: 调度器启动以来 SysTick 的时钟周期数, 32 位回绕
+ */
+uint32_t ulPortGetSysTickCycleCount(void)
+{
+    uint32_t ulWraps, ulCurrent;
+    const uint32_t ulMask = portSET_INTERRUPT_MASK_FROM_ISR();
+
+    ulWraps = ulSysTickWraps;
+    ulCurrent = portNVIC_SYSTICK_CURRENT_VALUE_REG;
+
+    // SysTick 已经回绕但中断还没有执行(正在临界段中), 重新读取当前值并补上这一次回绕
+    if ((portNVIC_INT_CTRL_REG & portNVIC_PENDSTSET_BIT) != 0UL)
+    {
+        ulCurrent = portNVIC_SYSTICK_CURRENT_VALUE_REG;
+        ulWraps++;
+    }
+
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(ulMask);
+
+    return (ulWraps * (portNVIC_SYSTICK_LOAD_REG + 1UL)) + (portNVIC_SYSTICK_LOAD_REG - ulCurrent);
+}
+
+/**
+ * @brief SysTick 由 vPortSetupTimerInterrupt() 启动, 不需要额外初始化
+ */
+static void prvInitCycleCounter(void)
+{
+}
+#else
+// 调试异常和监视控制寄存器 DEMCR, Bit 24 TRCENA: 使能 DWT 和 ITM
+#define portDEMCR_REG (*((volatile uint32_t *)0xE000EDFC))
+#define portDEMCR_TRCENA_BIT (1UL << 24UL)
+// DWT 控制寄存器, Bit 0 CYCCNTENA: 使能周期计数器
+#define portDWT_CTRL_REG (*((volatile uint32_t *)0xE0001000))
+#define portDWT_CYCCNTENA_BIT (1UL << 0UL)
+
+/**
+ * @brief 使能 DWT 周期计数器. 不清零计数值, 调度器启动前的读数(运行时间统计的起点)与之后的读数相减仍然正确
+ */
+static void prvInitCycleCounter(void)
+{
+    portDEMCR_REG |= portDEMCR_TRCENA_BIT;
+    portDWT_CTRL_REG |= portDWT_CYCCNTENA_BIT;
+}
+#endif
+/******************************************************************************/
+
+/******************************************************************************/
+// xPSR 寄存器的初始值
+#define portINITIAL_XPSR (0x01000000L)
+#define portSTART_ADDRESS_MASK ((StackType_t)0xfffffffeUL)
+// 任务初始的 EXC_RETURN: 返回线程模式, 使用 PSP, 不带 FPU 栈帧
+// 非安全侧为 0xffffffbc(使用非安全栈), 只运行在安全状态时为 0xfffffffd
+#if (configRUN_SECURE_ONLY == 1)
+#define portINITIAL_EXC_RETURN (0xfffffffd)
+#else
+#define portINITIAL_EXC_RETURN (0xffffffbc)
+#endif
+
+/**
+ * @brief 异常发生之后, 任务函数最终进入的函数
+ */
+static void prvTaskExitError(void)
+{
+
+    for (;;)
+        ;
+}
+
+/**
+ * @brief 任务栈初始化, 构建异常上下文, 与体系结构相关!
+ * @param StackType_t *pxTopOfStack: 栈顶
+ * @param TaskFuntion_t pxCode: 任务入口
+ * @param void *pvParameters: 任务形参
+ * @returns StackType_t pxTopOfStack: 此时 pxTopOfStack 指向空闲栈
+ */
+StackType_t *pxPortInitialiseStack(StackType_t *pxTopOfStack,
+                                   TaskFuntion_t pxCode,
+                                   void *pvParameters)
+{
+    // 注意:
+    // Cortex-M33 的栈是由高地址向低地址生长的,
+    // 因此可以看到任务栈在初始化时 pxTopOfStack 这个指针一直在递减,
+    // 而堆是从低地址向高地址生长的,
+    // pxTopOfStack 这些变量仅仅表示指针, 并不一定表示 pxTopOfStack 就一定在高地址.
+    // 异常: 中断,系统调用,任务切换等
+    // 异常发生时, 以下栈中写入的内容(异常上下文)会被自动加载到 CPU 寄存器内:
+    // CPU 自动从栈中加载到 CPU 寄存器的内容,
+    // 包括 8 个寄存器, 分别为 R0,R1,R2,R3,R12,R14,R15 和 xPSR 的位 24
+    pxTopOfStack--;
+    // xPSR 的第 24 位, 必须置 1
+    *pxTopOfStack = portINITIAL_XPSR;
+    pxTopOfStack--;
+    // R15(PC) 指向任务函数, 即任务入口地址
+    *pxTopOfStack = ((StackType_t)pxCode) & portSTART_ADDRESS_MASK;
+    pxTopOfStack--;
+    // R14(LR) 任务的异常返回地址, 通常任务是不会返回的,
+    // 如果返回了就跳转到 prvTaskExitError, 该函数是一个无限循环
+    *pxTopOfStack = (StackType_t)prvTaskExitError;
+    // R12, R3, R2 and R1 默认初始化为 0
+    pxTopOfStack -= 5;
+    // R0
+    *pxTopOfStack = (StackType_t)pvParameters;
+
+    // 异常发生时, 以下栈中写入内容被手动加载到 CPU 寄存器内
+    // 即软件弹栈
+    // R11 ~ R4
+    pxTopOfStack -= 8;
+    // EXC_RETURN, 任务开始时没有 FPU 上下文, 第一次使用 FPU 后由硬件置位 CONTROL.FPCA
+    pxTopOfStack--;
+    *pxTopOfStack = portINITIAL_EXC_RETURN;
+#if (configUSE_SECURE_CONTEXT == 1)
+    // 任务开始时没有安全上下文, 调用 portALLOCATE_SECURE_CONTEXT() 后才有
+    pxTopOfStack--;
+    *pxTopOfStack = portNO_SECURE_CONTEXT;
+#endif
+
+    // 返回栈顶指针, 此时 pxTopOfStack 指向栈中代表安全上下文句柄(或 EXC_RETURN)的位置
+    return pxTopOfStack;
+}
+
+/**
+ * @brief 1. 更新 MSP 的值,
+ * @brief 2. 产生 SVC 系统调用, 然后去到 SVC 的中断服务函数里面真正切换到第一个任务
+ * @brief 寄存器说明见 RVDS 移植中的同名函数
+ */
+static void prvStartFirstTask(void) __attribute__((naked));
+static void prvStartFirstTask(void)
+{
+    __asm volatile(
+        "   ldr r0, =0xE000ED08 \n" /* SCB_VTOR 寄存器的地址 */
+        "   ldr r0, [r0]        \n" /* 向量表的起始地址 */
+        "   ldr r0, [r0]        \n" /* 向量表第一项为 MSP 的初始值 */
+        "   msr msp, r0         \n" /* 设置主堆栈指针 msp 的值 */
+        "   mov r0, #0          \n"
+        "   msr control, r0     \n" /* 清除 CONTROL.FPCA, main() 中使用过的 FPU 状态不带入第一个任务 */
+        "   cpsie i             \n" /* 使能全局中断 */
+        "   cpsie f             \n"
+        "   dsb                 \n"
+        "   isb                 \n"
+        "   svc 0               \n" /* 调用 SVC 去启动第一个任务 */
+        "   nop                 \n"
+        "   .ltorg              \n");
+}
+
+#if (configUSE_FPU == 1)
+/**
+ * @brief 使能 FPU: 协处理器访问控制寄存器 CPACR 中 CP10, CP11 设为完全访问,
+ *        非安全侧还需要安全侧镜像在 NSACR 中开放 CP10, CP11
+ */
+static void prvEnableVFP(void) __attribute__((naked));
+static void prvEnableVFP(void)
+{
+    __asm volatile(
+        "   ldr r0, =0xE000ED88     \n" /* CPACR 寄存器的地址 */
+        "   ldr r1, [r0]            \n"
+        "   orr r1, r1, #(0xf << 20) \n" /* CP10, CP11 完全访问 */
+        "   str r1, [r0]            \n"
+        "   bx r14                  \n"
+        "   .ltorg                  \n");
+}
+#endif
+
+// PM0056:
+// The SHPR1-SHPR3 registers set the priority level,
+// 0 to 15 of the exception handlers that have configurable priority.
+// SHPR1-SHPR3 are byte accessible.
+// Each PRI_N field is 8 bits wide,
+// but the processor implements only bits[7:4] of each field,
+// and bits[3:0] read as zero and ignore writes.
+// System handler priority register 3 (SCB_SHPR3)
+// Address: 0xE000 ED20
+// Reset value: 0x0000 0000
+// Required privilege: Privileged
+// Bits 31:24 PRI_15[7:0]: Priority of system handler 15, SysTick exception
+// Bits 23:16 PRI_14[7:0]: Priority of system handler 14, PendSV
+// Bits 15:0 Reserved, must be kept cleared
+#define portNVIC_SYSPRI2_REG (*((volatile uint32_t *)0xe000ed20))
+#define portNVIC_PENDSV_PRI (((uint32_t)configKERNEL_INTERRUPT_PRIORITY) << 16UL)
+#define portNVIC_SYSTICK_PRI (((uint32_t)configKERNEL_INTERRUPT_PRIORITY) << 24UL)
+
+// 系统处理程序控制及状态寄存器 SHCSR
+// Bit 18 USGFAULTENA: 使能 UsageFault, PSPLIM 检测到的栈溢出(UFSR.STKOF)进入 UsageFault 而不是 HardFault
+#define portSCB_SHCSR_REG (*((volatile uint32_t *)0xe000ed24))
+#define portSCB_USGFAULTENA_BIT (1UL << 18UL)
+
+#if (configUSE_FPU == 1)
+// 浮点上下文控制寄存器 FPCCR
+// Bit 31 ASPEN: 使用 FPU 时自动置位 CONTROL.FPCA, 异常进入时自动保存 FPU 上下文
+// Bit 30 LSPEN: 惰性压栈, 异常进入时只在栈上预留 s0~s15, FPSCR 的空间, 异常处理中真正使用 FPU 时才写入
+#define portFPCCR (*((volatile uint32_t *)0xe000ef34))
+#define portASPEN_AND_LSPEN_BITS (0x3UL << 30UL)
+#endif
+
+/**
+ * @brief 启动调度器
+ * @returns BaseType_t 0: 不应该有返回值
+ */
+BaseType_t xPortStartScheduler(void)
+{
+    // 配置 PendSV 和 SysTick 的中断优先级为最低,
+    // SysTick 和 PendSV 都会涉及到系统调度, 系统调度的优先级要低于系统的其它硬件中断优先级,
+    // 即优先响应系统中的外部硬件中断
+    portNVIC_SYSPRI2_REG |= portNVIC_SYSTICK_PRI;
+    portNVIC_SYSPRI2_REG |= portNVIC_PENDSV_PRI;
+
+    uxCriticalNesting = 0;
+
+    // 初始化 SysTick
+    vPortSetupTimerInterrupt();
+
+    // 使能周期计数器
+    prvInitCycleCounter();
+
+    // 任务栈溢出由 PSPLIM 检测, 使能 UsageFault 便于区分
+    portSCB_SHCSR_REG |= portSCB_USGFAULTENA_BIT;
+
+#if (configUSE_FPU == 1)
+    // 使能 FPU 和惰性压栈
+    prvEnableVFP();
+    portFPCCR |= portASPEN_AND_LSPEN_BITS;
+#endif
+
+    // 启动第一个任务, 不再返回
+    prvStartFirstTask();
+
+    // 不应该运行到这里
+    return 0;
+}
+
+// 按照startup中的向量表重新定义函数的名字
+#define xPortPendSVHandler PendSV_Handler
+#define vPortSVCHandler SVC_Handler
+
+/**
+ * @brief SVC call back, vPortSVCHandler()函数开始真正启动第一个任务,  不再返回
+ *
+ * 任务栈帧(从 pxTopOfStack 向高地址): [安全上下文句柄], EXC_RETURN, r4~r11, [s16~s31], 硬件栈帧.
+ * PSPLIM 在每次切换时由 TCB 中的 pxStack 得到, 任务栈溢出时硬件直接产生 UsageFault, 不需要软件检查
+ */
+void vPortSVCHandler(void) __attribute__((naked));
+void vPortSVCHandler(void)
+{
+    __asm volatile(
+        "   ldr r3, pxCurrentTCBConst2  \n"
+        "   ldr r2, [r3]                \n"
+        "   ldr r0, [r2]                \n" /* r0 = pxTopOfStack */
+        "   ldr r1, [r2, %1]            \n" /* r1 = pxStack, 任务栈的最低地址 */
+        "   adds r1, r1, #7             \n" /* PSPLIM 低 3 位无效, 向上按 8 字节对齐 */
+        "   bic r1, r1, #7              \n"
+        "   msr psplim, r1              \n" /* 设置任务栈的下限 */
+#if (configUSE_SECURE_CONTEXT == 1)
+        "   ldmia r0!, {r1, r14}        \n" /* 任务初始时没有安全上下文, 不需要调用安全侧 */
+        "   ldr r3, xSecureContextConst2 \n"
+        "   str r1, [r3]                \n"
+#else
+        "   ldr r14, [r0], #4           \n" /* 恢复任务的 EXC_RETURN */
+#endif
+        "   ldmia r0!, {r4-r11}         \n" /* 软件弹栈, 恢复 r4~r11 */
+        "   msr psp, r0                 \n" /* 任务执行的时候使用的堆栈指针是 psp */
+        "   isb                         \n"
+        "   mov r0, #0                  \n"
+        "   msr basepri, r0             \n" /* 打开所有中断 */
+        "   bx r14                      \n" /* 按 EXC_RETURN 返回线程模式, 使用 psp */
+        "                               \n"
+        "   .align 4                    \n"
+        "pxCurrentTCBConst2: .word pxCurrentTCB \n"
+#if (configUSE_SECURE_CONTEXT == 1)
+        "xSecureContextConst2: .word xSecureContext \n"
+#endif
+        ::"i"(configMAX_SYSCALL_INTERRUPT_PRIORITY), "i"(offsetof(TCB_t, pxStack)));
+}
+
+/**
+ * @brief PendSV call back, 实现任务切换
+ *
+ * 有安全上下文的任务先由安全侧保存安全栈. 如果任务被打断时正在执行安全侧代码(EXC_RETURN.S 为 1),
+ * 硬件已经把 r4~r11 压入安全栈并清零, 非安全侧只需保存安全上下文句柄和 EXC_RETURN
+ *
+ * 不使用安全上下文时(包括 configRUN_SECURE_ONLY)有快速路径: 选回同一个任务且栈帧没有重建时,
+ * 不保存也不恢复 EXC_RETURN, r4~r11, s16~s31, 不更新 PSP 和 PSPLIM, 原理见 ARM_CM3 移植.
+ * 使用安全上下文时上文的保存方式取决于安全侧调用的结果, 仍在调用 vTaskSwitchContext() 之前完整保存
+ */
+void xPortPendSVHandler(void) __attribute__((naked));
+void xPortPendSVHandler(void)
+{
+    /* 在此之前, CPU已经对上一个任务自动压栈: xPSR, PC(任务入口地址), R14, R12, R3, R2, R1, R0(任务的形参) */
+#if (configUSE_SECURE_CONTEXT == 1)
+    __asm volatile(
+        "   mrs r0, psp                 \n" /* PSP此时指向任务栈中代表 R0 的位置 */
+        "   isb                         \n"
+        "                               \n"
+        "   ldr r3, pxCurrentTCBConst   \n" /* 上文TCB */
+        "   ldr r2, [r3]                \n"
+        "                               \n"
+        "   ldr r3, xSecureContextConst \n"
+        "   ldr r1, [r3]                \n" /* r1 = 上文的安全上下文句柄 */
+        "   cbz r1, 1f                  \n" /* 没有安全上下文, 直接保存非安全上下文 */
+        "   push {r0-r2, r14}           \n"
+        "   mov r0, r1                  \n"
+        "   bl vSecureContextSave       \n" /* 安全侧保存上文的安全栈 */
+        "   pop {r0-r3}                 \n"
+        "   mov r14, r3                 \n"
+        "   lsls r3, r3, #25            \n" /* EXC_RETURN.S 移到 N 标志 */
+        "   bmi 2f                      \n" /* 上文在安全状态被打断, r4~r11 已在安全栈中 */
+        "1:                             \n"
+#if (configUSE_FPU == 1)
+        "   tst r14, #0x10              \n" /* 任务使用过 FPU 则保存 s16~s31, 访问浮点寄存器时硬件先补齐惰性压栈的 s0~s15 */
+        "   it eq                       \n"
+        "   vstmdbeq r0!, {s16-s31}     \n"
+#endif
+        "   stmdb r0!, {r4-r11}         \n" /* 将 CPU 寄存器 r4~r11 的值存储到任务栈 */
+        "2:                             \n"
+        "   stmdb r0!, {r1, r14}        \n" /* 保存安全上下文句柄和 EXC_RETURN */
+        "   str r0, [r2]                \n" /* 保存上一个任务的栈顶指针 pxTopOfStack */
+        "                               \n"
+        "   push {r0, r14}              \n" /* R14 临时压入主堆栈, 保持 8 字节对齐 */
+        "   mov r0, %0                  \n"
+        "   msr basepri, r0             \n" /* 关中断, 进入临界段, 接下来要更新 pxCurrentTCB */
+        "   dsb                         \n"
+        "   isb                         \n"
+        "   bl vTaskSwitchContext       \n"
+        "   mov r0, #0                  \n" /* 退出临界段, 开中断 */
+        "   msr basepri, r0             \n"
+        "   pop {r0, r14}               \n"
+        "                               \n"
+        "   ldr r3, pxCurrentTCBConst   \n" /* 下文TCB */
+        "   ldr r2, [r3]                \n"
+        "   ldr r0, [r2]                \n"
+        "   ldr r1, [r2, %1]            \n" /* 由下文的 pxStack 设置 PSPLIM */
+        "   adds r1, r1, #7             \n"
+        "   bic r1, r1, #7              \n"
+        "   msr psplim, r1              \n"
+        "   ldmia r0!, {r1, r14}        \n" /* 恢复安全上下文句柄和 EXC_RETURN */
+        "   ldr r3, xSecureContextConst \n"
+        "   str r1, [r3]                \n"
+        "   cbz r1, 3f                  \n"
+        "   push {r0, r14}              \n"
+        "   mov r0, r1                  \n"
+        "   bl vSecureContextLoad       \n" /* 安全侧恢复下文的安全栈 */
+        "   pop {r0, r14}               \n"
+        "   lsls r3, r14, #25           \n"
+        "   bmi 4f                      \n" /* 下文在安全状态被打断, r4~r11 由硬件从安全栈恢复 */
+        "3:                             \n"
+        "   ldmia r0!, {r4-r11}         \n"
+#if (configUSE_FPU == 1)
+        "   tst r14, #0x10              \n" /* 下文使用过 FPU 则恢复 s16~s31 */
+        "   it eq                       \n"
+        "   vldmiaeq r0!, {s16-s31}     \n"
+#endif
+        "4:                             \n"
+        "   msr psp, r0                 \n"
+        "   isb                         \n"
+        "   bx r14                      \n"
+        "                               \n"
+        "   .align 4                    \n"
+        "pxCurrentTCBConst: .word pxCurrentTCB \n"
+        "xSecureContextConst: .word xSecureContext \n"
+        ::"i"(configMAX_SYSCALL_INTERRUPT_PRIORITY), "i"(offsetof(TCB_t, pxStack)));
+#else
+    __asm volatile(
+        "   mrs r0, psp                 \n" /* PSP此时指向任务栈中代表 R0 的位置 */
+        "   isb                         \n"
+        "                               \n"
+        "   ldr r3, pxCurrentTCBConst   \n" /* 上文TCB */
+        "   ldr r2, [r3]                \n"
+        "                               \n"
+#if (configUSE_FPU == 1)
+        "   tst r14, #0x10              \n" /* 任务使用过 FPU 则额外预留 s16~s31 的空间 */
+        "   it eq                       \n"
+        "   subeq r0, r0, #64           \n"
+#endif
+        "   sub r0, r0, #36             \n" /* 预留 EXC_RETURN 和 r4~r11 的空间 */
+        "   str r0, [r2]                \n" /* 保存上一个任务的栈顶指针 pxTopOfStack, 寄存器暂不写入 */
+        "                               \n"
+        "   push {r0, r2, r3, r14}      \n" /* 上文栈顶, 上文TCB, R3 和 R14 临时压入主堆栈 */
+        "   mov r0, %0                  \n"
+        "   msr basepri, r0             \n" /* 关中断, 进入临界段, 接下来要更新 pxCurrentTCB */
+        "   dsb                         \n"
+        "   isb                         \n"
+        "   bl vTaskSwitchContext       \n"
+        "   mov r0, #0                  \n" /* 退出临界段, 开中断 */
+        "   msr basepri, r0             \n"
+        "   pop {r0, r2, r3, r14}       \n"
+        "                               \n"
+        "   ldr r1, [r3]                \n" /* 下文TCB */
+        "   ldr r12, [r1]               \n" /* 下文栈顶 */
+        "   cmp r1, r2                  \n"
+        "   it eq                       \n"
+        "   cmpeq r12, r0               \n"
+        "   it eq                       \n"
+        "   bxeq r14                    \n" /* 下文就是上文且栈帧没有重建: 寄存器, PSP 和 PSPLIM 都不变, 直接返回 */
+        "                               \n"
+        "   str r14, [r0], #4           \n" /* 确定切换, 将上文的 EXC_RETURN 和 r4~r11 写入预留的空间 */
+        "   stmia r0!, {r4-r11}         \n"
+#if (configUSE_FPU == 1)
+        "   tst r14, #0x10              \n" /* 访问浮点寄存器时硬件先补齐惰性压栈的 s0~s15 */
+        "   it eq                       \n"
+        "   vstmiaeq r0, {s16-s31}      \n"
+#endif
+        "                               \n"
+        "   ldr r2, [r1, %1]            \n" /* 由下文的 pxStack 设置 PSPLIM */
+        "   adds r2, r2, #7             \n"
+        "   bic r2, r2, #7              \n"
+        "   msr psplim, r2              \n"
+        "   ldr r14, [r12], #4          \n" /* 恢复下文的 EXC_RETURN */
+        "   ldmia r12!, {r4-r11}        \n"
+#if (configUSE_FPU == 1)
+        "   tst r14, #0x10              \n" /* 下文使用过 FPU 则恢复 s16~s31 */
+        "   it eq                       \n"
+        "   vldmiaeq r12!, {s16-s31}    \n"
+#endif
+        "   msr psp, r12                \n"
+        "   isb                         \n"
+        "   bx r14                      \n"
+        "                               \n"
+        "   .align 4                    \n"
+        "pxCurrentTCBConst: .word pxCurrentTCB \n"
+        ::"i"(configMAX_SYSCALL_INTERRUPT_PRIORITY), "i"(offsetof(TCB_t, pxStack)));
+#endif
+}
+
+#if (configUSE_SECURE_CONTEXT == 1)
+/**
+ * @brief 为当前任务分配安全上下文, 在任务中调用安全侧函数之前调用一次
+ * @param uint32_t ulSecureStackSize: 安全栈大小, 单位为字节
+ */
+void vPortAllocateSecureContext(uint32_t ulSecureStackSize)
+{
+    // 分配后安全侧已切换到新的安全栈, 句柄必须在下一次任务切换之前记录下来
+    portENTER_CRITICAL();
+
+    configASSERT(xSecureContext == portNO_SECURE_CONTEXT);
+    xSecureContext = xSecureContextAllocate(ulSecureStackSize);
+    configASSERT(xSecureContext != portNO_SECURE_CONTEXT);
+
+    portEXIT_CRITICAL();
+}
+
+/**
+ * @brief 释放当前任务的安全上下文
+ */
+void vPortFreeSecureContext(void)
+{
+    portENTER_CRITICAL();
+
+    if (xSecureContext != portNO_SECURE_CONTEXT)
+    {
+        vSecureContextFree(xSecureContext);
+        xSecureContext = portNO_SECURE_CONTEXT;
+    }
+
+    portEXIT_CRITICAL();
+}
+#endif
+/******************************************************************************/
+
+/******************************************************************************/
+// Masks off all bits but the VECTACTIVE bits in the ICSR register.
+#define portVECTACTIVE_MASK (0xFFUL)
+
+/**
+ * @brief 进入临界段, 无中断保护
+ */
+void vPortEnterCritical(void)
+{
+    portDISABLE_INTERRUPTS();
+    uxCriticalNesting++;
+
+    // 如果 uxCriticalNesting 等于 1, 即一层嵌套, 要确保当前没有中断活跃, 即内核外设 SCB 中的中断和控制寄存器 SCB_ICSR 的低 8 位要等于 0
+    if (uxCriticalNesting == 1)
+        configASSERT((portNVIC_INT_CTRL_REG & portVECTACTIVE_MASK) == 0);
+}
+
+/**
+ * @brief 退出临界段, 无中断保护
+ */
+void vPortExitCritical(void)
+{
+    configASSERT(uxCriticalNesting);
+    uxCriticalNesting--;
+
+    if (uxCriticalNesting == 0)
+        portENABLE_INTERRUPTS();
+}
+/******************************************************************************/
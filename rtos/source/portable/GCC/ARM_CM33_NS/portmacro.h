@@ -0,0 +1,260 @@
+#ifndef _PORTMACRO_H_
+#define _PORTMACRO_H_
+
+#include "stdint.h"
+#include "stddef.h"
+#include "projectdefs.h"
+#include "rtos_config.h"
+
+// "??"为带有疑问的语句
+
+// object oriented
+// #define OO(name)                  \
+//     typedef struct name name##_t; \
+//     struct name
+
+#define portCHAR char
+#define portFLOAT float
+#define portDOUBLE double
+#define portLONG long
+#define portSHORT short
+
+// 4B
+#define portSTACK_TYPE uint32_t
+typedef portSTACK_TYPE StackType_t;
+
+// 8B??
+#define portBASE_TYPE long
+typedef long BaseType_t;
+typedef unsigned long UBaseType_t;
+
+// 与指针等宽的整数类型, 用于对指针做位运算
+#define portPOINTER_SIZE_TYPE uint32_t
+
+#if (configUSE_16_BIT_TICKS == 1)
+typedef uint16_t TickType_t;
+#define portMAX_DELAY (TickType_t)0xffff
+#else
+typedef uint32_t TickType_t;
+#define portMAX_DELAY (TickType_t)0xffffffffUL
+#endif
+
+// Cortex-M33 非安全侧移植的选项, 可在编译选项中覆盖
+// 安全上下文: 任务可以调用安全侧函数, 切换时由安全侧保存/恢复该任务的安全栈, 需要配套的安全侧镜像
+#ifndef configUSE_SECURE_CONTEXT
+#define configUSE_SECURE_CONTEXT 0
+#endif
+// 内核直接运行在安全状态, 没有非安全侧(如 QEMU 直接加载的镜像), 不能与安全上下文同时使用
+#ifndef configRUN_SECURE_ONLY
+#define configRUN_SECURE_ONLY 0
+#endif
+// 保存/恢复 FPU 上下文, 编译选项需带 -mfpu 和 -mfloat-abi=hard
+#ifndef configUSE_FPU
+#define configUSE_FPU 1
+#endif
+
+#if ((configUSE_SECURE_CONTEXT == 1) && (configRUN_SECURE_ONLY == 1))
+#error "configUSE_SECURE_CONTEXT requires a non-secure kernel, disable configRUN_SECURE_ONLY"
+#endif
+
+// 任务初始栈帧: 硬件自动保存的 8 个寄存器, r4~r11, EXC_RETURN 和安全上下文句柄, 初始不带 FPU 上下文
+#if (configUSE_SECURE_CONTEXT == 1)
+#define portINITIAL_FRAME_WORDS 18
+#else
+#define portINITIAL_FRAME_WORDS 17
+#endif
+
+/******************************************************************************/
+
+StackType_t *pxPortInitialiseStack(StackType_t *pxTopOfStack,
+                                   TaskFuntion_t pxCode,
+                                   void *pvParameters);
+BaseType_t xPortStartScheduler(void);
+/******************************************************************************/
+
+/******************************************************************************/
+#if (configUSE_SECURE_CONTEXT == 1)
+void vPortAllocateSecureContext(uint32_t ulSecureStackSize);
+void vPortFreeSecureContext(void);
+// 调用安全侧函数之前, 任务先为自己分配安全栈, 单位为字节
+#define portALLOCATE_SECURE_CONTEXT(ulSecureStackSize) vPortAllocateSecureContext(ulSecureStackSize)
+// 释放当前任务的安全上下文, 基本任务返回前必须释放
+#define portFREE_SECURE_CONTEXT() vPortFreeSecureContext()
+#endif
+/******************************************************************************/
+
+/******************************************************************************/
+#define portNVIC_INT_CTRL_REG (*((volatile uint32_t *)0xE000ED04))
+#define portNVIC_PENDSVSET_BIT (1UL << 28UL)
+#define portSY_FULL_READ_WRITE (15)
+
+// 触发上下文切换, 将 PendSV 的悬起位置 1, 当没有其它中断运行的时候响应 PendSV 中断, 去执行写好的 PendSV断服务函数, 在里面实现任务切换
+#define portYIELD()                                     \
+    {                                                   \
+        /* 触发PendSV, 产生上下文切换 */                \
+        portNVIC_INT_CTRL_REG = portNVIC_PENDSVSET_BIT; \
+        __asm volatile("dsb" ::: "memory");             \
+        __asm volatile("isb");                          \
+    }
+
+// 编译器及处理器内存屏障, 保证屏障前后的内存访问不被重排, 用于无锁数据结构
+#define portMEMORY_BARRIER() __asm volatile("dmb" ::: "memory")
+/******************************************************************************/
+
+/******************************************************************************/
+// 周期计数器, 用于基准测试和运行时间统计, 由 xPortStartScheduler() 使能, 32 位回绕, 两次读数相减即为间隔
+// QEMU 不模拟 DWT CYCCNT, 在 QEMU 上运行时将 configUSE_SYSTICK_CYCLE_COUNTER 置 1, 改由 SysTick 拼出周期数
+#ifndef configUSE_SYSTICK_CYCLE_COUNTER
+#define configUSE_SYSTICK_CYCLE_COUNTER 0
+#endif
+
+#if (configUSE_SYSTICK_CYCLE_COUNTER == 1)
+uint32_t ulPortGetSysTickCycleCount(void);
+#define portGET_CYCLE_COUNT() ulPortGetSysTickCycleCount()
+// 周期计数器的频率, 与 SysTick 的时钟相同
+#ifdef configSYSTICK_CLOCK_HZ
+#define portCYCLE_COUNTER_HZ (configSYSTICK_CLOCK_HZ)
+#else
+#define portCYCLE_COUNTER_HZ (configCPU_CLOCK_HZ)
+#endif
+#else
+// DWT CYCCNT, 每个内核时钟周期加 1
+#define portDWT_CYCCNT_REG (*((volatile uint32_t *)0xE0001004))
+#define portGET_CYCLE_COUNT() (portDWT_CYCCNT_REG)
+// 周期计数器的频率
+#define portCYCLE_COUNTER_HZ (configCPU_CLOCK_HZ)
+#endif
+/******************************************************************************/
+
+/******************************************************************************/
+// 临界段保护, 用于保护全局变量操作或者其他不能被打断的过程
+#ifndef portFORCE_INLINE
+#define portFORCE_INLINE inline __attribute__((always_inline))
+#endif
+
+// 仅被汇编代码引用的函数和变量, 防止被链接器优化掉
+#ifndef portDONT_DISCARD
+#define portDONT_DISCARD __attribute__((used))
+#endif
+
+// 无中断保护关中断, 开中断, 进临界段, 出临界段
+// 不带返回值的关中断函数, 不能嵌套, 不能在中断里面使用
+#define portDISABLE_INTERRUPTS() vPortRaiseBASEPRI()
+/**
+ * @brief 在往 BASEPRI 写入新的值的时候, 不用先将 BASEPRI 的值保存起来, 即不用管当前的中断状态是怎么样的, 既然不用管当前的中断状态, 也就意味着这样的函数不能在中断里面调用
+ */
+static portFORCE_INLINE void vPortRaiseBASEPRI(void)
+{
+    uint32_t ulNewBASEPRI;
+
+    __asm volatile(
+        "   mov %0, %1      \n"
+        "   msr basepri, %0 \n"
+        "   isb             \n"
+        "   dsb             \n"
+        : "=r"(ulNewBASEPRI)
+        : "i"(configMAX_SYSCALL_INTERRUPT_PRIORITY)
+        : "memory");
+}
+void vPortEnterCritical(void);
+// 不带返回值的进临界段函数, 不能嵌套, 不能在中断里面使用
+#define portENTER_CRITICAL() vPortEnterCritical()
+// 不带中断保护的开中断函数
+#define portENABLE_INTERRUPTS() vPortSetBASEPRI(0)
+void vPortExitCritical(void);
+// 不带中断保护的退出临界段函数
+#define portEXIT_CRITICAL() vPortExitCritical()
+
+// 有中断保护关中断, 开中断, 进临界段, 出临界段
+// 带返回值的关中断函数, 可以嵌套, 可以在中断里面使用
+#define portSET_INTERRUPT_MASK_FROM_ISR() ulPortRaiseBASEPRI()
+/**
+ * @brief 带返回值的关中断函数, 可以嵌套, 可以在中断里面使用. 带返回值的意思是: 在往 BASEPRI 写入新的值的时候, 先将 BASEPRI 的值保存起来, 在更新完BASEPRI 的值的时候, 将之前保存好的 BASEPRI 的值返回, 返回的值作为形参传入开中断函数
+ * @returns uint32_t ulReturn: BASEPRI的原始值
+ */
+static portFORCE_INLINE uint32_t ulPortRaiseBASEPRI(void)
+{
+    uint32_t ulReturn, ulNewBASEPRI;
+
+    __asm volatile(
+        "   mrs %0, basepri \n"
+        "   mov %1, %2      \n"
+        "   msr basepri, %1 \n"
+        "   isb             \n"
+        "   dsb             \n"
+        : "=r"(ulReturn), "=r"(ulNewBASEPRI)
+        : "i"(configMAX_SYSCALL_INTERRUPT_PRIORITY)
+        : "memory");
+
+    return ulReturn;
+}
+// 带中断保护的开中断函数
+#define portCLEAR_INTERRUPT_MASK_FROM_ISR(x) vPortSetBASEPRI(x)
+
+/**
+ * @brief 开中断函数, 将上一次关中断时保存的 BASEPRI 的值作为形参, 与 portSET_INTERRUPT_MASK_FROM_ISR()成对使用
+ * @param uint32_t ulBASEPRI
+ */
+static portFORCE_INLINE void vPortSetBASEPRI(uint32_t ulBASEPRI)
+{
+    __asm volatile("msr basepri, %0" ::"r"(ulBASEPRI) : "memory");
+}
+/******************************************************************************/
+
+/******************************************************************************/
+// armcc 的 __ldrex/__strex/__clrex 内建函数在 GCC 下没有对应, 用内联汇编实现
+static portFORCE_INLINE uint32_t ulPortLoadExclusive(volatile uint32_t *pulAddress)
+{
+    uint32_t ulValue;
+
+    __asm volatile("ldrex %0, [%1]" : "=r"(ulValue) : "r"(pulAddress) : "memory");
+
+    return ulValue;
+}
+
+static portFORCE_INLINE uint32_t ulPortStoreExclusive(volatile uint32_t *pulAddress, uint32_t ulValue)
+{
+    uint32_t ulFailed;
+
+    __asm volatile("strex %0, %2, [%1]" : "=&r"(ulFailed) : "r"(pulAddress), "r"(ulValue) : "memory");
+
+    return ulFailed;
+}
+
+/**
+ * @brief 原子比较并交换, 基于 LDREX/STREX 实现, 不需要关中断. 异常进入和返回时处理器会清除独占监视器,
+ *        因此被中断或任务切换打断的 STREX 会失败并重试
+ * @param volatile uint32_t *pulDestination: 目标地址
+ * @param uint32_t ulExchange: *pulDestination 等于 ulComparand 时写入的新值
+ * @param uint32_t ulComparand: 期望的旧值
+ * @returns BaseType_t: pdTRUE 交换成功, pdFALSE *pulDestination 不等于 ulComparand
+ */
+static portFORCE_INLINE BaseType_t xPortCompareAndSwap(volatile uint32_t *pulDestination,
+                                                      uint32_t ulExchange,
+                                                      uint32_t ulComparand)
+{
+    do
+    {
+        if (ulPortLoadExclusive(pulDestination) != ulComparand)
+        {
+            __asm volatile("clrex" ::: "memory");
+            return pdFALSE;
+        }
+    } while (ulPortStoreExclusive(pulDestination, ulExchange) != 0U);
+
+    return pdTRUE;
+}
+/******************************************************************************/
+
+/******************************************************************************/
+// 将 uxPriority 标记到 uxReadyPriorities(uint32_t) 的某一位上
+#define portRECORD_READY_PRIORITY(uxPriority, uxReadyPriorities) \
+    (uxReadyPriorities) |= (1UL << (uxPriority))
+// 按照 uxPriority 将 uxReadyPriorities(uint32_t) 的某一位清零
+#define portRESET_READY_PRIORITY(uxPriority, uxReadyPriorities) \
+    (uxReadyPriorities) &= ~(1UL << (uxPriority))
+// CLZ 指令寻找最高优先级
+#define portGET_HIGHEST_PRIORITY(uxTopPriority, uxReadyPriorities) \
+    (uxTopPriority) = (31UL - (uint32_t)__builtin_clz((uxReadyPriorities)))
+/******************************************************************************/
+#endif // _PORTMACRO_H_
@@ -0,0 +1,38 @@
+#ifndef _SECURE_CONTEXT_H_
+#define _SECURE_CONTEXT_H_
+
+#include "stdint.h"
+
+// 安全侧为非安全内核提供的安全上下文接口, 由安全侧镜像以非安全可调用(NSC)函数的形式实现,
+// 例如 __attribute__((cmse_nonsecure_entry)), 非安全侧只持有句柄, 安全栈的内存由安全侧管理
+
+// 安全上下文句柄, 0 表示任务没有安全上下文
+typedef uint32_t SecureContextHandle_t;
+#define portNO_SECURE_CONTEXT ((SecureContextHandle_t)0)
+
+/**
+ * @brief 为调用者分配安全栈并将其设为当前安全上下文
+ * @param uint32_t ulSecureStackSize: 安全栈大小, 单位为字节
+ * @returns SecureContextHandle_t: 安全上下文句柄, 分配失败返回 portNO_SECURE_CONTEXT
+ */
+SecureContextHandle_t xSecureContextAllocate(uint32_t ulSecureStackSize);
+
+/**
+ * @brief 释放安全上下文
+ * @param SecureContextHandle_t xHandle: 安全上下文句柄
+ */
+void vSecureContextFree(SecureContextHandle_t xHandle);
+
+/**
+ * @brief 任务切换出去时, 保存其安全栈指针 PSP_S
+ * @param SecureContextHandle_t xHandle: 安全上下文句柄
+ */
+void vSecureContextSave(SecureContextHandle_t xHandle);
+
+/**
+ * @brief 任务切换进来时, 恢复其安全栈指针 PSP_S 和安全栈限制 PSPLIM_S
+ * @param SecureContextHandle_t xHandle: 安全上下文句柄
+ */
+void vSecureContextLoad(SecureContextHandle_t xHandle);
+
+#endif // _SECURE_CONTEXT_H_
@@ -0,0 +1,466 @@
+#define _GNU_SOURCE
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/time.h>
+#include <time.h>
+#include <ucontext.h>
+
+#include "portmacro.h"
+#include "projectdefs.h"
+#include "rtos_config.h"
+#include "task.h"
+
+// 临界段嵌套计数器, 默认初始化为 0xaaaaaaaa, 在调度器启动时会被重新初始化为 0
+static uint32_t uxCriticalNesting = 0xaaaaaaaa;
+
+extern TCB_t *pxCurrentTCB;
+extern List_t pxReadyTasksLists[configMAX_PRIORITIES];
+
+/******************************************************************************/
+// 任务协程上下文, 指针保存在任务栈的栈顶, TCB 的 pxTopOfStack 指向该位置
+typedef struct xPORT_CONTEXT PortContext_t;
+struct xPORT_CONTEXT
+{
+    // 协程寄存器现场和信号屏蔽字
+    ucontext_t xContext;
+    // 任务入口和形参
+    TaskFuntion_t pxCode;
+    void *pvParameters;
+    // 在任务栈中保存本上下文指针的位置, 为 NULL 时上下文空闲
+    StackType_t *pxSlot;
+    // 空闲链表
+    PortContext_t *pxNextFree;
+};
+
+// 上下文池和宿主栈, 预先分配, 上下文切换可能发生在信号处理函数中, 不能调用 malloc()
+static PortContext_t xContextPool[portPOSIX_MAX_CONTEXTS];
+static uint8_t ucHostStacks[portPOSIX_MAX_CONTEXTS][portPOSIX_STACK_SIZE] __attribute__((aligned(16)));
+static PortContext_t *pxFreeContexts = NULL;
+static BaseType_t xContextPoolInitialised = pdFALSE;
+
+// 正在运行的上下文
+static PortContext_t *pxRunningContext = NULL;
+// 已经结束但仍在其宿主栈上运行的上下文, 切换出去之后再回收
+static PortContext_t *pxRetiredContext = NULL;
+
+// 任务上下文中 SIGALRM 是否被屏蔽, 即 BASEPRI 是否非 0
+static volatile BaseType_t xInterruptsMasked = pdFALSE;
+// 是否正在执行时基中断
+static volatile BaseType_t xInTickHandler = pdFALSE;
+// 挂起的上下文切换请求, 相当于 PendSV 的悬起位
+static volatile BaseType_t xYieldPending = pdFALSE;
+
+// 调用 xPortStartScheduler() 时的上下文, vPortEndScheduler() 切换回这里
+static ucontext_t xSchedulerContext;
+/******************************************************************************/
+
+/******************************************************************************/
+/**
+ * @brief 私有函数, 屏蔽或解除屏蔽时基信号
+ * @param int iHow: SIG_BLOCK 或 SIG_UNBLOCK
+ */
+static void prvSetTickSignalMask(int iHow)
+{
+    sigset_t xSignals;
+
+    sigemptyset(&xSignals);
+    sigaddset(&xSignals, SIGALRM);
+    (void)sigprocmask(iHow, &xSignals, NULL);
+}
+
+/**
+ * @brief 私有函数, 回收上下文, 放回空闲链表
+ * @param PortContext_t *pxContext
+ */
+static void prvFreeContext(PortContext_t *pxContext)
+{
+    pxContext->pxSlot = NULL;
+    pxContext->pxNextFree = pxFreeContexts;
+    pxFreeContexts = pxContext;
+}
+
+/**
+ * @brief 私有函数, 切换到新的上下文之后回收上一个已结束的上下文
+ */
+static void prvFreeRetiredContext(void)
+{
+    if (pxRetiredContext != NULL)
+    {
+        prvFreeContext(pxRetiredContext);
+        pxRetiredContext = NULL;
+    }
+}
+
+/**
+ * @brief 私有函数, 任务栈上同一位置要建立新的栈帧时, 原来的上下文必然已经结束
+ *        (扩展任务只初始化一次, 基本任务在共享栈上按后进先出重建栈帧), 将其回收
+ * @param StackType_t *pxSlot: 新栈帧的位置
+ */
+static void prvRetireContextAt(StackType_t *pxSlot)
+{
+    UBaseType_t uxIndex = 0U;
+
+    for (uxIndex = 0U; uxIndex < (UBaseType_t)portPOSIX_MAX_CONTEXTS; uxIndex++)
+    {
+        if (xContextPool[uxIndex].pxSlot == pxSlot)
+        {
+            if (&(xContextPool[uxIndex]) == pxRunningContext)
+            {
+                // 还在这个上下文的宿主栈上运行, 切换出去之后再回收
+                xContextPool[uxIndex].pxSlot = NULL;
+                pxRetiredContext = &(xContextPool[uxIndex]);
+            }
+            else
+            {
+                prvFreeContext(&(xContextPool[uxIndex]));
+            }
+        }
+    }
+}
+
+#if (configUSE_VIRTUAL_TIME == 1)
+/**
+ * @brief 私有函数, 虚拟时间模式下跳过没有事件的 tick, 然后像时基中断一样处理下一个 tick.
+ *        没有任何定时事件时所有任务都在无限期等待, 模拟结束
+ */
+static void prvAdvanceVirtualTime(void)
+{
+    const TickType_t xTicks = xTaskGetTicksToNextEvent();
+
+    if (xTicks == (TickType_t)0U)
+    {
+        vPortEndScheduler();
+    }
+
+    vTaskStepTick(xTicks - (TickType_t)1U);
+
+    xInTickHandler = pdTRUE;
+    xTaskIncrementTick();
+    xInTickHandler = pdFALSE;
+
+    // 调用者紧接着重新选择任务, 不需要再挂起切换请求
+    xYieldPending = pdFALSE;
+}
+#endif
+
+/**
+ * @brief 私有函数, 执行上下文切换, 调用时 SIGALRM 已被屏蔽, 相当于 PendSV 中断服务函数
+ */
+static void prvSwitchContext(void)
+{
+    PortContext_t *const pxPreviousContext = pxRunningContext;
+
+    xYieldPending = pdFALSE;
+
+    vTaskSwitchContext();
+
+#if (configUSE_VIRTUAL_TIME == 1)
+    // 只剩空闲任务可以运行, 即所有任务都已阻塞, 直接推进到下一个定时事件
+    while ((pxCurrentTCB == (TCB_t *)xTaskGetIdleTaskHandle()) &&
+           (listCURRENT_LIST_LENGTH(&(pxReadyTasksLists[tskIDLE_PRIORITY])) == (UBaseType_t)1U))
+    {
+        prvAdvanceVirtualTime();
+        vTaskSwitchContext();
+    }
+#endif
+
+    pxRunningContext = (PortContext_t *)(*(pxCurrentTCB->pxTopOfStack));
+    if (pxRunningContext != pxPreviousContext)
+    {
+        (void)swapcontext(&(pxPreviousContext->xContext), &(pxRunningContext->xContext));
+
+        // 重新切换回本上下文, 此时可以回收上一个上下文
+        prvFreeRetiredContext();
+    }
+}
+/******************************************************************************/
+
+/******************************************************************************/
+#if (configUSE_VIRTUAL_TIME == 0)
+/**
+ * @brief 时基信号处理函数, 相当于 SysTick 中断服务函数, 执行期间 SIGALRM 由内核自动屏蔽
+ * @param int iSignal
+ */
+static void prvTickSignalHandler(int iSignal)
+{
+    (void)iSignal;
+
+    traceISR_ENTER(traceIRQ_SYSTICK);
+
+    xInTickHandler = pdTRUE;
+    xTaskIncrementTick();
+    xInTickHandler = pdFALSE;
+
+    traceISR_EXIT(traceIRQ_SYSTICK);
+
+    // 中断返回后执行悬起的 PendSV
+    if (xYieldPending != pdFALSE)
+    {
+        prvSwitchContext();
+    }
+
+    // 本上下文被时基中断打断时一定没有关中断, 信号处理函数返回后 SIGALRM 自动解除屏蔽
+    xInterruptsMasked = pdFALSE;
+}
+#endif
+
+/**
+ * @brief 时基初始化, 用 ITIMER_REAL 定时器周期性产生 SIGALRM. 虚拟时间模式下不使用真实时钟
+ */
+void vPortSetupTimerInterrupt(void)
+{
+#if (configUSE_VIRTUAL_TIME == 0)
+    struct sigaction xAction;
+    struct itimerval xTimer;
+
+    xAction.sa_handler = prvTickSignalHandler;
+    sigemptyset(&(xAction.sa_mask));
+    // 被打断的系统调用自动重启
+    xAction.sa_flags = SA_RESTART;
+    (void)sigaction(SIGALRM, &xAction, NULL);
+
+    xTimer.it_interval.tv_sec = 0;
+    xTimer.it_interval.tv_usec = 1000000L / configTICK_RATE_HZ;
+    xTimer.it_value = xTimer.it_interval;
+    (void)setitimer(ITIMER_REAL, &xTimer, NULL);
+#endif
+}
+/******************************************************************************/
+
+/******************************************************************************/
+/**
+ * @brief 读取周期计数器, 用宿主机单调时钟代替, 虚拟时间模式下同样反映真实的执行时间
+ * @returns uint32_t: 纳秒数, 32 位回绕
+ */
+uint32_t ulPortGetCycleCount(void)
+{
+    struct timespec xNow;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &xNow);
+
+    return (uint32_t)(((uint64_t)xNow.tv_sec * 1000000000ULL) + (uint64_t)xNow.tv_nsec);
+}
+/******************************************************************************/
+
+/******************************************************************************/
+/**
+ * @brief 异常发生之后, 任务函数最终进入的函数
+ */
+static void prvTaskExitError(void)
+{
+    fprintf(stderr, "task returned from its entry function\n");
+    abort();
+}
+
+/**
+ * @brief 所有任务协程的入口, 相当于从 SVC/PendSV 返回到任务
+ */
+static void prvContextEntry(void)
+{
+    PortContext_t *const pxContext = pxRunningContext;
+
+    prvFreeRetiredContext();
+
+    // 异常返回前 BASEPRI 清零, 打开所有中断
+    xInterruptsMasked = pdFALSE;
+    prvSetTickSignalMask(SIG_UNBLOCK);
+
+    pxContext->pxCode(pxContext->pvParameters);
+
+    prvTaskExitError();
+}
+
+/**
+ * @brief 任务栈初始化, 从上下文池中分配一个协程上下文, 将其指针保存在栈顶
+ * @param StackType_t *pxTopOfStack: 栈顶
+ * @param TaskFuntion_t pxCode: 任务入口
+ * @param void *pvParameters: 任务形参
+ * @returns StackType_t pxTopOfStack: 指向保存上下文指针的位置
+ */
+StackType_t *pxPortInitialiseStack(StackType_t *pxTopOfStack,
+                                   TaskFuntion_t pxCode,
+                                   void *pvParameters)
+{
+    PortContext_t *pxContext = NULL;
+    UBaseType_t uxIndex = 0U;
+
+    if (xContextPoolInitialised == pdFALSE)
+    {
+        for (uxIndex = 0U; uxIndex < (UBaseType_t)portPOSIX_MAX_CONTEXTS; uxIndex++)
+        {
+            prvFreeContext(&(xContextPool[uxIndex]));
+        }
+        xContextPoolInitialised = pdTRUE;
+    }
+
+    prvRetireContextAt(pxTopOfStack);
+
+    // 上下文不足, 增大 portPOSIX_MAX_CONTEXTS
+    pxContext = pxFreeContexts;
+    configASSERT(pxContext != NULL);
+    if (pxContext == NULL)
+    {
+        abort();
+    }
+    pxFreeContexts = pxContext->pxNextFree;
+
+    (void)getcontext(&(pxContext->xContext));
+    pxContext->xContext.uc_stack.ss_sp = ucHostStacks[pxContext - xContextPool];
+    pxContext->xContext.uc_stack.ss_size = portPOSIX_STACK_SIZE;
+    pxContext->xContext.uc_link = NULL;
+    // 切入新上下文时 SIGALRM 保持屏蔽, 由 prvContextEntry() 打开
+    sigemptyset(&(pxContext->xContext.uc_sigmask));
+    sigaddset(&(pxContext->xContext.uc_sigmask), SIGALRM);
+    makecontext(&(pxContext->xContext), prvContextEntry, 0);
+
+    pxContext->pxCode = pxCode;
+    pxContext->pvParameters = pvParameters;
+    pxContext->pxSlot = pxTopOfStack;
+    *pxTopOfStack = (StackType_t)pxContext;
+
+    return pxTopOfStack;
+}
+
+/**
+ * @brief 启动调度器, 切换到 pxCurrentTCB 指向的第一个任务
+ * @returns BaseType_t 0: 不应该有返回值
+ */
+BaseType_t xPortStartScheduler(void)
+{
+    prvSetTickSignalMask(SIG_BLOCK);
+    xInterruptsMasked = pdTRUE;
+
+    uxCriticalNesting = 0;
+
+    // 初始化时基
+    vPortSetupTimerInterrupt();
+
+    // 启动第一个任务, 调用 vPortEndScheduler() 后才返回
+    pxRunningContext = (PortContext_t *)(*(pxCurrentTCB->pxTopOfStack));
+    (void)swapcontext(&xSchedulerContext, &(pxRunningContext->xContext));
+
+    return 0;
+}
+
+/**
+ * @brief 停止调度器, 回到调用 vTaskStartScheduler() 的地方继续执行, 用于模拟结束后检查结果
+ */
+void vPortEndScheduler(void)
+{
+    const struct itimerval xTimer = {{0, 0}, {0, 0}};
+
+    prvSetTickSignalMask(SIG_BLOCK);
+    (void)setitimer(ITIMER_REAL, &xTimer, NULL);
+
+    pxRunningContext = NULL;
+    xInTickHandler = pdFALSE;
+    xInterruptsMasked = pdFALSE;
+    (void)setcontext(&xSchedulerContext);
+}
+/******************************************************************************/
+
+/******************************************************************************/
+/**
+ * @brief 请求上下文切换. 关中断期间或在时基中断中只挂起请求, 开中断时再执行
+ */
+void vPortYield(void)
+{
+    // 调度器启动前同样只挂起请求
+    if ((xInTickHandler != pdFALSE) || (xInterruptsMasked != pdFALSE) || (pxRunningContext == NULL))
+    {
+        xYieldPending = pdTRUE;
+        return;
+    }
+
+    prvSetTickSignalMask(SIG_BLOCK);
+    xInterruptsMasked = pdTRUE;
+
+    prvSwitchContext();
+
+    xInterruptsMasked = pdFALSE;
+    prvSetTickSignalMask(SIG_UNBLOCK);
+}
+
+/**
+ * @brief 关中断, 屏蔽 SIGALRM, 在时基中断中调用时无操作
+ */
+void vPortDisableInterrupts(void)
+{
+    if ((xInTickHandler == pdFALSE) && (xInterruptsMasked == pdFALSE))
+    {
+        // 先屏蔽信号再置位标志, 标志置位时信号一定已被屏蔽
+        prvSetTickSignalMask(SIG_BLOCK);
+        xInterruptsMasked = pdTRUE;
+    }
+}
+
+/**
+ * @brief 开中断, 先执行关中断期间挂起的上下文切换, 再解除 SIGALRM 屏蔽, 在时基中断中调用时无操作
+ */
+void vPortEnableInterrupts(void)
+{
+    if ((xInTickHandler == pdFALSE) && (xInterruptsMasked != pdFALSE))
+    {
+        if ((xYieldPending != pdFALSE) && (pxRunningContext != NULL))
+        {
+            prvSwitchContext();
+        }
+
+        xInterruptsMasked = pdFALSE;
+        prvSetTickSignalMask(SIG_UNBLOCK);
+    }
+}
+
+/**
+ * @brief 带返回值的关中断函数, 可以嵌套, 可以在中断里面使用
+ * @returns uint32_t: 关中断前是否已经关中断
+ */
+uint32_t ulPortSetInterruptMask(void)
+{
+    const uint32_t ulMask = ((xInTickHandler != pdFALSE) || (xInterruptsMasked != pdFALSE)) ? 1UL : 0UL;
+
+    vPortDisableInterrupts();
+
+    return ulMask;
+}
+
+/**
+ * @brief 开中断函数, 与 ulPortSetInterruptMask() 成对使用
+ * @param uint32_t ulMask: ulPortSetInterruptMask() 的返回值
+ */
+void vPortClearInterruptMask(uint32_t ulMask)
+{
+    if (ulMask == 0UL)
+    {
+        vPortEnableInterrupts();
+    }
+}
+/******************************************************************************/
+
+/******************************************************************************/
+/**
+ * @brief 进入临界段, 无中断保护
+ */
+void vPortEnterCritical(void)
+{
+    portDISABLE_INTERRUPTS();
+    uxCriticalNesting++;
+
+    // 如果 uxCriticalNesting 等于 1, 即一层嵌套, 要确保当前不在中断中
+    if (uxCriticalNesting == 1)
+        configASSERT(xInTickHandler == pdFALSE);
+}
+
+/**
+ * @brief 退出临界段, 无中断保护
+ */
+void vPortExitCritical(void)
+{
+    configASSERT(uxCriticalNesting);
+    uxCriticalNesting--;
+
+    if (uxCriticalNesting == 0)
+        portENABLE_INTERRUPTS();
+}
+/******************************************************************************/
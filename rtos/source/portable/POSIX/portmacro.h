@@ -0,0 +1,130 @@
+#ifndef _PORTMACRO_H_
+#define _PORTMACRO_H_
+
+#include "stdint.h"
+#include "stddef.h"
+#include "projectdefs.h"
+#include "rtos_config.h"
+
+// POSIX 模拟器移植, 内核作为一个普通的 Linux 进程运行:
+// 每个任务是一个 ucontext 协程, 所有任务运行在同一个线程中, 同一时刻只有一个任务在运行;
+// SIGALRM 模拟 SysTick, 屏蔽 SIGALRM 模拟 BASEPRI 关中断, 挂起标志模拟 PendSV
+
+#define portCHAR char
+#define portFLOAT float
+#define portDOUBLE double
+#define portLONG long
+#define portSHORT short
+
+// 与指针等宽, 任务栈中保存的是协程上下文的指针
+#define portSTACK_TYPE uintptr_t
+typedef portSTACK_TYPE StackType_t;
+
+#define portBASE_TYPE long
+typedef long BaseType_t;
+typedef unsigned long UBaseType_t;
+
+// 与指针等宽的整数类型, 用于对指针做位运算
+#define portPOINTER_SIZE_TYPE uintptr_t
+
+#if (configUSE_16_BIT_TICKS == 1)
+typedef uint16_t TickType_t;
+#define portMAX_DELAY (TickType_t)0xffff
+#else
+typedef uint32_t TickType_t;
+#define portMAX_DELAY (TickType_t)0xffffffffUL
+#endif
+
+// 每个任务协程实际使用的宿主栈大小, 单位为字节, 与任务创建时给出的任务栈大小无关
+#ifndef portPOSIX_STACK_SIZE
+#define portPOSIX_STACK_SIZE (64U * 1024U)
+#endif
+// 同时存在的协程上下文数量上限: 扩展任务各占一个, 共享栈上每层嵌套的基本任务各占一个
+#ifndef portPOSIX_MAX_CONTEXTS
+#define portPOSIX_MAX_CONTEXTS 32
+#endif
+
+/******************************************************************************/
+
+StackType_t *pxPortInitialiseStack(StackType_t *pxTopOfStack,
+                                   TaskFuntion_t pxCode,
+                                   void *pvParameters);
+BaseType_t xPortStartScheduler(void);
+void vPortEndScheduler(void);
+/******************************************************************************/
+
+/******************************************************************************/
+void vPortYield(void);
+// 触发上下文切换, 中断屏蔽期间与 PendSV 一样挂起, 开中断时再执行
+#define portYIELD() vPortYield()
+
+// 编译器及处理器内存屏障, 保证屏障前后的内存访问不被重排, 用于无锁数据结构
+#define portMEMORY_BARRIER() __sync_synchronize()
+/******************************************************************************/
+
+/******************************************************************************/
+// 周期计数器, 用于基准测试和运行时间统计: 宿主机单调时钟, 单位为纳秒, 32 位回绕, 两次读数相减即为间隔
+uint32_t ulPortGetCycleCount(void);
+#define portGET_CYCLE_COUNT() ulPortGetCycleCount()
+#define portCYCLE_COUNTER_HZ (1000000000UL)
+
+// 结束调度器, vTaskStartScheduler() 随即返回, 用于基准测试等一次性运行的程序
+#define portEND_SCHEDULER() vPortEndScheduler()
+/******************************************************************************/
+
+/******************************************************************************/
+// 临界段保护, 用于保护全局变量操作或者其他不能被打断的过程
+#ifndef portFORCE_INLINE
+#define portFORCE_INLINE inline __attribute__((always_inline))
+#endif
+
+#ifndef portDONT_DISCARD
+#define portDONT_DISCARD __attribute__((used))
+#endif
+
+// 无中断保护关中断, 开中断, 进临界段, 出临界段
+void vPortDisableInterrupts(void);
+void vPortEnableInterrupts(void);
+#define portDISABLE_INTERRUPTS() vPortDisableInterrupts()
+void vPortEnterCritical(void);
+#define portENTER_CRITICAL() vPortEnterCritical()
+#define portENABLE_INTERRUPTS() vPortEnableInterrupts()
+void vPortExitCritical(void);
+#define portEXIT_CRITICAL() vPortExitCritical()
+
+// 有中断保护关中断, 开中断, 进临界段, 出临界段
+// 返回值为关中断前 SIGALRM 是否已被屏蔽, 作为形参传入开中断函数
+uint32_t ulPortSetInterruptMask(void);
+void vPortClearInterruptMask(uint32_t ulMask);
+#define portSET_INTERRUPT_MASK_FROM_ISR() ulPortSetInterruptMask()
+#define portCLEAR_INTERRUPT_MASK_FROM_ISR(x) vPortClearInterruptMask(x)
+/******************************************************************************/
+
+/******************************************************************************/
+/**
+ * @brief 原子比较并交换
+ * @param volatile uint32_t *pulDestination: 目标地址
+ * @param uint32_t ulExchange: *pulDestination 等于 ulComparand 时写入的新值
+ * @param uint32_t ulComparand: 期望的旧值
+ * @returns BaseType_t: pdTRUE 交换成功, pdFALSE *pulDestination 不等于 ulComparand
+ */
+static portFORCE_INLINE BaseType_t xPortCompareAndSwap(volatile uint32_t *pulDestination,
+                                                      uint32_t ulExchange,
+                                                      uint32_t ulComparand)
+{
+    return __sync_bool_compare_and_swap(pulDestination, ulComparand, ulExchange) ? pdTRUE : pdFALSE;
+}
+/******************************************************************************/
+
+/******************************************************************************/
+// 将 uxPriority 标记到 uxReadyPriorities 的某一位上
+#define portRECORD_READY_PRIORITY(uxPriority, uxReadyPriorities) \
+    (uxReadyPriorities) |= (1UL << (uxPriority))
+// 按照 uxPriority 将 uxReadyPriorities 的某一位清零
+#define portRESET_READY_PRIORITY(uxPriority, uxReadyPriorities) \
+    (uxReadyPriorities) &= ~(1UL << (uxPriority))
+// 最高优先级寻找, 优先级不超过 32 个
+#define portGET_HIGHEST_PRIORITY(uxTopPriority, uxReadyPriorities) \
+    (uxTopPriority) = (31UL - (uint32_t)__builtin_clz((uint32_t)(uxReadyPriorities)))
+/******************************************************************************/
+#endif // _PORTMACRO_H_
@@ -40,88 +40,6 @@ void vPortSetupTimerInterrupt(void)
                                  portNVIC_SYSTICK_ENABLE_BIT);
 }
 
-// 系统时基计时器
-TickType_t xTickCount = 0;
-
-extern TickType_t xNextTaskUnblockTime;
-extern List_t *pxDelayedTaskList;
-extern List_t *pxOverflowDelayedTaskList;
-
-/**
- * @brief 更新系统时基
- */
-void xTaskIncrementTick(void)
-{
-    TCB_t *pxTCB = NULL;
-    // BaseType_t i = 0;
-    TickType_t xItemValue = 0;
-
-    const TickType_t xConstTickCount = xTickCount + 1;
-    xTickCount = xConstTickCount;
-
-#if 0
-    // ??扫描就绪列表中每个链表中第一个任务的 xTicksToDelay, 如果不为 0, 则减 1
-    for (i = 0; i < configMAX_PRIORITIES; i++)
-    {
-        pxTCB = (TCB_t *)listGET_OWNER_OF_HEAD_ENTRY(&(pxReadyTasksLists[i]));
-        if (listLIST_IS_EMPTY(&(pxReadyTasksLists[i])))
-            continue;
-        if (pxTCB->xTicksToDelay > 0)
-        {
-            pxTCB->xTicksToDelay--;
-
-            // 延时时间到, 将任务就绪
-            if(pxTCB->xTicksToDelay == 0)
-            {
-                taskRECORD_READY_PRIORITY(pxTCB->uxPriority);
-            }
-        }
-    }
-#else
-
-    if(xConstTickCount == (TickType_t)0U)
-    {
-        // 如果系统时基计数器 xTickCount 溢出，则切换延时列表
-        taskSWITCH_DELAYED_LISTS();
-    }
-
-    // 有任务延时到期
-    if(xConstTickCount >= xNextTaskUnblockTime)
-    {
-        for(;;)
-        {
-            if(listLIST_IS_EMPTY(pxDelayedTaskList) != pdFALSE)
-            {
-                // 延时列表为空
-                xNextTaskUnblockTime = portMAX_DELAY;
-                break;
-            }
-            else
-            {
-                pxTCB = (TCB_t *)listGET_OWNER_OF_HEAD_ENTRY(pxDelayedTaskList);
-                xItemValue = listGET_LIST_ITEM_VALUE(pxTCB);
-
-                // 直到将延时列表中所有延时到期的任务移除才跳出 for 循环
-                if(xConstTickCount < xItemValue)
-                {
-                    xNextTaskUnblockTime = xItemValue;
-                    break;
-                }
-
-                // 将任务从延时列表移除, 消除等待状态
-                (void)uxListRemove(&(pxTCB->xStateListItem));
-
-                // 将解除等待的任务添加到就绪列表
-                prvAddTaskToReadyList(pxTCB);
-            }
-        }
-    }
-
-#endif
-
-    portYIELD();
-}
-
 // 按照startup中的向量表重新定义函数的名字
 #define xPortSysTickHandler SysTick_Handler
 
@@ -131,6 +49,8 @@ void xTaskIncrementTick(void)
 void xPortSysTickHandler(void)
 // void SysTick_Handler(void)
 {
+    traceISR_ENTER(traceIRQ_SYSTICK);
+
     // vPortRaiseBASEPRI();
     portDISABLE_INTERRUPTS();
 
@@ -139,6 +59,26 @@ void xPortSysTickHandler(void)
     // portENABLE_INTERRUPTS()
     // vPortClearBASEPRIFromISR();
     portENABLE_INTERRUPTS();
+
+    traceISR_EXIT(traceIRQ_SYSTICK);
+}
+/******************************************************************************/
+
+/******************************************************************************/
+// 调试异常和监视控制寄存器 DEMCR, Bit 24 TRCENA: 使能 DWT 和 ITM
+#define portDEMCR_REG (*((volatile uint32_t *)0xE000EDFC))
+#define portDEMCR_TRCENA_BIT (1UL << 24UL)
+// DWT 控制寄存器, Bit 0 CYCCNTENA: 使能周期计数器
+#define portDWT_CTRL_REG (*((volatile uint32_t *)0xE0001000))
+#define portDWT_CYCCNTENA_BIT (1UL << 0UL)
+
+/**
+ * @brief 使能 DWT 周期计数器. 不清零计数值, 调度器启动前的读数(运行时间统计的起点)与之后的读数相减仍然正确
+ */
+static void prvInitCycleCounter(void)
+{
+    portDEMCR_REG |= portDEMCR_TRCENA_BIT;
+    portDWT_CTRL_REG |= portDWT_CYCCNTENA_BIT;
 }
 /******************************************************************************/
 
@@ -347,6 +287,9 @@ BaseType_t xPortStartScheduler(void)
     // 初始化 SysTick
     vPortSetupTimerInterrupt();
 
+    // 使能周期计数器
+    prvInitCycleCounter();
+
     // 启动第一个任务, 不再返回
     prvStartFirstTask();
 
@@ -385,6 +328,11 @@ __asm void vPortSVCHandler(void)
 
 /**
  * @brief PendSV call back, 实现任务切换
+ *
+ * 快速路径: 时基中断和空闲任务的 portYIELD() 经常选回同一个任务, 此时不保存也不恢复 r4~r11, 不更新 PSP.
+ * 调用 vTaskSwitchContext() 之前只把预留 r4~r11 空间后的栈顶写入 pxTopOfStack,
+ * 基本任务在共享栈上的栈帧位置依赖这个值; r4~r11 是被调用者保存寄存器, 调用之后仍是上文的值, 确定切换后再保存.
+ * 同一任务的栈帧可能在 vTaskSwitchContext() 中被重建(基本任务结束后又被激活), 因此还要比较 pxTopOfStack
  */
 __asm void xPortPendSVHandler(void)
 {
@@ -400,11 +348,10 @@ __asm void xPortPendSVHandler(void)
     ldr r3, =pxCurrentTCB /* 上文TCB */
     ldr r2, [r3]
 
-    stmdb r0!, {r4-r11} /* 将 CPU 寄存器 r4~r11 的值存储到任务栈, 同时更新 r0 的值, R0此时指向栈中代表 R4 的位置 */
-    str r0, [r2] /* 将 r0 的值存储到上一个任务的栈顶指针 pxTopOfStack */
-    /* 上文保存完成 */
+    sub r0, r0, #32 /* 在任务栈中为 r4~r11 预留空间, R0此时指向栈中代表 R4 的位置 */
+    str r0, [r2] /* 将 r0 的值存储到上一个任务的栈顶指针 pxTopOfStack, r4~r11 暂不写入 */
 
-    stmdb sp!, {r3, r14} /* 将 R3 和 R14(在整个系统中, 中断使用的是主堆栈, 栈指针使用的是 MSP) 临时压入主堆栈, 入栈保护 */
+    stmdb sp!, {r0, r2, r3, r14} /* 将 R0(上文栈顶), R2(上文TCB), R3 和 R14(在整个系统中, 中断使用的是主堆栈, 栈指针使用的是 MSP) 临时压入主堆栈, 入栈保护 */
 
     mov r0, #configMAX_SYSCALL_INTERRUPT_PRIORITY
     msr basepri, r0 /* 关中断, 进入临界段, 因为接下来要更新全局指针 pxCurrentTCB的值 */
@@ -415,12 +362,19 @@ __asm void xPortPendSVHandler(void)
 
     mov r0, #0 /* 退出临界段, 开中断, 直接往 BASEPRI 写 0 */
     msr basepri, r0
-    ldmia sp!, {r3, r14} /* 弹出所保护的上文: R3(->TCB), R14(MSP) */
-
-    ldr r1, [r3]
-    ldr r0, [r1]
-    ldmia r0!, {r4-r11}
-    msr psp, r0
+    ldmia sp!, {r0, r2, r3, r14} /* 弹出所保护的上文: R0(上文栈顶), R2(上文TCB), R3(->TCB), R14(MSP) */
+
+    ldr r1, [r3] /* 下文TCB */
+    ldr r12, [r1] /* 下文栈顶 */
+    cmp r1, r2
+    it eq
+    cmpeq r12, r0
+    it eq
+    bxeq r14 /* 下文就是上文且栈帧没有重建: r4~r11 仍在寄存器中, PSP 不变, 直接返回 */
+
+    stmia r0, {r4-r11} /* 确定切换, 将上文的 r4~r11 写入预留的空间 */
+    ldmia r12!, {r4-r11}
+    msr psp, r12
     isb
     bx r14
     nop
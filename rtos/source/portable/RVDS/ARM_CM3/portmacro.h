@@ -28,6 +28,9 @@ typedef portSTACK_TYPE StackType_t;
 typedef long BaseType_t;
 typedef unsigned long UBaseType_t;
 
+// 与指针等宽的整数类型, 用于对指针做位运算
+#define portPOINTER_SIZE_TYPE uint32_t
+
 #if (configUSE_16_BIT_TICKS == 1)
 typedef uint16_t TickType_t;
 #define portMAX_DELAY (TickType_t)0xffff
@@ -57,6 +60,18 @@ BaseType_t xPortStartScheduler(void);
         __dsb(portSY_FULL_READ_WRITE);                  \
         __isb(portSY_FULL_READ_WRITE);                  \
     }
+
+// 编译器及处理器内存屏障, 保证屏障前后的内存访问不被重排, 用于无锁数据结构
+#define portMEMORY_BARRIER() __dmb(portSY_FULL_READ_WRITE)
+/******************************************************************************/
+
+/******************************************************************************/
+// 周期计数器, 用于基准测试和运行时间统计, 由 xPortStartScheduler() 使能, 32 位回绕, 两次读数相减即为间隔
+// DWT CYCCNT, 每个内核时钟周期加 1
+#define portDWT_CYCCNT_REG (*((volatile uint32_t *)0xE0001004))
+#define portGET_CYCLE_COUNT() (portDWT_CYCCNT_REG)
+// 周期计数器的频率
+#define portCYCLE_COUNTER_HZ (configCPU_CLOCK_HZ)
 /******************************************************************************/
 
 /******************************************************************************/
@@ -65,6 +80,11 @@ BaseType_t xPortStartScheduler(void);
 #define portFORCE_INLINE inline __attribute__((always_inline))
 #endif
 
+// 仅被汇编代码引用的函数和变量, 防止被链接器优化掉
+#ifndef portDONT_DISCARD
+#define portDONT_DISCARD __attribute__((used))
+#endif
+
 // 无中断保护关中断, 开中断, 进临界段, 出临界段
 // 不带返回值的关中断函数, 不能嵌套, 不能在中断里面使用
 #define portDISABLE_INTERRUPTS() vPortRaiseBASEPRI()
@@ -127,6 +147,32 @@ static portFORCE_INLINE void vPortSetBASEPRI(uint32_t ulBASEPRI)
 }
 /******************************************************************************/
 
+/******************************************************************************/
+/**
+ * @brief 原子比较并交换, 基于 LDREX/STREX 实现, 不需要关中断. 异常进入和返回时处理器会清除独占监视器,
+ *        因此被中断或任务切换打断的 STREX 会失败并重试
+ * @param volatile uint32_t *pulDestination: 目标地址
+ * @param uint32_t ulExchange: *pulDestination 等于 ulComparand 时写入的新值
+ * @param uint32_t ulComparand: 期望的旧值
+ * @returns BaseType_t: pdTRUE 交换成功, pdFALSE *pulDestination 不等于 ulComparand
+ */
+static portFORCE_INLINE BaseType_t xPortCompareAndSwap(volatile uint32_t *pulDestination,
+                                                      uint32_t ulExchange,
+                                                      uint32_t ulComparand)
+{
+    do
+    {
+        if (__ldrex(pulDestination) != ulComparand)
+        {
+            __clrex();
+            return pdFALSE;
+        }
+    } while (__strex(ulExchange, pulDestination) != 0U);
+
+    return pdTRUE;
+}
+/******************************************************************************/
+
 /******************************************************************************/
 // 将 uxPriority 标记到 uxReadyPriorities(uint32_t) 的某一位上
 #define portRECORD_READY_PRIORITY(uxPriority, uxReadyPriorities) \
@@ -0,0 +1,1190 @@
+#include <string.h>
+
+#include "queue.h"
+#include "task.h"
+#include "portmacro.h"
+#include "rtos_config.h"
+#include "projectdefs.h"
+#include "list.h"
+
+/******************************************************************************/
+#if (configUSE_MUTEXES == 1)
+// 带优先级继承的互斥量, 包括递归互斥量
+#define queueIS_INHERITANCE_MUTEX(pxQueue)                    \
+    (((pxQueue)->ucQueueType == queueQUEUE_TYPE_MUTEX) ||     \
+     ((pxQueue)->ucQueueType == queueQUEUE_TYPE_RECURSIVE_MUTEX))
+#endif
+/******************************************************************************/
+
+/******************************************************************************/
+/**
+ * @brief 私有函数, 将消息拷贝到队列中, 需在临界段内调用
+ * @param Queue_t *const pxQueue: 队列控制块
+ * @param const void *pvItemToQueue: 消息地址
+ * @param const BaseType_t xPosition: queueSEND_TO_BACK 或 queueSEND_TO_FRONT
+ * @returns BaseType_t: 释放互斥量使持有者优先级降低时返回 pdTRUE, 调用者应触发任务切换
+ */
+static BaseType_t prvCopyDataToQueue(Queue_t *const pxQueue,
+                                     const void *pvItemToQueue,
+                                     const BaseType_t xPosition)
+{
+    BaseType_t xReturn = pdFALSE;
+
+    if (pxQueue->uxItemSize == (UBaseType_t)0)
+    {
+#if (configUSE_MUTEXES == 1)
+        // 释放互斥量, 恢复持有者的优先级
+        if (queueIS_INHERITANCE_MUTEX(pxQueue))
+        {
+            xReturn = xTaskPriorityDisinherit(pxQueue->pxMutexHolder);
+            pxQueue->pxMutexHolder = NULL;
+        }
+        else if (pxQueue->ucQueueType == queueQUEUE_TYPE_CEILING_MUTEX)
+        {
+            configASSERT(pxQueue->pxMutexHolder == (void *)xTaskGetCurrentTaskHandle());
+            xReturn = xTaskPriorityCeilingRestore(&(pxQueue->xCeilingListItem));
+            pxQueue->pxMutexHolder = NULL;
+        }
+#endif
+    }
+    else
+    {
+        if (xPosition == queueSEND_TO_BACK)
+        {
+            (void)memcpy((void *)pxQueue->pcWriteTo, pvItemToQueue, (size_t)pxQueue->uxItemSize);
+            pxQueue->pcWriteTo += pxQueue->uxItemSize;
+
+            // 写到存储区末尾, 回绕到开头
+            if (pxQueue->pcWriteTo >= pxQueue->pcTail)
+            {
+                pxQueue->pcWriteTo = pxQueue->pcHead;
+            }
+        }
+        else
+        {
+            // 写到队首, 即上一次读出的位置, 下一次读出时最先读到它
+            (void)memcpy((void *)pxQueue->pcReadFrom, pvItemToQueue, (size_t)pxQueue->uxItemSize);
+            pxQueue->pcReadFrom -= pxQueue->uxItemSize;
+
+            if (pxQueue->pcReadFrom < pxQueue->pcHead)
+            {
+                pxQueue->pcReadFrom = (pxQueue->pcTail - pxQueue->uxItemSize);
+            }
+        }
+    }
+
+    pxQueue->uxMessagesWaiting++;
+
+    return xReturn;
+}
+
+/**
+ * @brief 私有函数, 从队列中读出一条消息, 需在临界段内调用
+ * @param Queue_t *const pxQueue: 队列控制块
+ * @param void *const pvBuffer: 消息拷贝到的地址
+ */
+static void prvCopyDataFromQueue(Queue_t *const pxQueue, void *const pvBuffer)
+{
+    if (pxQueue->uxItemSize != (UBaseType_t)0)
+    {
+        pxQueue->pcReadFrom += pxQueue->uxItemSize;
+
+        if (pxQueue->pcReadFrom >= pxQueue->pcTail)
+        {
+            pxQueue->pcReadFrom = pxQueue->pcHead;
+        }
+
+        (void)memcpy(pvBuffer, (void *)pxQueue->pcReadFrom, (size_t)pxQueue->uxItemSize);
+    }
+
+    pxQueue->uxMessagesWaiting--;
+}
+
+#if (configUSE_QUEUE_SETS == 1)
+/**
+ * @brief 私有函数, 成员收到消息后将成员句柄写入所属的队列集, 需在临界段内调用
+ * @param Queue_t *const pxQueue: 队列集成员
+ * @returns BaseType_t: 唤醒了比当前任务优先级更高的任务时返回 pdTRUE
+ */
+static BaseType_t prvNotifyQueueSetContainer(Queue_t *const pxQueue)
+{
+    Queue_t *const pxQueueSetContainer = pxQueue->pxQueueSetContainer;
+    BaseType_t xReturn = pdFALSE;
+
+    // 队列集长度不小于所有成员长度之和时不会写满
+    configASSERT(pxQueueSetContainer->uxMessagesWaiting < pxQueueSetContainer->uxLength);
+
+    if (pxQueueSetContainer->uxMessagesWaiting < pxQueueSetContainer->uxLength)
+    {
+        (void)prvCopyDataToQueue(pxQueueSetContainer, &pxQueue, queueSEND_TO_BACK);
+
+        if (listLIST_IS_EMPTY(&(pxQueueSetContainer->xTasksWaitingToReceive)) == pdFALSE)
+        {
+            xReturn = xTaskRemoveFromEventList(&(pxQueueSetContainer->xTasksWaitingToReceive));
+        }
+    }
+
+    return xReturn;
+}
+#endif
+
+/**
+ * @brief 静态创建队列
+ * @param const UBaseType_t uxQueueLength: 队列长度
+ * @param const UBaseType_t uxItemSize: 每条消息的大小, 单位为字节, 为 0 时队列只计数
+ * @param uint8_t *pucQueueStorage: 队列存储区, 大小至少为 uxQueueLength * uxItemSize 字节
+ * @param Queue_t *pxQueueBuffer: 队列控制块
+ * @returns QueueHandle_t: 队列句柄
+ */
+QueueHandle_t xQueueCreateStatic(const UBaseType_t uxQueueLength,
+                                 const UBaseType_t uxItemSize,
+                                 uint8_t *pucQueueStorage,
+                                 Queue_t *pxQueueBuffer)
+{
+    Queue_t *const pxNewQueue = pxQueueBuffer;
+
+    if ((pxNewQueue == NULL) ||
+        (uxQueueLength == (UBaseType_t)0) ||
+        ((uxItemSize != (UBaseType_t)0) && (pucQueueStorage == NULL)))
+    {
+        return NULL;
+    }
+
+    // 只计数的队列没有存储区, pcHead 指向控制块自身, 保证指针不为空
+    if (uxItemSize == (UBaseType_t)0)
+    {
+        pxNewQueue->pcHead = (int8_t *)pxNewQueue;
+    }
+    else
+    {
+        pxNewQueue->pcHead = (int8_t *)pucQueueStorage;
+    }
+
+    pxNewQueue->uxLength = uxQueueLength;
+    pxNewQueue->uxItemSize = uxItemSize;
+    pxNewQueue->pcTail = pxNewQueue->pcHead + (uxQueueLength * uxItemSize);
+    pxNewQueue->pcWriteTo = pxNewQueue->pcHead;
+    pxNewQueue->pcReadFrom = pxNewQueue->pcHead + ((uxQueueLength - (UBaseType_t)1U) * uxItemSize);
+    pxNewQueue->uxMessagesWaiting = (UBaseType_t)0U;
+    pxNewQueue->ucQueueType = queueQUEUE_TYPE_BASE;
+#if (configUSE_MUTEXES == 1)
+    pxNewQueue->pxMutexHolder = NULL;
+    pxNewQueue->uxCeilingPriority = tskIDLE_PRIORITY;
+    vListInitialiseItem(&(pxNewQueue->xCeilingListItem));
+    pxNewQueue->uxRecursiveCallCount = (UBaseType_t)0U;
+#endif
+#if (configUSE_QUEUE_SETS == 1)
+    pxNewQueue->pxQueueSetContainer = NULL;
+#endif
+
+    vListInitialise(&(pxNewQueue->xTasksWaitingToSend));
+    vListInitialise(&(pxNewQueue->xTasksWaitingToReceive));
+
+    return (QueueHandle_t)pxNewQueue;
+}
+/******************************************************************************/
+
+/******************************************************************************/
+/**
+ * @brief 发送消息, 队列满时阻塞等待
+ * @param QueueHandle_t xQueue: 队列句柄
+ * @param const void *const pvItemToQueue: 消息地址, 消息按值拷贝进队列
+ * @param TickType_t xTicksToWait: 队列满时最长等待时间, 0 表示不等待, portMAX_DELAY 表示无限期等待
+ * @param const BaseType_t xCopyPosition: queueSEND_TO_BACK 或 queueSEND_TO_FRONT
+ * @returns BaseType_t: pdPASS 发送成功, errQUEUE_FULL 超时
+ */
+BaseType_t xQueueGenericSend(QueueHandle_t xQueue,
+                             const void *const pvItemToQueue,
+                             TickType_t xTicksToWait,
+                             const BaseType_t xCopyPosition)
+{
+    Queue_t *const pxQueue = (Queue_t *)xQueue;
+    BaseType_t xEntryTimeSet = pdFALSE;
+    BaseType_t xYieldRequired = pdFALSE;
+    TimeOut_t xTimeOut;
+
+    for (;;)
+    {
+        taskENTER_CRITICAL();
+        {
+            if (pxQueue->uxMessagesWaiting < pxQueue->uxLength)
+            {
+                xYieldRequired = prvCopyDataToQueue(pxQueue, pvItemToQueue, xCopyPosition);
+
+#if (configUSE_QUEUE_SETS == 1)
+                // 队列集成员的消息由阻塞在队列集上的任务取走, 通知队列集代替直接唤醒
+                if (pxQueue->pxQueueSetContainer != NULL)
+                {
+                    if (prvNotifyQueueSetContainer(pxQueue) != pdFALSE)
+                    {
+                        xYieldRequired = pdTRUE;
+                    }
+                }
+                else
+#endif
+                    // 有任务在等待接收, 唤醒其中优先级最高的一个
+                    if (listLIST_IS_EMPTY(&(pxQueue->xTasksWaitingToReceive)) == pdFALSE)
+                    {
+                        if (xTaskRemoveFromEventList(&(pxQueue->xTasksWaitingToReceive)) != pdFALSE)
+                        {
+                            xYieldRequired = pdTRUE;
+                        }
+                    }
+
+                if (xYieldRequired != pdFALSE)
+                {
+                    taskYIELD();
+                }
+
+                taskEXIT_CRITICAL();
+                return pdPASS;
+            }
+
+            if (xTicksToWait == (TickType_t)0)
+            {
+                taskEXIT_CRITICAL();
+                return errQUEUE_FULL;
+            }
+
+            if (xEntryTimeSet == pdFALSE)
+            {
+                vTaskSetTimeOutState(&xTimeOut);
+                xEntryTimeSet = pdTRUE;
+            }
+            else if (xTaskCheckForTimeOut(&xTimeOut, &xTicksToWait) != pdFALSE)
+            {
+                taskEXIT_CRITICAL();
+                return errQUEUE_FULL;
+            }
+
+            // 阻塞, 退出临界段后 PendSV 立即执行任务切换, 被唤醒后重新检查队列
+            vTaskPlaceOnEventList(&(pxQueue->xTasksWaitingToSend), xTicksToWait);
+            taskYIELD();
+        }
+        taskEXIT_CRITICAL();
+    }
+}
+
+/**
+ * @brief 在中断中发送消息, 不会阻塞
+ * @param QueueHandle_t xQueue: 队列句柄
+ * @param const void *const pvItemToQueue: 消息地址
+ * @param BaseType_t *const pxHigherPriorityTaskWoken: 唤醒了更高优先级任务时置为 pdTRUE, 中断退出前应调用 portYIELD()
+ * @param const BaseType_t xCopyPosition: queueSEND_TO_BACK 或 queueSEND_TO_FRONT
+ * @returns BaseType_t: pdPASS 发送成功, errQUEUE_FULL 队列已满
+ */
+BaseType_t xQueueGenericSendFromISR(QueueHandle_t xQueue,
+                                    const void *const pvItemToQueue,
+                                    BaseType_t *const pxHigherPriorityTaskWoken,
+                                    const BaseType_t xCopyPosition)
+{
+    Queue_t *const pxQueue = (Queue_t *)xQueue;
+    BaseType_t xReturn = errQUEUE_FULL;
+    uint32_t ulSavedInterruptStatus = 0;
+
+    ulSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+    {
+        if (pxQueue->uxMessagesWaiting < pxQueue->uxLength)
+        {
+            // 互斥量不能在中断中释放, 不会涉及优先级继承
+            (void)prvCopyDataToQueue(pxQueue, pvItemToQueue, xCopyPosition);
+
+#if (configUSE_QUEUE_SETS == 1)
+            if (pxQueue->pxQueueSetContainer != NULL)
+            {
+                if ((prvNotifyQueueSetContainer(pxQueue) != pdFALSE) &&
+                    (pxHigherPriorityTaskWoken != NULL))
+                {
+                    *pxHigherPriorityTaskWoken = pdTRUE;
+                }
+            }
+            else
+#endif
+                if (listLIST_IS_EMPTY(&(pxQueue->xTasksWaitingToReceive)) == pdFALSE)
+                {
+                    if ((xTaskRemoveFromEventList(&(pxQueue->xTasksWaitingToReceive)) != pdFALSE) &&
+                        (pxHigherPriorityTaskWoken != NULL))
+                    {
+                        *pxHigherPriorityTaskWoken = pdTRUE;
+                    }
+                }
+
+            xReturn = pdPASS;
+        }
+    }
+    taskEXIT_CRITICAL_FROM_ISR(ulSavedInterruptStatus);
+
+    return xReturn;
+}
+
+/**
+ * @brief 接收消息, 队列空时阻塞等待
+ * @param QueueHandle_t xQueue: 队列句柄
+ * @param void *const pvBuffer: 消息拷贝到的地址
+ * @param TickType_t xTicksToWait: 队列空时最长等待时间, 0 表示不等待, portMAX_DELAY 表示无限期等待
+ * @returns BaseType_t: pdPASS 接收成功, errQUEUE_EMPTY 超时
+ */
+BaseType_t xQueueReceive(QueueHandle_t xQueue,
+                         void *const pvBuffer,
+                         TickType_t xTicksToWait)
+{
+    Queue_t *const pxQueue = (Queue_t *)xQueue;
+    BaseType_t xEntryTimeSet = pdFALSE;
+    TimeOut_t xTimeOut;
+
+    for (;;)
+    {
+        taskENTER_CRITICAL();
+        {
+            if (pxQueue->uxMessagesWaiting > (UBaseType_t)0)
+            {
+                prvCopyDataFromQueue(pxQueue, pvBuffer);
+
+                // 腾出了空位, 唤醒等待发送的任务中优先级最高的一个
+                if (listLIST_IS_EMPTY(&(pxQueue->xTasksWaitingToSend)) == pdFALSE)
+                {
+                    if (xTaskRemoveFromEventList(&(pxQueue->xTasksWaitingToSend)) != pdFALSE)
+                    {
+                        taskYIELD();
+                    }
+                }
+
+                taskEXIT_CRITICAL();
+                return pdPASS;
+            }
+
+            if (xTicksToWait == (TickType_t)0)
+            {
+                taskEXIT_CRITICAL();
+                return errQUEUE_EMPTY;
+            }
+
+            if (xEntryTimeSet == pdFALSE)
+            {
+                vTaskSetTimeOutState(&xTimeOut);
+                xEntryTimeSet = pdTRUE;
+            }
+            else if (xTaskCheckForTimeOut(&xTimeOut, &xTicksToWait) != pdFALSE)
+            {
+                taskEXIT_CRITICAL();
+                return errQUEUE_EMPTY;
+            }
+
+            vTaskPlaceOnEventList(&(pxQueue->xTasksWaitingToReceive), xTicksToWait);
+            taskYIELD();
+        }
+        taskEXIT_CRITICAL();
+    }
+}
+
+/**
+ * @brief 在中断中接收消息, 不会阻塞
+ * @param QueueHandle_t xQueue: 队列句柄
+ * @param void *const pvBuffer: 消息拷贝到的地址
+ * @param BaseType_t *const pxHigherPriorityTaskWoken: 唤醒了更高优先级任务时置为 pdTRUE, 中断退出前应调用 portYIELD()
+ * @returns BaseType_t: pdPASS 接收成功, errQUEUE_EMPTY 队列为空
+ */
+BaseType_t xQueueReceiveFromISR(QueueHandle_t xQueue,
+                                void *const pvBuffer,
+                                BaseType_t *const pxHigherPriorityTaskWoken)
+{
+    Queue_t *const pxQueue = (Queue_t *)xQueue;
+    BaseType_t xReturn = errQUEUE_EMPTY;
+    uint32_t ulSavedInterruptStatus = 0;
+
+    ulSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+    {
+        if (pxQueue->uxMessagesWaiting > (UBaseType_t)0)
+        {
+            prvCopyDataFromQueue(pxQueue, pvBuffer);
+
+            if (listLIST_IS_EMPTY(&(pxQueue->xTasksWaitingToSend)) == pdFALSE)
+            {
+                if ((xTaskRemoveFromEventList(&(pxQueue->xTasksWaitingToSend)) != pdFALSE) &&
+                    (pxHigherPriorityTaskWoken != NULL))
+                {
+                    *pxHigherPriorityTaskWoken = pdTRUE;
+                }
+            }
+
+            xReturn = pdPASS;
+        }
+    }
+    taskEXIT_CRITICAL_FROM_ISR(ulSavedInterruptStatus);
+
+    return xReturn;
+}
+
+/**
+ * @brief 获取队列中的消息数
+ * @param const QueueHandle_t xQueue: 队列句柄
+ * @returns UBaseType_t
+ */
+UBaseType_t uxQueueMessagesWaiting(const QueueHandle_t xQueue)
+{
+    return ((Queue_t *)xQueue)->uxMessagesWaiting;
+}
+/******************************************************************************/
+
+/******************************************************************************/
+/**
+ * @brief 私有函数, 将多条消息一次拷贝到队尾, 存储区回绕时最多拷贝两段, 需在临界段内调用
+ * @param Queue_t *const pxQueue: 队列控制块
+ * @param const int8_t *pcItems: 连续存放的消息
+ * @param const UBaseType_t uxCount: 消息数, 不超过队列剩余空间
+ */
+static void prvCopyBatchToQueue(Queue_t *const pxQueue,
+                                const int8_t *pcItems,
+                                const UBaseType_t uxCount)
+{
+    const size_t xBytes = (size_t)(uxCount * pxQueue->uxItemSize);
+    size_t xFirst = (size_t)(pxQueue->pcTail - pxQueue->pcWriteTo);
+
+    if (xBytes != (size_t)0)
+    {
+        if (xFirst > xBytes)
+        {
+            xFirst = xBytes;
+        }
+
+        (void)memcpy((void *)pxQueue->pcWriteTo, pcItems, xFirst);
+        pxQueue->pcWriteTo += xFirst;
+
+        if (xFirst < xBytes)
+        {
+            (void)memcpy((void *)pxQueue->pcHead, pcItems + xFirst, xBytes - xFirst);
+            pxQueue->pcWriteTo = pxQueue->pcHead + (xBytes - xFirst);
+        }
+
+        if (pxQueue->pcWriteTo >= pxQueue->pcTail)
+        {
+            pxQueue->pcWriteTo = pxQueue->pcHead;
+        }
+    }
+
+    pxQueue->uxMessagesWaiting += uxCount;
+}
+
+/**
+ * @brief 私有函数, 从队首一次读出多条消息, 存储区回绕时最多拷贝两段, 需在临界段内调用
+ * @param Queue_t *const pxQueue: 队列控制块
+ * @param int8_t *pcBuffer: 消息拷贝到的地址
+ * @param const UBaseType_t uxCount: 消息数, 不超过队列中的消息数
+ */
+static void prvCopyBatchFromQueue(Queue_t *const pxQueue,
+                                  int8_t *pcBuffer,
+                                  const UBaseType_t uxCount)
+{
+    const size_t xBytes = (size_t)(uxCount * pxQueue->uxItemSize);
+    int8_t *pcReadFrom = pxQueue->pcReadFrom + pxQueue->uxItemSize;
+    size_t xFirst = 0;
+
+    if (xBytes != (size_t)0)
+    {
+        // pcReadFrom 指向上一次读出的位置, 下一条消息在它之后
+        if (pcReadFrom >= pxQueue->pcTail)
+        {
+            pcReadFrom = pxQueue->pcHead;
+        }
+
+        xFirst = (size_t)(pxQueue->pcTail - pcReadFrom);
+        if (xFirst > xBytes)
+        {
+            xFirst = xBytes;
+        }
+
+        (void)memcpy(pcBuffer, (void *)pcReadFrom, xFirst);
+        pcReadFrom += xFirst;
+
+        if (xFirst < xBytes)
+        {
+            (void)memcpy(pcBuffer + xFirst, (void *)pxQueue->pcHead, xBytes - xFirst);
+            pcReadFrom = pxQueue->pcHead + (xBytes - xFirst);
+        }
+
+        pxQueue->pcReadFrom = pcReadFrom - pxQueue->uxItemSize;
+    }
+
+    pxQueue->uxMessagesWaiting -= uxCount;
+}
+
+/**
+ * @brief 私有函数, 批量发送, 拷贝尽可能多的消息, 每条消息唤醒一个等待接收的任务, 需在临界段内调用
+ * @param Queue_t *const pxQueue: 队列控制块
+ * @param const void *const pvItemsToQueue: 连续存放的消息
+ * @param const UBaseType_t uxItemCount: 消息数
+ * @param BaseType_t *const pxYieldRequired: 唤醒了更高优先级任务时置为 pdTRUE
+ * @returns UBaseType_t: 实际发送的消息数
+ */
+static UBaseType_t prvSendBatch(Queue_t *const pxQueue,
+                                const void *const pvItemsToQueue,
+                                const UBaseType_t uxItemCount,
+                                BaseType_t *const pxYieldRequired)
+{
+    UBaseType_t uxCount = pxQueue->uxLength - pxQueue->uxMessagesWaiting;
+    UBaseType_t x = 0U;
+
+    if (uxCount > uxItemCount)
+    {
+        uxCount = uxItemCount;
+    }
+
+    if (uxCount == (UBaseType_t)0)
+    {
+        return (UBaseType_t)0;
+    }
+
+    prvCopyBatchToQueue(pxQueue, (const int8_t *)pvItemsToQueue, uxCount);
+
+#if (configUSE_QUEUE_SETS == 1)
+    // 队列集中每条消息对应一个成员句柄
+    if (pxQueue->pxQueueSetContainer != NULL)
+    {
+        for (x = 0U; x < uxCount; x++)
+        {
+            if (prvNotifyQueueSetContainer(pxQueue) != pdFALSE)
+            {
+                *pxYieldRequired = pdTRUE;
+            }
+        }
+    }
+    else
+#endif
+        // 只唤醒一个接收者时, 它取走一条消息后其余消息留在队列中, 其他接收者却一直阻塞
+        for (x = 0U; (x < uxCount) && (listLIST_IS_EMPTY(&(pxQueue->xTasksWaitingToReceive)) == pdFALSE); x++)
+        {
+            if (xTaskRemoveFromEventList(&(pxQueue->xTasksWaitingToReceive)) != pdFALSE)
+            {
+                *pxYieldRequired = pdTRUE;
+            }
+        }
+
+    return uxCount;
+}
+
+/**
+ * @brief 私有函数, 批量接收, 读出尽可能多的消息, 每腾出一个空位唤醒一个等待发送的任务, 需在临界段内调用
+ * @param Queue_t *const pxQueue: 队列控制块
+ * @param void *const pvBuffer: 消息拷贝到的地址
+ * @param const UBaseType_t uxMaxItems: 最多读出的消息数
+ * @param BaseType_t *const pxYieldRequired: 唤醒了更高优先级任务时置为 pdTRUE
+ * @returns UBaseType_t: 实际接收的消息数
+ */
+static UBaseType_t prvReceiveBatch(Queue_t *const pxQueue,
+                                   void *const pvBuffer,
+                                   const UBaseType_t uxMaxItems,
+                                   BaseType_t *const pxYieldRequired)
+{
+    UBaseType_t uxCount = pxQueue->uxMessagesWaiting;
+    UBaseType_t x = 0U;
+
+    if (uxCount > uxMaxItems)
+    {
+        uxCount = uxMaxItems;
+    }
+
+    if (uxCount == (UBaseType_t)0)
+    {
+        return (UBaseType_t)0;
+    }
+
+    prvCopyBatchFromQueue(pxQueue, (int8_t *)pvBuffer, uxCount);
+
+    for (x = 0U; (x < uxCount) && (listLIST_IS_EMPTY(&(pxQueue->xTasksWaitingToSend)) == pdFALSE); x++)
+    {
+        if (xTaskRemoveFromEventList(&(pxQueue->xTasksWaitingToSend)) != pdFALSE)
+        {
+            *pxYieldRequired = pdTRUE;
+        }
+    }
+
+    return uxCount;
+}
+
+/**
+ * @brief 批量发送消息, 在一个临界段内拷贝尽可能多的消息, 队列满时阻塞等待空位
+ * @param QueueHandle_t xQueue: 队列句柄, 不能是互斥量
+ * @param const void *const pvItemsToQueue: 连续存放的消息
+ * @param const UBaseType_t uxItemCount: 消息数
+ * @param TickType_t xTicksToWait: 队列满时最长等待时间, 0 表示不等待, portMAX_DELAY 表示无限期等待
+ * @returns UBaseType_t: 实际发送的消息数, 队列有空位时至少为 1, 超时为 0
+ */
+UBaseType_t uxQueueSendMultiple(QueueHandle_t xQueue,
+                                const void *const pvItemsToQueue,
+                                const UBaseType_t uxItemCount,
+                                TickType_t xTicksToWait)
+{
+    Queue_t *const pxQueue = (Queue_t *)xQueue;
+    BaseType_t xEntryTimeSet = pdFALSE;
+    BaseType_t xYieldRequired = pdFALSE;
+    UBaseType_t uxSent = 0U;
+    TimeOut_t xTimeOut;
+
+    configASSERT(pxQueue->ucQueueType == queueQUEUE_TYPE_BASE);
+
+    if (uxItemCount == (UBaseType_t)0)
+    {
+        return (UBaseType_t)0;
+    }
+
+    for (;;)
+    {
+        taskENTER_CRITICAL();
+        {
+            uxSent = prvSendBatch(pxQueue, pvItemsToQueue, uxItemCount, &xYieldRequired);
+
+            if (uxSent != (UBaseType_t)0)
+            {
+                if (xYieldRequired != pdFALSE)
+                {
+                    taskYIELD();
+                }
+
+                taskEXIT_CRITICAL();
+                return uxSent;
+            }
+
+            if (xTicksToWait == (TickType_t)0)
+            {
+                taskEXIT_CRITICAL();
+                return (UBaseType_t)0;
+            }
+
+            if (xEntryTimeSet == pdFALSE)
+            {
+                vTaskSetTimeOutState(&xTimeOut);
+                xEntryTimeSet = pdTRUE;
+            }
+            else if (xTaskCheckForTimeOut(&xTimeOut, &xTicksToWait) != pdFALSE)
+            {
+                taskEXIT_CRITICAL();
+                return (UBaseType_t)0;
+            }
+
+            vTaskPlaceOnEventList(&(pxQueue->xTasksWaitingToSend), xTicksToWait);
+            taskYIELD();
+        }
+        taskEXIT_CRITICAL();
+    }
+}
+
+/**
+ * @brief 在中断中批量发送消息, 不会阻塞
+ * @param QueueHandle_t xQueue: 队列句柄, 不能是互斥量
+ * @param const void *const pvItemsToQueue: 连续存放的消息
+ * @param const UBaseType_t uxItemCount: 消息数
+ * @param BaseType_t *const pxHigherPriorityTaskWoken: 唤醒了更高优先级任务时置为 pdTRUE, 中断退出前应调用 portYIELD()
+ * @returns UBaseType_t: 实际发送的消息数
+ */
+UBaseType_t uxQueueSendMultipleFromISR(QueueHandle_t xQueue,
+                                       const void *const pvItemsToQueue,
+                                       const UBaseType_t uxItemCount,
+                                       BaseType_t *const pxHigherPriorityTaskWoken)
+{
+    Queue_t *const pxQueue = (Queue_t *)xQueue;
+    BaseType_t xYieldRequired = pdFALSE;
+    UBaseType_t uxSent = 0U;
+    uint32_t ulSavedInterruptStatus = 0;
+
+    configASSERT(pxQueue->ucQueueType == queueQUEUE_TYPE_BASE);
+
+    ulSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+    {
+        uxSent = prvSendBatch(pxQueue, pvItemsToQueue, uxItemCount, &xYieldRequired);
+    }
+    taskEXIT_CRITICAL_FROM_ISR(ulSavedInterruptStatus);
+
+    if ((xYieldRequired != pdFALSE) && (pxHigherPriorityTaskWoken != NULL))
+    {
+        *pxHigherPriorityTaskWoken = pdTRUE;
+    }
+
+    return uxSent;
+}
+
+/**
+ * @brief 批量接收消息, 在一个临界段内读出尽可能多的消息, 队列空时阻塞等待
+ * @param QueueHandle_t xQueue: 队列句柄
+ * @param void *const pvBuffer: 消息拷贝到的地址, 大小至少为 uxMaxItems 条消息
+ * @param const UBaseType_t uxMaxItems: 最多读出的消息数
+ * @param TickType_t xTicksToWait: 队列空时最长等待时间, 0 表示不等待, portMAX_DELAY 表示无限期等待
+ * @returns UBaseType_t: 实际接收的消息数, 超时为 0
+ */
+UBaseType_t uxQueueReceiveMultiple(QueueHandle_t xQueue,
+                                   void *const pvBuffer,
+                                   const UBaseType_t uxMaxItems,
+                                   TickType_t xTicksToWait)
+{
+    Queue_t *const pxQueue = (Queue_t *)xQueue;
+    BaseType_t xEntryTimeSet = pdFALSE;
+    BaseType_t xYieldRequired = pdFALSE;
+    UBaseType_t uxReceived = 0U;
+    TimeOut_t xTimeOut;
+
+    if (uxMaxItems == (UBaseType_t)0)
+    {
+        return (UBaseType_t)0;
+    }
+
+    for (;;)
+    {
+        taskENTER_CRITICAL();
+        {
+            uxReceived = prvReceiveBatch(pxQueue, pvBuffer, uxMaxItems, &xYieldRequired);
+
+            if (uxReceived != (UBaseType_t)0)
+            {
+                if (xYieldRequired != pdFALSE)
+                {
+                    taskYIELD();
+                }
+
+                taskEXIT_CRITICAL();
+                return uxReceived;
+            }
+
+            if (xTicksToWait == (TickType_t)0)
+            {
+                taskEXIT_CRITICAL();
+                return (UBaseType_t)0;
+            }
+
+            if (xEntryTimeSet == pdFALSE)
+            {
+                vTaskSetTimeOutState(&xTimeOut);
+                xEntryTimeSet = pdTRUE;
+            }
+            else if (xTaskCheckForTimeOut(&xTimeOut, &xTicksToWait) != pdFALSE)
+            {
+                taskEXIT_CRITICAL();
+                return (UBaseType_t)0;
+            }
+
+            vTaskPlaceOnEventList(&(pxQueue->xTasksWaitingToReceive), xTicksToWait);
+            taskYIELD();
+        }
+        taskEXIT_CRITICAL();
+    }
+}
+
+/**
+ * @brief 在中断中批量接收消息, 不会阻塞
+ * @param QueueHandle_t xQueue: 队列句柄
+ * @param void *const pvBuffer: 消息拷贝到的地址, 大小至少为 uxMaxItems 条消息
+ * @param const UBaseType_t uxMaxItems: 最多读出的消息数
+ * @param BaseType_t *const pxHigherPriorityTaskWoken: 唤醒了更高优先级任务时置为 pdTRUE, 中断退出前应调用 portYIELD()
+ * @returns UBaseType_t: 实际接收的消息数
+ */
+UBaseType_t uxQueueReceiveMultipleFromISR(QueueHandle_t xQueue,
+                                          void *const pvBuffer,
+                                          const UBaseType_t uxMaxItems,
+                                          BaseType_t *const pxHigherPriorityTaskWoken)
+{
+    Queue_t *const pxQueue = (Queue_t *)xQueue;
+    BaseType_t xYieldRequired = pdFALSE;
+    UBaseType_t uxReceived = 0U;
+    uint32_t ulSavedInterruptStatus = 0;
+
+    ulSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+    {
+        uxReceived = prvReceiveBatch(pxQueue, pvBuffer, uxMaxItems, &xYieldRequired);
+    }
+    taskEXIT_CRITICAL_FROM_ISR(ulSavedInterruptStatus);
+
+    if ((xYieldRequired != pdFALSE) && (pxHigherPriorityTaskWoken != NULL))
+    {
+        *pxHigherPriorityTaskWoken = pdTRUE;
+    }
+
+    return uxReceived;
+}
+/******************************************************************************/
+
+/******************************************************************************/
+#if (configUSE_MUTEXES == 1)
+/**
+ * @brief 私有函数, 获取等待列表中最高的任务优先级, 需在临界段内调用
+ * @param const Queue_t *const pxQueue
+ * @returns UBaseType_t: 没有等待任务时返回 tskIDLE_PRIORITY
+ */
+static UBaseType_t prvGetDisinheritPriorityAfterTimeout(const Queue_t *const pxQueue)
+{
+    if (listLIST_IS_EMPTY(&(pxQueue->xTasksWaitingToReceive)) != pdFALSE)
+    {
+        return tskIDLE_PRIORITY;
+    }
+
+    // 等待列表按优先级的反序排序, 头部即优先级最高的任务
+    return (UBaseType_t)configMAX_PRIORITIES -
+           (UBaseType_t)listGET_ITEM_VALUE_OF_HEAD_ENTRY(&(pxQueue->xTasksWaitingToReceive));
+}
+
+/**
+ * @brief 静态创建互斥量, 创建后互斥量处于可获取状态
+ * @param const uint8_t ucQueueType: queueQUEUE_TYPE_MUTEX 或 queueQUEUE_TYPE_RECURSIVE_MUTEX
+ * @param Queue_t *pxStaticQueue: 互斥量控制块
+ * @returns QueueHandle_t: 互斥量句柄
+ */
+QueueHandle_t xQueueCreateMutexStatic(const uint8_t ucQueueType, Queue_t *pxStaticQueue)
+{
+    Queue_t *const pxNewQueue = (Queue_t *)xQueueCreateStatic((UBaseType_t)1U,
+                                                              (UBaseType_t)0U,
+                                                              NULL,
+                                                              pxStaticQueue);
+
+    if (pxNewQueue != NULL)
+    {
+        pxNewQueue->ucQueueType = ucQueueType;
+        pxNewQueue->pxMutexHolder = NULL;
+        pxNewQueue->uxRecursiveCallCount = (UBaseType_t)0U;
+        // 长度为 1 的计数队列中有一条消息, 表示互斥量空闲
+        pxNewQueue->uxMessagesWaiting = (UBaseType_t)1U;
+    }
+
+    return (QueueHandle_t)pxNewQueue;
+}
+
+/**
+ * @brief 静态创建优先级天花板互斥量, 创建后互斥量处于可获取状态
+ *
+ * 持有者以天花板优先级运行, 持有期间不阻塞时其他会获取该互斥量的任务得不到运行, 获取时互斥量必然空闲, 不进入等待.
+ * 持有者阻塞或获取者的优先级高于天花板时会出现竞争, 获取者与普通互斥量一样按 xTicksToWait 阻塞等待, 不发生优先级继承
+ *
+ * @param const UBaseType_t uxCeilingPriority: 天花板优先级, 不低于所有会获取该互斥量的任务的优先级
+ * @param Queue_t *pxStaticQueue: 互斥量控制块
+ * @returns QueueHandle_t: 互斥量句柄
+ */
+QueueHandle_t xQueueCreateCeilingMutexStatic(const UBaseType_t uxCeilingPriority,
+                                             Queue_t *pxStaticQueue)
+{
+    Queue_t *const pxNewQueue = (Queue_t *)xQueueCreateMutexStatic(queueQUEUE_TYPE_CEILING_MUTEX,
+                                                                   pxStaticQueue);
+
+    if (pxNewQueue != NULL)
+    {
+        pxNewQueue->uxCeilingPriority = uxCeilingPriority;
+
+        if (pxNewQueue->uxCeilingPriority >= (UBaseType_t)configMAX_PRIORITIES)
+        {
+            pxNewQueue->uxCeilingPriority = (UBaseType_t)configMAX_PRIORITIES - (UBaseType_t)1U;
+        }
+
+        // 与任务的 xEventListItem 一样取反序, 持有列表的头部即最高的天花板
+        listSET_LIST_ITEM_OWNER(&(pxNewQueue->xCeilingListItem), pxNewQueue);
+        listSET_LIST_ITEM_VALUE(&(pxNewQueue->xCeilingListItem),
+                                (TickType_t)configMAX_PRIORITIES - (TickType_t)pxNewQueue->uxCeilingPriority);
+    }
+
+    return (QueueHandle_t)pxNewQueue;
+}
+
+/**
+ * @brief 获取互斥量的持有者
+ * @param QueueHandle_t xSemaphore: 互斥量句柄
+ * @returns void *: 持有者的任务句柄, 互斥量空闲时为 NULL
+ */
+void *xQueueGetMutexHolder(QueueHandle_t xSemaphore)
+{
+    void *pxReturn = NULL;
+
+    taskENTER_CRITICAL();
+    {
+        if (((Queue_t *)xSemaphore)->ucQueueType != queueQUEUE_TYPE_BASE)
+        {
+            pxReturn = ((Queue_t *)xSemaphore)->pxMutexHolder;
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    return pxReturn;
+}
+
+/**
+ * @brief 获取递归互斥量, 持有者重复获取时只增加计数, 不进入临界段, 不操作任何内核列表
+ * @param QueueHandle_t xMutex: 递归互斥量句柄
+ * @param TickType_t xTicksToWait: 被其他任务持有时最长等待时间, portMAX_DELAY 表示无限期等待
+ * @returns BaseType_t: pdPASS 获取成功, errQUEUE_EMPTY 超时
+ */
+BaseType_t xQueueTakeMutexRecursive(QueueHandle_t xMutex, TickType_t xTicksToWait)
+{
+    Queue_t *const pxMutex = (Queue_t *)xMutex;
+    BaseType_t xReturn = pdPASS;
+
+    configASSERT(pxMutex->ucQueueType == queueQUEUE_TYPE_RECURSIVE_MUTEX);
+
+    // 只有持有者自己会修改计数, 持有者的判断不会被其他任务改变
+    if (pxMutex->pxMutexHolder == (void *)xTaskGetCurrentTaskHandle())
+    {
+        (pxMutex->uxRecursiveCallCount)++;
+    }
+    else
+    {
+        xReturn = xQueueSemaphoreTake(xMutex, xTicksToWait);
+
+        if (xReturn != pdFALSE)
+        {
+            (pxMutex->uxRecursiveCallCount)++;
+        }
+    }
+
+    return xReturn;
+}
+
+/**
+ * @brief 释放递归互斥量, 计数减到 0 时才真正释放
+ * @param QueueHandle_t xMutex: 递归互斥量句柄
+ * @returns BaseType_t: pdPASS 释放成功, pdFAIL 当前任务不是持有者
+ */
+BaseType_t xQueueGiveMutexRecursive(QueueHandle_t xMutex)
+{
+    Queue_t *const pxMutex = (Queue_t *)xMutex;
+
+    configASSERT(pxMutex->ucQueueType == queueQUEUE_TYPE_RECURSIVE_MUTEX);
+
+    if (pxMutex->pxMutexHolder != (void *)xTaskGetCurrentTaskHandle())
+    {
+        return pdFAIL;
+    }
+
+    (pxMutex->uxRecursiveCallCount)--;
+
+    if (pxMutex->uxRecursiveCallCount == (UBaseType_t)0U)
+    {
+        // 最外层释放, 唤醒等待者并恢复优先级
+        (void)xQueueGenericSend(xMutex, NULL, (TickType_t)0U, queueSEND_TO_BACK);
+    }
+
+    return pdPASS;
+}
+#endif
+/******************************************************************************/
+
+/******************************************************************************/
+/**
+ * @brief 静态创建计数信号量, 最大计数为 1 时即二值信号量
+ * @param const UBaseType_t uxMaxCount: 最大计数值
+ * @param const UBaseType_t uxInitialCount: 初始计数值, 不超过 uxMaxCount
+ * @param Queue_t *pxStaticQueue: 信号量控制块
+ * @returns QueueHandle_t: 信号量句柄
+ */
+QueueHandle_t xQueueCreateCountingSemaphoreStatic(const UBaseType_t uxMaxCount,
+                                                  const UBaseType_t uxInitialCount,
+                                                  Queue_t *pxStaticQueue)
+{
+    Queue_t *pxNewQueue = NULL;
+
+    if (uxInitialCount > uxMaxCount)
+    {
+        return NULL;
+    }
+
+    pxNewQueue = (Queue_t *)xQueueCreateStatic(uxMaxCount, (UBaseType_t)0U, NULL, pxStaticQueue);
+
+    if (pxNewQueue != NULL)
+    {
+        pxNewQueue->uxMessagesWaiting = uxInitialCount;
+    }
+
+    return (QueueHandle_t)pxNewQueue;
+}
+
+/**
+ * @brief 获取信号量, 互斥量被占用时阻塞等待, 并让持有者继承当前任务的优先级
+ * @param QueueHandle_t xQueue: 信号量句柄
+ * @param TickType_t xTicksToWait: 最长等待时间, 0 表示不等待, portMAX_DELAY 表示无限期等待
+ * @returns BaseType_t: pdPASS 获取成功, errQUEUE_EMPTY 超时
+ */
+BaseType_t xQueueSemaphoreTake(QueueHandle_t xQueue, TickType_t xTicksToWait)
+{
+    Queue_t *const pxQueue = (Queue_t *)xQueue;
+    BaseType_t xEntryTimeSet = pdFALSE;
+#if (configUSE_MUTEXES == 1)
+    BaseType_t xInheritanceOccurred = pdFALSE;
+#endif
+    TimeOut_t xTimeOut;
+
+    configASSERT(pxQueue->uxItemSize == (UBaseType_t)0);
+
+    for (;;)
+    {
+        taskENTER_CRITICAL();
+        {
+            if (pxQueue->uxMessagesWaiting > (UBaseType_t)0)
+            {
+                pxQueue->uxMessagesWaiting--;
+
+#if (configUSE_MUTEXES == 1)
+                if (queueIS_INHERITANCE_MUTEX(pxQueue))
+                {
+                    pxQueue->pxMutexHolder = pvTaskIncrementMutexHeldCount();
+                }
+                else if (pxQueue->ucQueueType == queueQUEUE_TYPE_CEILING_MUTEX)
+                {
+                    // 与优先级继承互斥量一起计入持有计数, 释放其中任何一个都按仍持有的互斥量重新计算优先级
+                    pxQueue->pxMutexHolder = pvTaskIncrementMutexHeldCount();
+                    vTaskPriorityCeilingRaise(&(pxQueue->xCeilingListItem));
+                }
+#endif
+
+                if (listLIST_IS_EMPTY(&(pxQueue->xTasksWaitingToSend)) == pdFALSE)
+                {
+                    if (xTaskRemoveFromEventList(&(pxQueue->xTasksWaitingToSend)) != pdFALSE)
+                    {
+                        taskYIELD();
+                    }
+                }
+
+                taskEXIT_CRITICAL();
+                return pdPASS;
+            }
+
+            if (xTicksToWait == (TickType_t)0)
+            {
+                taskEXIT_CRITICAL();
+                return errQUEUE_EMPTY;
+            }
+
+            if (xEntryTimeSet == pdFALSE)
+            {
+                vTaskSetTimeOutState(&xTimeOut);
+                xEntryTimeSet = pdTRUE;
+            }
+            else if (xTaskCheckForTimeOut(&xTimeOut, &xTicksToWait) != pdFALSE)
+            {
+#if (configUSE_MUTEXES == 1)
+                // 超时放弃等待, 持有者不必再保持为本任务继承的优先级
+                if (xInheritanceOccurred != pdFALSE)
+                {
+                    vTaskPriorityDisinheritAfterTimeout(pxQueue->pxMutexHolder,
+                                                        prvGetDisinheritPriorityAfterTimeout(pxQueue));
+                }
+#endif
+
+                taskEXIT_CRITICAL();
+                return errQUEUE_EMPTY;
+            }
+
+#if (configUSE_MUTEXES == 1)
+            if (queueIS_INHERITANCE_MUTEX(pxQueue))
+            {
+                if (xTaskPriorityInherit(pxQueue->pxMutexHolder) != pdFALSE)
+                {
+                    xInheritanceOccurred = pdTRUE;
+                }
+            }
+#endif
+
+            vTaskPlaceOnEventList(&(pxQueue->xTasksWaitingToReceive), xTicksToWait);
+            taskYIELD();
+        }
+        taskEXIT_CRITICAL();
+    }
+}
+/******************************************************************************/
+
+/******************************************************************************/
+#if (configUSE_QUEUE_SETS == 1)
+/**
+ * @brief 静态创建队列集
+ * @param const UBaseType_t uxEventQueueLength: 队列集长度, 不小于所有成员的长度之和
+ * @param uint8_t *pucQueueSetStorage: 存储区, 大小为 queueSET_STORAGE_SIZE(uxEventQueueLength)
+ * @param Queue_t *pxQueueSetBuffer: 队列集控制块
+ * @returns QueueSetHandle_t: 队列集句柄
+ */
+QueueSetHandle_t xQueueCreateSetStatic(const UBaseType_t uxEventQueueLength,
+                                       uint8_t *pucQueueSetStorage,
+                                       Queue_t *pxQueueSetBuffer)
+{
+    return (QueueSetHandle_t)xQueueCreateStatic(uxEventQueueLength,
+                                                (UBaseType_t)sizeof(Queue_t *),
+                                                pucQueueSetStorage,
+                                                pxQueueSetBuffer);
+}
+
+/**
+ * @brief 将队列或信号量加入队列集, 成员此时必须为空, 互斥量不能加入队列集
+ * @param QueueSetMemberHandle_t xQueueOrSemaphore: 成员句柄
+ * @param QueueSetHandle_t xQueueSet: 队列集句柄
+ * @returns BaseType_t: pdPASS 加入成功, pdFAIL 成员已属于某个队列集或不为空
+ */
+BaseType_t xQueueAddToSet(QueueSetMemberHandle_t xQueueOrSemaphore,
+                          QueueSetHandle_t xQueueSet)
+{
+    Queue_t *const pxQueue = (Queue_t *)xQueueOrSemaphore;
+    BaseType_t xReturn = pdFAIL;
+
+    configASSERT(pxQueue->ucQueueType == queueQUEUE_TYPE_BASE);
+
+    taskENTER_CRITICAL();
+    {
+        // 成员中已有的消息没有对应的句柄在队列集中, 加入后无法被选中
+        if ((pxQueue->pxQueueSetContainer == NULL) &&
+            (pxQueue->uxMessagesWaiting == (UBaseType_t)0))
+        {
+            pxQueue->pxQueueSetContainer = (Queue_t *)xQueueSet;
+            xReturn = pdPASS;
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    return xReturn;
+}
+
+/**
+ * @brief 将成员移出队列集, 成员此时必须为空
+ * @param QueueSetMemberHandle_t xQueueOrSemaphore: 成员句柄
+ * @param QueueSetHandle_t xQueueSet: 队列集句柄
+ * @returns BaseType_t: pdPASS 移出成功, pdFAIL 成员不属于该队列集或不为空
+ */
+BaseType_t xQueueRemoveFromSet(QueueSetMemberHandle_t xQueueOrSemaphore,
+                               QueueSetHandle_t xQueueSet)
+{
+    Queue_t *const pxQueue = (Queue_t *)xQueueOrSemaphore;
+    BaseType_t xReturn = pdFAIL;
+
+    taskENTER_CRITICAL();
+    {
+        // 成员不为空时队列集中还有它的句柄
+        if ((pxQueue->pxQueueSetContainer == (Queue_t *)xQueueSet) &&
+            (pxQueue->uxMessagesWaiting == (UBaseType_t)0))
+        {
+            pxQueue->pxQueueSetContainer = NULL;
+            xReturn = pdPASS;
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    return xReturn;
+}
+
+/**
+ * @brief 等待队列集中任意一个成员就绪, 返回后应以 0 等待时间从该成员接收或获取
+ * @param QueueSetHandle_t xQueueSet: 队列集句柄
+ * @param TickType_t const xTicksToWait: 最长等待时间, portMAX_DELAY 表示无限期等待
+ * @returns QueueSetMemberHandle_t: 就绪的成员句柄, 超时返回 NULL
+ */
+QueueSetMemberHandle_t xQueueSelectFromSet(QueueSetHandle_t xQueueSet,
+                                           TickType_t const xTicksToWait)
+{
+    QueueSetMemberHandle_t xReturn = NULL;
+
+    (void)xQueueReceive((QueueHandle_t)xQueueSet, &xReturn, xTicksToWait);
+
+    return xReturn;
+}
+
+/**
+ * @brief 在中断中查询队列集中就绪的成员, 不会阻塞
+ * @param QueueSetHandle_t xQueueSet: 队列集句柄
+ * @returns QueueSetMemberHandle_t: 就绪的成员句柄, 没有成员就绪时返回 NULL
+ */
+QueueSetMemberHandle_t xQueueSelectFromSetFromISR(QueueSetHandle_t xQueueSet)
+{
+    QueueSetMemberHandle_t xReturn = NULL;
+
+    (void)xQueueReceiveFromISR((QueueHandle_t)xQueueSet, &xReturn, NULL);
+
+    return xReturn;
+}
+#endif
+/******************************************************************************/
@@ -0,0 +1,293 @@
+#include "rwlock.h"
+#include "task.h"
+#include "portmacro.h"
+#include "rtos_config.h"
+#include "projectdefs.h"
+#include "list.h"
+
+#if (configUSE_RWLOCKS == 1)
+
+/******************************************************************************/
+/**
+ * @brief 初始化读写锁
+ * @param RWLock_t *const pxLock
+ */
+void vRWLockInit(RWLock_t *const pxLock)
+{
+    pxLock->ulState = 0UL;
+    pxLock->xWriter = NULL;
+    vListInitialise(&(pxLock->xReadersWaiting));
+    vListInitialise(&(pxLock->xWritersWaiting));
+}
+
+/**
+ * @brief 私有函数, 根据等待列表刷新状态字中的等待标志, 需在临界段内调用
+ * @param RWLock_t *const pxLock
+ */
+static void prvUpdateWaitingFlags(RWLock_t *const pxLock)
+{
+    uint32_t ulState = pxLock->ulState & ~(rwlockWRITER_WAITING | rwlockREADER_WAITING);
+
+    if (listLIST_IS_EMPTY(&(pxLock->xWritersWaiting)) == pdFALSE)
+    {
+        ulState |= rwlockWRITER_WAITING;
+    }
+
+    if (listLIST_IS_EMPTY(&(pxLock->xReadersWaiting)) == pdFALSE)
+    {
+        ulState |= rwlockREADER_WAITING;
+    }
+
+    pxLock->ulState = ulState;
+}
+
+/**
+ * @brief 私有函数, 锁状态变化后唤醒能够继续的等待者, 需在临界段内调用
+ *
+ * 写者优先: 有写者等待时, 锁空闲后直接移交给优先级最高的写者; 没有写者等待时唤醒全部读者
+ *
+ * @param RWLock_t *const pxLock
+ * @returns BaseType_t: 唤醒了比当前任务优先级更高的任务时返回 pdTRUE
+ */
+static BaseType_t prvGrantWaiters(RWLock_t *const pxLock)
+{
+    BaseType_t xYieldRequired = pdFALSE;
+
+    if ((pxLock->ulState & rwlockWRITER) == 0UL)
+    {
+        if (listLIST_IS_EMPTY(&(pxLock->xWritersWaiting)) == pdFALSE)
+        {
+            if ((pxLock->ulState & rwlockREADER_MASK) == 0UL)
+            {
+                pxLock->xWriter = (TaskHandle_t)listGET_OWNER_OF_HEAD_ENTRY(&(pxLock->xWritersWaiting));
+                pxLock->ulState |= rwlockWRITER;
+                xYieldRequired = xTaskRemoveFromEventList(&(pxLock->xWritersWaiting));
+            }
+        }
+        else
+        {
+            // 读者被唤醒后重新尝试加锁
+            while (listLIST_IS_EMPTY(&(pxLock->xReadersWaiting)) == pdFALSE)
+            {
+                if (xTaskRemoveFromEventList(&(pxLock->xReadersWaiting)) != pdFALSE)
+                {
+                    xYieldRequired = pdTRUE;
+                }
+            }
+        }
+    }
+
+    prvUpdateWaitingFlags(pxLock);
+
+    return xYieldRequired;
+}
+/******************************************************************************/
+
+/******************************************************************************/
+/**
+ * @brief 以读者身份加锁, 多个读者可同时持有锁
+ * @param RWLock_t *const pxLock
+ * @param TickType_t xTicksToWait: 最长等待时间, 0 表示不等待, portMAX_DELAY 表示无限期等待
+ * @returns BaseType_t: pdPASS 加锁成功, pdFAIL 超时
+ */
+BaseType_t xRWLockReadLock(RWLock_t *const pxLock, TickType_t xTicksToWait)
+{
+    uint32_t ulState = 0UL;
+    BaseType_t xEntryTimeSet = pdFALSE;
+    TimeOut_t xTimeOut;
+
+    // 快速路径: 没有写者持有或等待时, 用 LDREX/STREX 将读者数加 1
+    for (;;)
+    {
+        ulState = pxLock->ulState;
+
+        if ((ulState & (rwlockWRITER | rwlockWRITER_WAITING)) != 0UL)
+        {
+            break;
+        }
+
+        if (xPortCompareAndSwap(&(pxLock->ulState), ulState + 1UL, ulState) != pdFALSE)
+        {
+            return pdPASS;
+        }
+    }
+
+    for (;;)
+    {
+        taskENTER_CRITICAL();
+        {
+            ulState = pxLock->ulState;
+
+            if ((ulState & (rwlockWRITER | rwlockWRITER_WAITING)) == 0UL)
+            {
+                pxLock->ulState = ulState + 1UL;
+                taskEXIT_CRITICAL();
+                return pdPASS;
+            }
+
+            if (xTicksToWait == (TickType_t)0)
+            {
+                taskEXIT_CRITICAL();
+                return pdFAIL;
+            }
+
+            if (xEntryTimeSet == pdFALSE)
+            {
+                vTaskSetTimeOutState(&xTimeOut);
+                xEntryTimeSet = pdTRUE;
+            }
+            else if (xTaskCheckForTimeOut(&xTimeOut, &xTicksToWait) != pdFALSE)
+            {
+                prvUpdateWaitingFlags(pxLock);
+                taskEXIT_CRITICAL();
+                return pdFAIL;
+            }
+
+            vTaskPlaceOnEventList(&(pxLock->xReadersWaiting), xTicksToWait);
+            pxLock->ulState = ulState | rwlockREADER_WAITING;
+            taskYIELD();
+        }
+        taskEXIT_CRITICAL();
+    }
+}
+
+/**
+ * @brief 读者解锁
+ * @param RWLock_t *const pxLock
+ */
+void vRWLockReadUnlock(RWLock_t *const pxLock)
+{
+    uint32_t ulState = 0UL;
+
+    // 快速路径: 不是最后一个读者, 或者没有人在等待, 直接将读者数减 1
+    for (;;)
+    {
+        ulState = pxLock->ulState;
+        configASSERT((ulState & rwlockREADER_MASK) != 0UL);
+
+        if (((ulState & rwlockREADER_MASK) == 1UL) &&
+            ((ulState & (rwlockWRITER_WAITING | rwlockREADER_WAITING)) != 0UL))
+        {
+            break;
+        }
+
+        if (xPortCompareAndSwap(&(pxLock->ulState), ulState - 1UL, ulState) != pdFALSE)
+        {
+            return;
+        }
+    }
+
+    // 最后一个读者释放且有任务在等待, 进入临界段移交锁
+    taskENTER_CRITICAL();
+    {
+        pxLock->ulState--;
+
+        if (prvGrantWaiters(pxLock) != pdFALSE)
+        {
+            taskYIELD();
+        }
+    }
+    taskEXIT_CRITICAL();
+}
+
+/**
+ * @brief 以写者身份加锁, 写者独占锁
+ * @param RWLock_t *const pxLock
+ * @param TickType_t xTicksToWait: 最长等待时间, 0 表示不等待, portMAX_DELAY 表示无限期等待
+ * @returns BaseType_t: pdPASS 加锁成功, pdFAIL 超时
+ */
+BaseType_t xRWLockWriteLock(RWLock_t *const pxLock, TickType_t xTicksToWait)
+{
+    const TaskHandle_t xCurrentTask = xTaskGetCurrentTaskHandle();
+    uint32_t ulState = 0UL;
+    BaseType_t xEntryTimeSet = pdFALSE;
+    TimeOut_t xTimeOut;
+
+    // 快速路径: 锁完全空闲
+    if (xPortCompareAndSwap(&(pxLock->ulState), rwlockWRITER, 0UL) != pdFALSE)
+    {
+        pxLock->xWriter = xCurrentTask;
+        return pdPASS;
+    }
+
+    for (;;)
+    {
+        taskENTER_CRITICAL();
+        {
+            // 释放者已经将锁直接移交给本任务
+            if (pxLock->xWriter == xCurrentTask)
+            {
+                taskEXIT_CRITICAL();
+                return pdPASS;
+            }
+
+            ulState = pxLock->ulState;
+
+            if ((ulState & (rwlockWRITER | rwlockREADER_MASK)) == 0UL)
+            {
+                pxLock->ulState = ulState | rwlockWRITER;
+                pxLock->xWriter = xCurrentTask;
+                taskEXIT_CRITICAL();
+                return pdPASS;
+            }
+
+            if (xTicksToWait == (TickType_t)0)
+            {
+                taskEXIT_CRITICAL();
+                return pdFAIL;
+            }
+
+            if (xEntryTimeSet == pdFALSE)
+            {
+                vTaskSetTimeOutState(&xTimeOut);
+                xEntryTimeSet = pdTRUE;
+            }
+            else if (xTaskCheckForTimeOut(&xTimeOut, &xTicksToWait) != pdFALSE)
+            {
+                // 本任务不再等待, 因写者优先而被挡住的读者可能可以继续了
+                if (prvGrantWaiters(pxLock) != pdFALSE)
+                {
+                    taskYIELD();
+                }
+                taskEXIT_CRITICAL();
+                return pdFAIL;
+            }
+
+            vTaskPlaceOnEventList(&(pxLock->xWritersWaiting), xTicksToWait);
+            pxLock->ulState = ulState | rwlockWRITER_WAITING;
+            taskYIELD();
+        }
+        taskEXIT_CRITICAL();
+    }
+}
+
+/**
+ * @brief 写者解锁, 只能由持有锁的写者调用
+ * @param RWLock_t *const pxLock
+ */
+void vRWLockWriteUnlock(RWLock_t *const pxLock)
+{
+    configASSERT(pxLock->xWriter == xTaskGetCurrentTaskHandle());
+
+    pxLock->xWriter = NULL;
+
+    // 快速路径: 没有人在等待
+    if (xPortCompareAndSwap(&(pxLock->ulState), 0UL, rwlockWRITER) != pdFALSE)
+    {
+        return;
+    }
+
+    taskENTER_CRITICAL();
+    {
+        pxLock->ulState &= ~rwlockWRITER;
+
+        if (prvGrantWaiters(pxLock) != pdFALSE)
+        {
+            taskYIELD();
+        }
+    }
+    taskEXIT_CRITICAL();
+}
+/******************************************************************************/
+
+#endif
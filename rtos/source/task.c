@@ -4,13 +4,15 @@
 #include "rtos_config.h"
 #include "projectdefs.h"
 #include "list.h"
+#include "active_object.h"
+#include "workqueue.h"
 
 /******************************************************************************/
 // 就绪列表: 任务创建好之后, 需要把任务添加到就绪列表里面, 表示任务已经就绪
 // 同一优先级的任务统一插入到就绪列表的同一条链表中
 List_t pxReadyTasksLists[configMAX_PRIORITIES] = {0};
-// TCB_t *pxCurrentTCB
-TCB_t *pxCurrentTCB = NULL;
+// TCB_t *pxCurrentTCB, 由移植层的汇编代码直接访问
+portDONT_DISCARD TCB_t *pxCurrentTCB = NULL;
 // UBaseType_t uxCurrentNumberOfTasks
 static volatile UBaseType_t uxCurrentNumberOfTasks = 0UL;
 // 创建的任务的最高优先级
@@ -29,7 +31,25 @@ List_t *pxOverflowDelayedTaskList = NULL;
 volatile TickType_t xNextTaskUnblockTime = 0;
 // xTickCount 溢出次数
 BaseType_t xNumOfOverflows = 0;
-extern TickType_t xTickCount;
+// 系统时基计时器
+TickType_t xTickCount = 0;
+
+#if (configUSE_BASIC_TASKS == 1)
+// 所有基本任务共享的任务栈, 基本任务不会阻塞, 高优先级基本任务抢占低优先级基本任务时在同一个栈上向下嵌套
+static StackType_t xBasicTaskStack[configBASIC_TASK_STACK_SIZE];
+// 共享栈上最内层(最后开始运行)的基本任务, 为 NULL 时共享栈为空
+static TCB_t *pxBasicTaskNestTop = NULL;
+#endif
+
+#if (configGENERATE_RUN_TIME_STATS == 1)
+// 当前任务被切入时周期计数器的值
+static uint32_t ulTaskSwitchedInTime = 0UL;
+// 调度器启动以来所有任务累计运行时间之和
+static configRUN_TIME_COUNTER_TYPE ulTotalRunTime = 0U;
+// 按创建顺序串起所有任务的链表的头和尾, 任务不会被删除, 只在尾部追加
+static TCB_t *pxFirstCreatedTask = NULL;
+static TCB_t *pxLastCreatedTask = NULL;
+#endif
 /******************************************************************************/
 
 /******************************************************************************/
@@ -56,6 +76,18 @@ void prvInitialiseTaskLists(void)
 
 #define DOUBLE_WORD_ALIGNMENT (0x0007)
 
+// 任务初始栈帧的大小, 单位为字, 默认为异常栈帧和 r4~r11, 栈帧更大的移植在 portmacro.h 中重新定义
+#ifndef portINITIAL_FRAME_WORDS
+#define portINITIAL_FRAME_WORDS 16
+#endif
+
+#if (configUSE_TASK_NOTIFICATIONS == 1)
+// 任务通知状态
+#define taskNOT_WAITING_NOTIFICATION ((uint8_t)0)
+#define taskWAITING_NOTIFICATION ((uint8_t)1)
+#define taskNOTIFICATION_RECEIVED ((uint8_t)2)
+#endif
+
 /**
  * @brief 私有函数, 创建新任务
  * @param TaskFuntion_t pxTaskCode: 任务入口
@@ -84,7 +116,7 @@ static void prvInitialiseNewTask(TaskFuntion_t pxTaskCode,
     // 令指向 task stack 的 pxStack 从数组中的最低地址指向数组中的最高地址, 人为构造一个栈以及栈指针
     pxTopOfStack = pxNewTCB->pxStack + (ulStackDepth - (uint32_t)1U);
     // 令栈指针向下做 8 字节对齐
-    pxTopOfStack = (StackType_t *)(((uint32_t)pxTopOfStack) & (~((uint32_t)DOUBLE_WORD_ALIGNMENT)));
+    pxTopOfStack = (StackType_t *)(((portPOINTER_SIZE_TYPE)pxTopOfStack) & (~((portPOINTER_SIZE_TYPE)DOUBLE_WORD_ALIGNMENT)));
 
     // 将任务的名字存储在 TCB 中
     for (x = (UBaseType_t)0U; x < (UBaseType_t)configMAX_TASK_NAME_LEN; x++)
@@ -110,10 +142,51 @@ static void prvInitialiseNewTask(TaskFuntion_t pxTaskCode,
     }
     pxNewTCB->uxPriority = uxPriority;
 
-    // 初始化任务栈
-    pxNewTCB->pxTopOfStack = pxPortInitialiseStack(pxTopOfStack,
-                                                   pxTaskCode,
-                                                   pvParameters);
+    // 初始化 TCB 中的 xEventListItem 节点, 排序值取优先级的反序, 使等待列表中高优先级任务排在前面
+    vListInitialiseItem(&(pxNewTCB->xEventListItem));
+    listSET_LIST_ITEM_OWNER(&(pxNewTCB->xEventListItem), pxNewTCB);
+    listSET_LIST_ITEM_VALUE(&(pxNewTCB->xEventListItem),
+                            (TickType_t)configMAX_PRIORITIES - (TickType_t)uxPriority);
+
+#if (configUSE_TASK_NOTIFICATIONS == 1)
+    pxNewTCB->ulNotifiedValue = 0UL;
+    pxNewTCB->ucNotifyState = taskNOT_WAITING_NOTIFICATION;
+#endif
+
+#if (configUSE_MUTEXES == 1)
+    pxNewTCB->uxBasePriority = uxPriority;
+    pxNewTCB->uxMutexesHeld = (UBaseType_t)0U;
+    pxNewTCB->uxInheritedPriority = tskIDLE_PRIORITY;
+    vListInitialise(&(pxNewTCB->xCeilingMutexesHeld));
+#endif
+
+#if (configUSE_FUTEX == 1)
+    pxNewTCB->pulFutexAddress = NULL;
+#endif
+
+#if (configGENERATE_RUN_TIME_STATS == 1)
+    pxNewTCB->ulRunTimeCounter = 0U;
+    pxNewTCB->pxNextCreatedTask = NULL;
+#endif
+
+#if (configUSE_BASIC_TASKS == 1)
+    pxNewTCB->xBasicStarted = pdFALSE;
+    pxNewTCB->pxPreemptedBasicTask = NULL;
+    if (pxNewTCB->uxTaskType == tskBASIC_TASK)
+    {
+        // 基本任务的栈帧在每次开始运行时才在共享栈上构建, 见 prvPrepareBasicTask()
+        pxNewTCB->pxTaskCode = pxTaskCode;
+        pxNewTCB->pvParameters = pvParameters;
+        pxNewTCB->pxTopOfStack = NULL;
+    }
+    else
+#endif
+    {
+        // 初始化任务栈
+        pxNewTCB->pxTopOfStack = pxPortInitialiseStack(pxTopOfStack,
+                                                       pxTaskCode,
+                                                       pvParameters);
+    }
 
     // 让任务句柄指向任务控制块
     if ((void *)pxCreateTask != NULL)
@@ -122,6 +195,25 @@ static void prvInitialiseNewTask(TaskFuntion_t pxTaskCode,
     }
 }
 
+#if (configGENERATE_RUN_TIME_STATS == 1)
+/**
+ * @brief 私有函数, 将新任务追加到创建顺序链表, 在临界段中调用
+ * @param TCB_t *pxNewTCB
+ */
+static void prvAddTaskToCreatedList(TCB_t *pxNewTCB)
+{
+    if (pxLastCreatedTask == NULL)
+    {
+        pxFirstCreatedTask = pxNewTCB;
+    }
+    else
+    {
+        pxLastCreatedTask->pxNextCreatedTask = pxNewTCB;
+    }
+    pxLastCreatedTask = pxNewTCB;
+}
+#endif
+
 /**
  * @brief 添加新任务到任务就绪列表
  * @param TCB_t *pxNewTCB
@@ -149,6 +241,10 @@ static void prvAddNewTaskToReadyList(TCB_t *pxNewTCB)
                 pxCurrentTCB = pxNewTCB;
             }
         }
+#if (configGENERATE_RUN_TIME_STATS == 1)
+        prvAddTaskToCreatedList(pxNewTCB);
+#endif
+        traceTASK_CREATE(pxNewTCB);
         prvAddTaskToReadyList(pxNewTCB);
     }
     taskEXIT_CRITICAL();
@@ -157,13 +253,17 @@ static void prvAddNewTaskToReadyList(TCB_t *pxNewTCB)
 /**
  * @brief 将任务插入到延时列表
  * @param TickType_t xTicksToWait
+ * @param const BaseType_t xCanBlockIndefinitely: pdTRUE 时 portMAX_DELAY 表示无限期等待, 不加入延时列表, 只能通过事件列表或任务通知唤醒;
+ *        pdFALSE 时 portMAX_DELAY 也只是一个很长的延时, 用于 vTaskDelay()
  */
-static void prvAddCurrentTaskToDelayedList(TickType_t xTicksToWait)
+static void prvAddCurrentTaskToDelayedList(TickType_t xTicksToWait, const BaseType_t xCanBlockIndefinitely)
 {
     TickType_t xTimeToWake = 0;
 
     const TickType_t xConstTickCount = xTickCount;
 
+    traceTASK_DELAYED(xTicksToWait);
+
     // 因为任务将要被添加到延时列表, 将任务从就绪列表中移除, 之后延时完成, 重新将任务添加到就绪列表
     if (uxListRemove(&(pxCurrentTCB->xStateListItem)) == (UBaseType_t)0)
     {
@@ -175,6 +275,12 @@ static void prvAddCurrentTaskToDelayedList(TickType_t xTicksToWait)
         portRESET_READY_PRIORITY(pxCurrentTCB->uxPriority, uxTopReadyPriority);
     }
 
+    // 无限期等待: 不加入延时列表, 只能通过事件列表或任务通知被唤醒
+    if ((xTicksToWait == portMAX_DELAY) && (xCanBlockIndefinitely != pdFALSE))
+    {
+        return;
+    }
+
     // 计算任务延时到期时, 系统时基计数器 xTickCount 的值是多少
     xTimeToWake = xConstTickCount + xTicksToWait;
 
@@ -246,6 +352,9 @@ TaskHandle_t xTaskCreateStatic(TaskFuntion_t pxTaskCode,
     {
         pxNewTCB = (TCB_t *)pxTaskBuffer;
         pxNewTCB->pxStack = (StackType_t *)puxStackBuffer;
+#if (configUSE_BASIC_TASKS == 1)
+        pxNewTCB->uxTaskType = tskEXTENDED_TASK;
+#endif
 
         prvInitialiseNewTask(pxTaskCode,
                              pcName,
@@ -265,6 +374,206 @@ TaskHandle_t xTaskCreateStatic(TaskFuntion_t pxTaskCode,
     return xReturn;
 }
 
+#endif
+
+#if (configUSE_BASIC_TASKS == 1)
+
+/**
+ * @brief 基本任务的统一入口, 运行任务函数直至返回, 然后释放共享栈上的栈帧
+ * @param void *pvParameters: 基本任务自身的 TCB
+ */
+static void prvBasicTaskEntry(void *pvParameters)
+{
+    TCB_t *const pxTCB = (TCB_t *)pvParameters;
+
+    pxTCB->pxTaskCode(pxTCB->pvParameters);
+
+    // 运行至完成: 从就绪列表移除, 弹出共享栈上的栈帧, 等待下一次激活
+    taskENTER_CRITICAL();
+    {
+        if (uxListRemove(&(pxTCB->xStateListItem)) == (UBaseType_t)0)
+        {
+            portRESET_READY_PRIORITY(pxTCB->uxPriority, uxTopReadyPriority);
+        }
+
+        pxBasicTaskNestTop = pxTCB->pxPreemptedBasicTask;
+        pxTCB->pxPreemptedBasicTask = NULL;
+        pxTCB->xBasicStarted = pdFALSE;
+    }
+    taskEXIT_CRITICAL();
+
+    // 任务已不在就绪列表中, 切换出去后不会再被调度, 本栈帧随即作废
+    taskYIELD();
+
+    for (;;)
+        ;
+}
+
+/**
+ * @brief 私有函数, 在 vTaskSwitchContext() 选出基本任务后调用, 必要时在共享栈上为其构建栈帧
+ *
+ * 栈资源策略(SRP): 共享栈上已经有同等或更高优先级的基本任务在运行时, 新激活的基本任务不能开始运行,
+ * 否则其栈帧会压在对方之上而对方又先于它继续运行. 由于基本任务不会阻塞, 已开始运行的基本任务
+ * 一定还在就绪列表中, 此时直接继续运行最内层的基本任务即可, 共享栈始终严格按后进先出使用.
+ */
+static void prvPrepareBasicTask(void)
+{
+    TCB_t *const pxTCB = pxCurrentTCB;
+    StackType_t *pxTopOfStack = NULL;
+
+    if ((pxTCB->uxTaskType != tskBASIC_TASK) || (pxTCB->xBasicStarted != pdFALSE))
+    {
+        return;
+    }
+
+    if ((pxBasicTaskNestTop != NULL) &&
+        (pxBasicTaskNestTop->uxPriority >= pxTCB->uxPriority))
+    {
+        pxCurrentTCB = pxBasicTaskNestTop;
+        return;
+    }
+
+    // 新栈帧紧接在被抢占的基本任务保存的上下文之下, 共享栈为空时从栈底(最高地址)开始
+    if (pxBasicTaskNestTop == NULL)
+    {
+        pxTopOfStack = &(xBasicTaskStack[configBASIC_TASK_STACK_SIZE - (uint32_t)1U]);
+    }
+    else
+    {
+        pxTopOfStack = (StackType_t *)pxBasicTaskNestTop->pxTopOfStack - (uint32_t)1U;
+    }
+    pxTopOfStack = (StackType_t *)(((portPOINTER_SIZE_TYPE)pxTopOfStack) & (~((portPOINTER_SIZE_TYPE)DOUBLE_WORD_ALIGNMENT)));
+
+    // 至少要放得下一个完整的初始栈帧
+    configASSERT((pxTopOfStack - portINITIAL_FRAME_WORDS) >= xBasicTaskStack);
+
+    pxTCB->pxTopOfStack = pxPortInitialiseStack(pxTopOfStack,
+                                                (TaskFuntion_t)prvBasicTaskEntry,
+                                                (void *)pxTCB);
+    pxTCB->pxPreemptedBasicTask = pxBasicTaskNestTop;
+    pxTCB->xBasicStarted = pdTRUE;
+    pxBasicTaskNestTop = pxTCB;
+}
+
+/**
+ * @brief 静态创建基本任务, 创建后处于挂起状态, 调用 xTaskActivate() 后才会就绪
+ * @param TaskFuntion_t pxTaskCode: 任务入口, 函数返回即任务结束, 不能调用 vTaskDelay() 等阻塞函数
+ * @param const char *const pcName: 任务名称, 字符串形式
+ * @param void *const pvParameters: 任务形参
+ * @param UbaseType_t uxPriority: 任务优先级, 数值越大优先级越高
+ * @param TCB_t *const pxTaskBuffer: 任务控制块指针
+ * @returns TaskHandle_t xReturn: 任务句柄, 用于指向任务的 TCB
+ */
+TaskHandle_t xTaskCreateBasic(TaskFuntion_t pxTaskCode,
+                              const char *const pcName,
+                              void *const pvParameters,
+                              UBaseType_t uxPriority,
+                              TCB_t *const pxTaskBuffer)
+{
+    TCB_t *pxNewTCB = NULL;
+    TaskHandle_t xReturn = NULL;
+
+    if (pxTaskBuffer != NULL)
+    {
+        pxNewTCB = (TCB_t *)pxTaskBuffer;
+        pxNewTCB->pxStack = xBasicTaskStack;
+        pxNewTCB->uxTaskType = tskBASIC_TASK;
+
+        prvInitialiseNewTask(pxTaskCode,
+                             pcName,
+                             (uint32_t)configBASIC_TASK_STACK_SIZE,
+                             pvParameters,
+                             uxPriority,
+                             &xReturn,
+                             pxNewTCB);
+
+        // 基本任务创建时不加入就绪列表, 但列表仍需在第一个任务创建时初始化
+        taskENTER_CRITICAL();
+        {
+            uxCurrentNumberOfTasks++;
+
+            if (uxCurrentNumberOfTasks == (UBaseType_t)1)
+            {
+                prvInitialiseTaskLists();
+            }
+
+#if (configGENERATE_RUN_TIME_STATS == 1)
+            prvAddTaskToCreatedList(pxNewTCB);
+#endif
+            traceTASK_CREATE(pxNewTCB);
+        }
+        taskEXIT_CRITICAL();
+    }
+
+    return xReturn;
+}
+
+/**
+ * @brief 激活基本任务, 将其加入就绪列表, 任务运行结束后可再次激活
+ * @param TaskHandle_t xTaskToActivate: 基本任务句柄
+ * @returns BaseType_t: pdPASS 激活成功, pdFAIL 任务已处于激活状态
+ */
+BaseType_t xTaskActivate(TaskHandle_t xTaskToActivate)
+{
+    TCB_t *const pxTCB = (TCB_t *)xTaskToActivate;
+    BaseType_t xReturn = pdFAIL;
+
+    configASSERT(pxTCB->uxTaskType == tskBASIC_TASK);
+
+    taskENTER_CRITICAL();
+    {
+        if (pxTCB->xStateListItem.pvContainer == NULL)
+        {
+            prvAddTaskToReadyList(pxTCB);
+            xReturn = pdPASS;
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    if ((xReturn != pdFAIL) &&
+        (pxCurrentTCB != NULL) &&
+        (pxTCB->uxPriority > pxCurrentTCB->uxPriority))
+    {
+        taskYIELD();
+    }
+
+    return xReturn;
+}
+
+/**
+ * @brief 在中断中激活基本任务
+ * @param TaskHandle_t xTaskToActivate: 基本任务句柄
+ * @param BaseType_t *const pxHigherPriorityTaskWoken: 被激活任务优先级高于当前任务时置为 pdTRUE, 中断退出前应调用 portYIELD()
+ * @returns BaseType_t: pdPASS 激活成功, pdFAIL 任务已处于激活状态
+ */
+BaseType_t xTaskActivateFromISR(TaskHandle_t xTaskToActivate,
+                                BaseType_t *const pxHigherPriorityTaskWoken)
+{
+    TCB_t *const pxTCB = (TCB_t *)xTaskToActivate;
+    BaseType_t xReturn = pdFAIL;
+    uint32_t ulSavedInterruptStatus = 0;
+
+    configASSERT(pxTCB->uxTaskType == tskBASIC_TASK);
+
+    ulSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+    {
+        if (pxTCB->xStateListItem.pvContainer == NULL)
+        {
+            prvAddTaskToReadyList(pxTCB);
+            xReturn = pdPASS;
+
+            if ((pxHigherPriorityTaskWoken != NULL) &&
+                (pxTCB->uxPriority > pxCurrentTCB->uxPriority))
+            {
+                *pxHigherPriorityTaskWoken = pdTRUE;
+            }
+        }
+    }
+    taskEXIT_CRITICAL_FROM_ISR(ulSavedInterruptStatus);
+
+    return xReturn;
+}
+
 #endif
 /******************************************************************************/
 
@@ -322,6 +631,11 @@ void vTaskStartScheduler(void)
     xNextTaskUnblockTime = portMAX_DELAY;
     xTickCount = 0U;
 
+#if (configGENERATE_RUN_TIME_STATS == 1)
+    // 第一个任务的运行时间从这里开始计算, 移植层使能周期计数器时不清零计数值, 第一次切换得到的间隔仍然正确
+    ulTaskSwitchedInTime = portGET_CYCLE_COUNT();
+#endif
+
 #if 0
     // 目前不支持按优先级调度, 先指定一个最先运行的任务
     pxCurrentTCB = &Task1TCB;
@@ -404,8 +718,23 @@ void vTaskSwitchContext(void)
 /**
  * @brief 上下文切换, 更新pxCurrentTCB
  */
-void vTaskSwitchContext(void)
+portDONT_DISCARD void vTaskSwitchContext(void)
 {
+#if (configGENERATE_RUN_TIME_STATS == 1)
+    // 每次切换只做一次读数, 一次减法和两次累加, 开销与任务数无关.
+    // 周期计数器 32 位回绕时无符号相减仍然正确: 时基中断每个周期都会触发一次切换, 两次读数的间隔远小于回绕周期
+    {
+        const uint32_t ulNow = portGET_CYCLE_COUNT();
+        const uint32_t ulElapsed = ulNow - ulTaskSwitchedInTime;
+
+        ulTaskSwitchedInTime = ulNow;
+        pxCurrentTCB->ulRunTimeCounter += ulElapsed;
+        ulTotalRunTime += ulElapsed;
+    }
+#endif
+
+    traceTASK_SWITCHED_OUT();
+
 #ifndef DEBUG___
     taskSELECT_HIGHEST_PRIORITY_TASK();
 #else
@@ -426,9 +755,14 @@ void vTaskSwitchContext(void)
             }
             pxCurrentTCB = (pxConstList)->pxIndex->pvOwner;
         } while (0);
-        uxTopReadyPriority = uxTopPriority;
     } while (0);
 #endif
+
+#if (configUSE_BASIC_TASKS == 1)
+    prvPrepareBasicTask();
+#endif
+
+    traceTASK_SWITCHED_IN();
 }
 #endif
 /******************************************************************************/
@@ -444,9 +778,766 @@ void vTaskDelay(const TickType_t xTicksToDelay)
     // uxListRemove(&(pxTCB->xStateListItem));
     // taskRESET_READY_PRIORITY(pxTCB->uxPriority);
 
-    // 将任务插入到延时列表
-    prvAddCurrentTaskToDelayedList(xTicksToDelay);
+#if (configUSE_BASIC_TASKS == 1)
+    // 基本任务共享任务栈, 不能阻塞
+    configASSERT(pxCurrentTCB->uxTaskType != tskBASIC_TASK);
+#endif
+
+    // 将任务插入到延时列表, 没有事件能唤醒延时的任务, portMAX_DELAY 也按时基数延时, 不能变成永久阻塞
+    prvAddCurrentTaskToDelayedList(xTicksToDelay, pdFALSE);
 
     taskYIELD();
 }
 /******************************************************************************/
+
+/******************************************************************************/
+/**
+ * @brief 更新系统时基, 由移植层的时基中断调用, 调用时中断已屏蔽
+ */
+void xTaskIncrementTick(void)
+{
+    TCB_t *pxTCB = NULL;
+    TickType_t xItemValue = 0;
+
+    const TickType_t xConstTickCount = xTickCount + 1;
+    xTickCount = xConstTickCount;
+
+    traceTASK_INCREMENT_TICK(xConstTickCount);
+
+    if (xConstTickCount == (TickType_t)0U)
+    {
+        // 如果系统时基计数器 xTickCount 溢出，则切换延时列表
+        taskSWITCH_DELAYED_LISTS();
+    }
+
+#if (configUSE_TICK_HOOK == 1)
+    vApplicationTickHook();
+#endif
+
+    // 有任务延时到期
+    if (xConstTickCount >= xNextTaskUnblockTime)
+    {
+        for (;;)
+        {
+            if (listLIST_IS_EMPTY(pxDelayedTaskList) != pdFALSE)
+            {
+                // 延时列表为空
+                xNextTaskUnblockTime = portMAX_DELAY;
+                break;
+            }
+            else
+            {
+                pxTCB = (TCB_t *)listGET_OWNER_OF_HEAD_ENTRY(pxDelayedTaskList);
+                xItemValue = listGET_LIST_ITEM_VALUE(pxTCB);
+
+                // 直到将延时列表中所有延时到期的任务移除才跳出 for 循环
+                if (xConstTickCount < xItemValue)
+                {
+                    xNextTaskUnblockTime = xItemValue;
+                    break;
+                }
+
+                // 将任务从延时列表移除, 消除等待状态
+                (void)uxListRemove(&(pxTCB->xStateListItem));
+
+                // 等待内核对象超时, 同时将任务从对象的等待列表移除
+                if (pxTCB->xEventListItem.pvContainer != NULL)
+                {
+                    (void)uxListRemove(&(pxTCB->xEventListItem));
+                }
+
+                // 将解除等待的任务添加到就绪列表
+                prvAddTaskToReadyList(pxTCB);
+            }
+        }
+    }
+
+#if (configUSE_ACTIVE_OBJECTS == 1)
+    // 时间事件服务
+    vActiveObjectTickFromISR();
+#endif
+
+#if (configUSE_WORK_QUEUES == 1)
+    // 延时工作服务
+    vWorkQueueTickFromISR();
+#endif
+
+    portYIELD();
+}
+
+#if (configUSE_VIRTUAL_TIME == 1)
+/**
+ * @brief 私有函数, 用候选值更新最近事件的距离
+ * @param TickType_t *const pxTicks: 当前最近事件的距离, 0 表示还没有事件
+ * @param const TickType_t xCandidate: 候选事件的距离, 0 表示没有事件
+ */
+static void prvUpdateTicksToNextEvent(TickType_t *const pxTicks, const TickType_t xCandidate)
+{
+    if ((xCandidate != (TickType_t)0U) &&
+        ((*pxTicks == (TickType_t)0U) || (xCandidate < *pxTicks)))
+    {
+        *pxTicks = xCandidate;
+    }
+}
+
+/**
+ * @brief 距离下一个需要处理的 tick 还有多少个 tick: 任务延时到期, 时间事件到期, 延时工作到期,
+ *        或者溢出列表中有等待者时 xTickCount 溢出. 调用时中断已屏蔽
+ * @returns TickType_t: 0 表示没有任何定时事件, 所有阻塞的任务都在无限期等待
+ */
+TickType_t xTaskGetTicksToNextEvent(void)
+{
+    const TickType_t xConstTickCount = xTickCount;
+    TickType_t xTicks = 0U;
+
+    if (listLIST_IS_EMPTY(pxDelayedTaskList) == pdFALSE)
+    {
+        xTicks = xNextTaskUnblockTime - xConstTickCount;
+    }
+
+    // 溢出列表中的任务要等 xTickCount 溢出切换延时列表之后才能处理
+    if (listLIST_IS_EMPTY(pxOverflowDelayedTaskList) == pdFALSE)
+    {
+        prvUpdateTicksToNextEvent(&xTicks,
+                                  (xConstTickCount == (TickType_t)0U) ? portMAX_DELAY : (TickType_t)(0U - xConstTickCount));
+    }
+
+#if (configUSE_ACTIVE_OBJECTS == 1)
+    prvUpdateTicksToNextEvent(&xTicks, xActiveObjectTicksToNextEvent());
+#endif
+
+#if (configUSE_WORK_QUEUES == 1)
+    prvUpdateTicksToNextEvent(&xTicks, xWorkQueueTicksToNextEvent());
+#endif
+
+    return xTicks;
+}
+
+/**
+ * @brief 时基直接跳过若干个 tick, 跳过的 tick 中不能有任何事件, 即 xTicksToJump 小于 xTaskGetTicksToNextEvent().
+ *        调用后再调用一次 xTaskIncrementTick() 处理到期的事件. 调用时中断已屏蔽
+ * @param const TickType_t xTicksToJump: 跳过的 tick 数
+ */
+void vTaskStepTick(const TickType_t xTicksToJump)
+{
+    // 不能越过延时到期时刻, 也不能越过 0 而漏掉延时列表切换
+    configASSERT((xTickCount + xTicksToJump) >= xTickCount);
+    configASSERT((listLIST_IS_EMPTY(pxDelayedTaskList) != pdFALSE) ||
+                 ((xTickCount + xTicksToJump) < xNextTaskUnblockTime));
+
+    xTickCount += xTicksToJump;
+
+#if (configUSE_ACTIVE_OBJECTS == 1)
+    vActiveObjectStepTick(xTicksToJump);
+#endif
+}
+#endif
+/******************************************************************************/
+
+/******************************************************************************/
+/**
+ * @brief 将当前任务挂到内核对象的等待列表上并阻塞, 需在临界段内调用, 调用后需 taskYIELD()
+ * @param List_t *const pxEventList: 内核对象的等待列表
+ * @param const TickType_t xTicksToWait: 最长等待时间, portMAX_DELAY 表示无限期等待
+ */
+void vTaskPlaceOnEventList(List_t *const pxEventList, const TickType_t xTicksToWait)
+{
+#if (configUSE_BASIC_TASKS == 1)
+    // 基本任务共享任务栈, 不能阻塞
+    configASSERT(pxCurrentTCB->uxTaskType != tskBASIC_TASK);
+#endif
+
+    // 按优先级排序插入, 唤醒时总是从列表头部取出优先级最高的任务
+    vListInsert(pxEventList, &(pxCurrentTCB->xEventListItem));
+
+    prvAddCurrentTaskToDelayedList(xTicksToWait, pdTRUE);
+}
+
+/**
+ * @brief 唤醒等待列表中优先级最高的任务, 需在临界段或中断中调用, 且等待列表不能为空
+ * @param const List_t *const pxEventList: 内核对象的等待列表
+ * @returns BaseType_t: 被唤醒任务的优先级高于当前任务时返回 pdTRUE, 调用者应触发任务切换
+ */
+BaseType_t xTaskRemoveFromEventList(const List_t *const pxEventList)
+{
+    return xTaskRemoveFromEventListItem(listGET_HEAD_ENTRY(pxEventList));
+}
+
+/**
+ * @brief 唤醒等待列表中指定的任务, 用于不总是唤醒列表头部任务的场合, 需在临界段或中断中调用
+ * @param ListItem_t *const pxEventListItem: 被唤醒任务的 xEventListItem, 必须在某个等待列表中
+ * @returns BaseType_t: 被唤醒任务的优先级高于当前任务时返回 pdTRUE, 调用者应触发任务切换
+ */
+BaseType_t xTaskRemoveFromEventListItem(ListItem_t *const pxEventListItem)
+{
+    TCB_t *pxUnblockedTCB = NULL;
+
+    pxUnblockedTCB = (TCB_t *)listGET_LIST_ITEM_OWNER(pxEventListItem);
+    (void)uxListRemove(pxEventListItem);
+
+    // 有限期等待的任务同时在延时列表中, xNextTaskUnblockTime 不必更新, 到期时 tick 会重新计算
+    if (pxUnblockedTCB->xStateListItem.pvContainer != NULL)
+    {
+        (void)uxListRemove(&(pxUnblockedTCB->xStateListItem));
+    }
+    prvAddTaskToReadyList(pxUnblockedTCB);
+
+    return (pxUnblockedTCB->uxPriority > pxCurrentTCB->uxPriority) ? pdTRUE : pdFALSE;
+}
+
+/**
+ * @brief 记录开始等待的时刻
+ * @param TimeOut_t *const pxTimeOut
+ */
+void vTaskSetTimeOutState(TimeOut_t *const pxTimeOut)
+{
+    pxTimeOut->xOverflowCount = xNumOfOverflows;
+    pxTimeOut->xTimeOnEntering = xTickCount;
+}
+
+/**
+ * @brief 检查等待是否超时, 未超时则将 *pxTicksToWait 更新为剩余的等待时间, 需在临界段内调用
+ * @param TimeOut_t *const pxTimeOut: vTaskSetTimeOutState() 记录的时刻
+ * @param TickType_t *const pxTicksToWait: 剩余等待时间
+ * @returns BaseType_t: pdTRUE 已超时, pdFALSE 未超时
+ */
+BaseType_t xTaskCheckForTimeOut(TimeOut_t *const pxTimeOut, TickType_t *const pxTicksToWait)
+{
+    const TickType_t xConstTickCount = xTickCount;
+    const TickType_t xElapsedTime = xConstTickCount - pxTimeOut->xTimeOnEntering;
+
+    if (*pxTicksToWait == portMAX_DELAY)
+    {
+        return pdFALSE;
+    }
+
+    // xTickCount 已经溢出并再次越过了记录时刻, 等待时间必然已经超过一整圈
+    if ((xNumOfOverflows != pxTimeOut->xOverflowCount) &&
+        (xConstTickCount >= pxTimeOut->xTimeOnEntering))
+    {
+        *pxTicksToWait = 0;
+        return pdTRUE;
+    }
+
+    if (xElapsedTime < *pxTicksToWait)
+    {
+        *pxTicksToWait -= xElapsedTime;
+        vTaskSetTimeOutState(pxTimeOut);
+        return pdFALSE;
+    }
+
+    *pxTicksToWait = 0;
+    return pdTRUE;
+}
+
+/**
+ * @brief 获取当前任务的句柄
+ * @returns TaskHandle_t
+ */
+TaskHandle_t xTaskGetCurrentTaskHandle(void)
+{
+    return (TaskHandle_t)pxCurrentTCB;
+}
+
+/**
+ * @brief 获取空闲任务句柄, 调度器启动后有效
+ * @returns TaskHandle_t
+ */
+TaskHandle_t xTaskGetIdleTaskHandle(void)
+{
+    return xIdleTaskHandle;
+}
+/******************************************************************************/
+
+/******************************************************************************/
+#if (configGENERATE_RUN_TIME_STATS == 1)
+/**
+ * @brief 获取任务的累计运行时间, 当前任务本次切入后的运行时间在下一次切换时才计入
+ * @param TaskHandle_t xTask: 任务句柄, 为 NULL 时表示当前任务
+ * @returns configRUN_TIME_COUNTER_TYPE: 累计运行时间, 单位为周期计数器的计数, 频率为 portCYCLE_COUNTER_HZ
+ */
+configRUN_TIME_COUNTER_TYPE ulTaskGetRunTimeCounter(TaskHandle_t xTask)
+{
+    const TCB_t *const pxTCB = (xTask == NULL) ? pxCurrentTCB : (TCB_t *)xTask;
+    configRUN_TIME_COUNTER_TYPE ulCounter = 0U;
+
+    // 累计值可能比字长宽, 读取时不能被切换打断
+    taskENTER_CRITICAL();
+    {
+        ulCounter = pxTCB->ulRunTimeCounter;
+    }
+    taskEXIT_CRITICAL();
+
+    return ulCounter;
+}
+
+/**
+ * @brief 获取空闲任务的累计运行时间, 与 ulTaskGetTotalRunTime() 之比即为空闲率, CPU 负载 = 1 - 空闲率
+ * @returns configRUN_TIME_COUNTER_TYPE: 累计运行时间, 单位为周期计数器的计数
+ */
+configRUN_TIME_COUNTER_TYPE ulTaskGetIdleRunTimeCounter(void)
+{
+    return ulTaskGetRunTimeCounter(xIdleTaskHandle);
+}
+
+/**
+ * @brief 获取调度器启动以来所有任务累计运行时间之和
+ * @returns configRUN_TIME_COUNTER_TYPE: 累计运行时间, 单位为周期计数器的计数
+ */
+configRUN_TIME_COUNTER_TYPE ulTaskGetTotalRunTime(void)
+{
+    configRUN_TIME_COUNTER_TYPE ulTotal = 0U;
+
+    taskENTER_CRITICAL();
+    {
+        ulTotal = ulTotalRunTime;
+    }
+    taskEXIT_CRITICAL();
+
+    return ulTotal;
+}
+
+/**
+ * @brief 私有函数, 向缓冲区追加字符串, 缓冲区满时截断
+ * @param char *pcBuffer: 写入位置
+ * @param const char *const pcEnd: 缓冲区末尾, 需保留一个字节写结束符
+ * @param const char *pcString: 字符串
+ * @returns char *: 新的写入位置
+ */
+static char *prvWriteString(char *pcBuffer, const char *const pcEnd, const char *pcString)
+{
+    while ((*pcString != '\0') && (pcBuffer < pcEnd))
+    {
+        *pcBuffer++ = *pcString++;
+    }
+
+    return pcBuffer;
+}
+
+/**
+ * @brief 私有函数, 向缓冲区追加十进制无符号数, 缓冲区满时截断
+ * @param char *pcBuffer: 写入位置
+ * @param const char *const pcEnd: 缓冲区末尾
+ * @param configRUN_TIME_COUNTER_TYPE ulValue: 数值
+ * @returns char *: 新的写入位置
+ */
+static char *prvWriteUnsigned(char *pcBuffer, const char *const pcEnd, configRUN_TIME_COUNTER_TYPE ulValue)
+{
+    // 64 位无符号数最多 20 位十进制数
+    char cDigits[21];
+    UBaseType_t x = sizeof(cDigits) - 1U;
+
+    cDigits[x] = '\0';
+    do
+    {
+        cDigits[--x] = (char)('0' + (char)(ulValue % 10U));
+        ulValue /= 10U;
+    } while ((ulValue != 0U) && (x > 0U));
+
+    return prvWriteString(pcBuffer, pcEnd, &(cDigits[x]));
+}
+
+/**
+ * @brief 输出所有任务的运行时间统计表, 每个任务一行: 名称, 累计运行时间, 占总运行时间的百分比(不足 1% 显示 <1%).
+ *        统计期间任务仍在运行, 各行之和与总数可能略有出入. 只在任务中调用, 格式化期间不关中断
+ * @param char *pcWriteBuffer: 输出缓冲区, 结果为以 '\0' 结尾的字符串
+ * @param size_t xBufferLength: 缓冲区长度, 单位为字节, 每个任务约需 configMAX_TASK_NAME_LEN + 30 字节, 不足时截断
+ */
+void vTaskGetRunTimeStats(char *pcWriteBuffer, size_t xBufferLength)
+{
+    const char *const pcEnd = pcWriteBuffer + xBufferLength - 1U;
+    const TCB_t *pxTCB = pxFirstCreatedTask;
+    configRUN_TIME_COUNTER_TYPE ulCounter = 0U;
+    configRUN_TIME_COUNTER_TYPE ulOnePercent = 0U;
+    UBaseType_t x = 0U;
+
+    if (xBufferLength == 0U)
+    {
+        return;
+    }
+
+    // 先除以 100, 计算百分比时不会溢出
+    ulOnePercent = ulTaskGetTotalRunTime() / 100U;
+
+    for (; pxTCB != NULL; pxTCB = pxTCB->pxNextCreatedTask)
+    {
+        ulCounter = ulTaskGetRunTimeCounter((TaskHandle_t)pxTCB);
+
+        // 名称左对齐, 补齐到固定宽度
+        x = (UBaseType_t)(prvWriteString(pcWriteBuffer, pcEnd, pxTCB->pcTaskName) - pcWriteBuffer);
+        pcWriteBuffer += x;
+        for (; (x < (UBaseType_t)configMAX_TASK_NAME_LEN) && (pcWriteBuffer < pcEnd); x++)
+        {
+            *pcWriteBuffer++ = ' ';
+        }
+
+        pcWriteBuffer = prvWriteString(pcWriteBuffer, pcEnd, "\t");
+        pcWriteBuffer = prvWriteUnsigned(pcWriteBuffer, pcEnd, ulCounter);
+        pcWriteBuffer = prvWriteString(pcWriteBuffer, pcEnd, "\t");
+        if ((ulOnePercent != 0U) && ((ulCounter / ulOnePercent) != 0U))
+        {
+            pcWriteBuffer = prvWriteUnsigned(pcWriteBuffer, pcEnd, ulCounter / ulOnePercent);
+            pcWriteBuffer = prvWriteString(pcWriteBuffer, pcEnd, "%\n");
+        }
+        else
+        {
+            pcWriteBuffer = prvWriteString(pcWriteBuffer, pcEnd, "<1%\n");
+        }
+    }
+
+    *pcWriteBuffer = '\0';
+}
+#endif
+/******************************************************************************/
+
+/******************************************************************************/
+#if (configUSE_MUTEXES == 1)
+/**
+ * @brief 私有函数, 修改任务的当前优先级, 任务在就绪列表中时同时移动到新优先级的就绪列表, 需在临界段内调用
+ * @param TCB_t *const pxTCB
+ * @param const UBaseType_t uxNewPriority
+ */
+static void prvSetEffectivePriority(TCB_t *const pxTCB, const UBaseType_t uxNewPriority)
+{
+    const UBaseType_t uxOldPriority = pxTCB->uxPriority;
+
+    // 排序值只在任务不在等待列表中时更新, 已在等待列表中的任务保持原来的位置
+    if (pxTCB->xEventListItem.pvContainer == NULL)
+    {
+        listSET_LIST_ITEM_VALUE(&(pxTCB->xEventListItem),
+                                (TickType_t)configMAX_PRIORITIES - (TickType_t)uxNewPriority);
+    }
+
+    if (pxTCB->xStateListItem.pvContainer == (void *)&(pxReadyTasksLists[uxOldPriority]))
+    {
+        if (uxListRemove(&(pxTCB->xStateListItem)) == (UBaseType_t)0)
+        {
+            portRESET_READY_PRIORITY(uxOldPriority, uxTopReadyPriority);
+        }
+        pxTCB->uxPriority = uxNewPriority;
+        prvAddTaskToReadyList(pxTCB);
+    }
+    else
+    {
+        // 阻塞中的任务只改优先级, 唤醒时按新优先级加入就绪列表
+        pxTCB->uxPriority = uxNewPriority;
+    }
+}
+
+/**
+ * @brief 私有函数, 持有互斥量的任务应有的优先级, 即基础优先级, 继承的优先级和仍持有的最高天花板优先级中的最高者
+ * @param TCB_t *const pxTCB
+ * @returns UBaseType_t
+ */
+static UBaseType_t prvGetMutexHolderPriority(TCB_t *const pxTCB)
+{
+    UBaseType_t uxPriority = pxTCB->uxBasePriority;
+    UBaseType_t uxCeilingPriority = tskIDLE_PRIORITY;
+
+    if (pxTCB->uxInheritedPriority > uxPriority)
+    {
+        uxPriority = pxTCB->uxInheritedPriority;
+    }
+
+    // 列表按天花板优先级的反序排序, 头部即最高的天花板
+    if (listLIST_IS_EMPTY(&(pxTCB->xCeilingMutexesHeld)) == pdFALSE)
+    {
+        uxCeilingPriority = (UBaseType_t)configMAX_PRIORITIES -
+                            (UBaseType_t)listGET_ITEM_VALUE_OF_HEAD_ENTRY(&(pxTCB->xCeilingMutexesHeld));
+
+        if (uxCeilingPriority > uxPriority)
+        {
+            uxPriority = uxCeilingPriority;
+        }
+    }
+
+    return uxPriority;
+}
+
+/**
+ * @brief 私有函数, 持有者释放一个互斥量, 持有计数减 1 并重新计算优先级, 需在临界段内调用
+ * @param TCB_t *const pxTCB: 互斥量持有者
+ * @returns BaseType_t: pdTRUE 优先级被降低, 调用者应触发任务切换
+ */
+static BaseType_t prvMutexReleased(TCB_t *const pxTCB)
+{
+    UBaseType_t uxNewPriority = 0U;
+
+    configASSERT(pxTCB->uxMutexesHeld != (UBaseType_t)0U);
+    pxTCB->uxMutexesHeld--;
+
+    // 仍持有其他互斥量时无法确定继承的优先级来自哪个互斥量上的等待者, 保持不变, 全部释放后才清零
+    if (pxTCB->uxMutexesHeld == (UBaseType_t)0U)
+    {
+        pxTCB->uxInheritedPriority = tskIDLE_PRIORITY;
+    }
+
+    uxNewPriority = prvGetMutexHolderPriority(pxTCB);
+
+    if (uxNewPriority < pxTCB->uxPriority)
+    {
+        prvSetEffectivePriority(pxTCB, uxNewPriority);
+        return pdTRUE;
+    }
+
+    return pdFALSE;
+}
+
+/**
+ * @brief 当前任务获得互斥量, 持有计数加 1, 需在临界段内调用
+ * @returns TaskHandle_t: 当前任务句柄, 作为互斥量的持有者
+ */
+TaskHandle_t pvTaskIncrementMutexHeldCount(void)
+{
+    if (pxCurrentTCB != NULL)
+    {
+        pxCurrentTCB->uxMutexesHeld++;
+    }
+
+    return (TaskHandle_t)pxCurrentTCB;
+}
+
+/**
+ * @brief 当前任务因互斥量阻塞前调用, 持有者优先级低于当前任务时将其提升到当前任务的优先级, 需在临界段内调用
+ * @param TaskHandle_t const pxMutexHolder: 互斥量持有者
+ * @returns BaseType_t: pdTRUE 发生了优先级继承
+ */
+BaseType_t xTaskPriorityInherit(TaskHandle_t const pxMutexHolder)
+{
+    TCB_t *const pxMutexHolderTCB = (TCB_t *)pxMutexHolder;
+
+    if (pxMutexHolderTCB == NULL)
+    {
+        return pdFALSE;
+    }
+
+    // 持有者此时可能因天花板互斥量不低于当前任务, 仍要记下, 天花板释放后不能降到当前任务之下
+    if (pxMutexHolderTCB->uxInheritedPriority < pxCurrentTCB->uxPriority)
+    {
+        pxMutexHolderTCB->uxInheritedPriority = pxCurrentTCB->uxPriority;
+    }
+
+    if (pxMutexHolderTCB->uxPriority < pxCurrentTCB->uxPriority)
+    {
+        prvSetEffectivePriority(pxMutexHolderTCB, pxCurrentTCB->uxPriority);
+        return pdTRUE;
+    }
+
+    // 持有者此前已经继承了不低于当前任务的优先级
+    return (pxMutexHolderTCB->uxBasePriority < pxCurrentTCB->uxPriority) ? pdTRUE : pdFALSE;
+}
+
+/**
+ * @brief 持有者释放互斥量, 持有计数减 1, 优先级降到基础优先级和仍持有的天花板优先级中的较高者,
+ *        仍持有其他互斥量时保留继承的优先级, 需在临界段内调用
+ * @param TaskHandle_t const pxMutexHolder: 互斥量持有者, 即当前任务
+ * @returns BaseType_t: pdTRUE 优先级被降低, 调用者应触发任务切换
+ */
+BaseType_t xTaskPriorityDisinherit(TaskHandle_t const pxMutexHolder)
+{
+    TCB_t *const pxTCB = (TCB_t *)pxMutexHolder;
+
+    if (pxTCB == NULL)
+    {
+        return pdFALSE;
+    }
+
+    return prvMutexReleased(pxTCB);
+}
+
+/**
+ * @brief 当前任务获得优先级天花板互斥量后调用, 将互斥量记入持有列表并提升到天花板优先级, 需在临界段内调用
+ *
+ * 持有计数由 pvTaskIncrementMutexHeldCount() 增加, 不持有其他天花板互斥量时只在就绪列表之间移动一次, 时间固定
+ *
+ * @param ListItem_t *const pxCeilingListItem: 互斥量的 xCeilingListItem, 排序值为 configMAX_PRIORITIES - 天花板优先级
+ */
+void vTaskPriorityCeilingRaise(ListItem_t *const pxCeilingListItem)
+{
+    const UBaseType_t uxCeilingPriority = (UBaseType_t)configMAX_PRIORITIES -
+                                          (UBaseType_t)pxCeilingListItem->xItemValue;
+
+    // 基础优先级高于天花板说明天花板设置错误
+    configASSERT(pxCurrentTCB->uxBasePriority <= uxCeilingPriority);
+
+    vListInsert(&(pxCurrentTCB->xCeilingMutexesHeld), pxCeilingListItem);
+
+    if (uxCeilingPriority > pxCurrentTCB->uxPriority)
+    {
+        prvSetEffectivePriority(pxCurrentTCB, uxCeilingPriority);
+    }
+}
+
+/**
+ * @brief 当前任务释放优先级天花板互斥量, 持有计数减 1, 重新计算优先级, 需在临界段内调用
+ *
+ * 释放顺序不必与获得顺序相反, 优先级总是降到基础优先级, 继承的优先级和仍持有的最高天花板优先级中的最高者
+ *
+ * @param ListItem_t *const pxCeilingListItem: 互斥量的 xCeilingListItem
+ * @returns BaseType_t: pdTRUE 优先级被降低, 调用者应触发任务切换
+ */
+BaseType_t xTaskPriorityCeilingRestore(ListItem_t *const pxCeilingListItem)
+{
+    configASSERT(pxCeilingListItem->pvContainer == (void *)&(pxCurrentTCB->xCeilingMutexesHeld));
+
+    (void)uxListRemove(pxCeilingListItem);
+
+    return prvMutexReleased(pxCurrentTCB);
+}
+
+/**
+ * @brief 等待互斥量超时后, 将持有者的优先级降到剩余等待者中的最高优先级, 需在临界段内调用
+ * @param TaskHandle_t const pxMutexHolder: 互斥量持有者
+ * @param UBaseType_t uxHighestPriorityWaitingTask: 剩余等待者的最高优先级, 没有等待者时为 tskIDLE_PRIORITY
+ */
+void vTaskPriorityDisinheritAfterTimeout(TaskHandle_t const pxMutexHolder,
+                                         UBaseType_t uxHighestPriorityWaitingTask)
+{
+    TCB_t *const pxTCB = (TCB_t *)pxMutexHolder;
+    UBaseType_t uxPriorityToUse = 0U;
+
+    if (pxTCB == NULL)
+    {
+        return;
+    }
+
+    // 持有多个互斥量时无法确定其他互斥量上的等待者, 保持当前优先级
+    if (pxTCB->uxMutexesHeld == (UBaseType_t)1U)
+    {
+        pxTCB->uxInheritedPriority = uxHighestPriorityWaitingTask;
+        uxPriorityToUse = prvGetMutexHolderPriority(pxTCB);
+
+        if (pxTCB->uxPriority != uxPriorityToUse)
+        {
+            prvSetEffectivePriority(pxTCB, uxPriorityToUse);
+        }
+    }
+}
+#endif
+/******************************************************************************/
+
+/******************************************************************************/
+#if (configUSE_TASK_NOTIFICATIONS == 1)
+
+/**
+ * @brief 私有函数, 通知计数值加 1, 若任务正在等待通知则将其就绪, 需在临界段内调用
+ * @param TCB_t *const pxTCB: 被通知的任务
+ * @returns BaseType_t: 被唤醒任务的优先级高于当前任务时返回 pdTRUE
+ */
+static BaseType_t prvNotifyGive(TCB_t *const pxTCB)
+{
+    const uint8_t ucOriginalNotifyState = pxTCB->ucNotifyState;
+
+    pxTCB->ucNotifyState = taskNOTIFICATION_RECEIVED;
+    (pxTCB->ulNotifiedValue)++;
+
+    if (ucOriginalNotifyState != taskWAITING_NOTIFICATION)
+    {
+        return pdFALSE;
+    }
+
+    // 有限期等待的任务在延时列表中, 无限期等待的任务不在任何列表中
+    if (pxTCB->xStateListItem.pvContainer != NULL)
+    {
+        (void)uxListRemove(&(pxTCB->xStateListItem));
+    }
+    prvAddTaskToReadyList(pxTCB);
+
+    return (pxTCB->uxPriority > pxCurrentTCB->uxPriority) ? pdTRUE : pdFALSE;
+}
+
+/**
+ * @brief 向任务发送通知, 通知计数值加 1, 相当于释放一次计数信号量
+ * @param TaskHandle_t xTaskToNotify: 被通知的任务
+ * @returns BaseType_t: 总是返回 pdPASS
+ */
+BaseType_t xTaskNotifyGive(TaskHandle_t xTaskToNotify)
+{
+    taskENTER_CRITICAL();
+    {
+        if (prvNotifyGive((TCB_t *)xTaskToNotify) != pdFALSE)
+        {
+            taskYIELD();
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    return pdPASS;
+}
+
+/**
+ * @brief 在中断中向任务发送通知
+ * @param TaskHandle_t xTaskToNotify: 被通知的任务
+ * @param BaseType_t *const pxHigherPriorityTaskWoken: 唤醒了更高优先级任务时置为 pdTRUE, 中断退出前应调用 portYIELD()
+ */
+void vTaskNotifyGiveFromISR(TaskHandle_t xTaskToNotify,
+                            BaseType_t *const pxHigherPriorityTaskWoken)
+{
+    uint32_t ulSavedInterruptStatus = 0;
+
+    ulSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+    {
+        if ((prvNotifyGive((TCB_t *)xTaskToNotify) != pdFALSE) &&
+            (pxHigherPriorityTaskWoken != NULL))
+        {
+            *pxHigherPriorityTaskWoken = pdTRUE;
+        }
+    }
+    taskEXIT_CRITICAL_FROM_ISR(ulSavedInterruptStatus);
+}
+
+/**
+ * @brief 等待任务通知, 相当于获取计数信号量
+ * @param BaseType_t xClearCountOnExit: pdTRUE 返回前将计数值清零, pdFALSE 返回前将计数值减 1
+ * @param TickType_t xTicksToWait: 计数值为 0 时最长等待时间, portMAX_DELAY 表示无限期等待
+ * @returns uint32_t: 返回前(清零或减 1 之前)的计数值, 为 0 表示超时
+ */
+uint32_t ulTaskNotifyTake(BaseType_t xClearCountOnExit, TickType_t xTicksToWait)
+{
+    uint32_t ulReturn = 0UL;
+
+    taskENTER_CRITICAL();
+    {
+        if (pxCurrentTCB->ulNotifiedValue == 0UL)
+        {
+            pxCurrentTCB->ucNotifyState = taskWAITING_NOTIFICATION;
+
+            if (xTicksToWait > (TickType_t)0)
+            {
+#if (configUSE_BASIC_TASKS == 1)
+                // 基本任务共享任务栈, 不能阻塞
+                configASSERT(pxCurrentTCB->uxTaskType != tskBASIC_TASK);
+#endif
+                prvAddCurrentTaskToDelayedList(xTicksToWait, pdTRUE);
+                taskYIELD();
+            }
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    // 被通知唤醒或等待超时后从这里继续运行
+    taskENTER_CRITICAL();
+    {
+        ulReturn = pxCurrentTCB->ulNotifiedValue;
+
+        if (ulReturn != 0UL)
+        {
+            if (xClearCountOnExit != pdFALSE)
+            {
+                pxCurrentTCB->ulNotifiedValue = 0UL;
+            }
+            else
+            {
+                pxCurrentTCB->ulNotifiedValue = ulReturn - 1UL;
+            }
+        }
+
+        pxCurrentTCB->ucNotifyState = taskNOT_WAITING_NOTIFICATION;
+    }
+    taskEXIT_CRITICAL();
+
+    return ulReturn;
+}
+
+#endif
+/******************************************************************************/
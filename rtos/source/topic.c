@@ -0,0 +1,316 @@
+#include <string.h>
+
+#include "topic.h"
+#include "task.h"
+#include "portmacro.h"
+#include "rtos_config.h"
+#include "projectdefs.h"
+
+#if (configUSE_TOPICS == 1)
+
+/******************************************************************************/
+/**
+ * @brief 初始化主题
+ * @param Topic_t *const pxTopic: 主题
+ * @param const char *const pcName: 主题名称
+ * @param const UBaseType_t uxSampleSize: 每个样本的大小, 单位为字节
+ * @param const UBaseType_t uxQueueSize: 订阅者能回看的历史样本数, 只关心最新值时为 1
+ * @param uint8_t *const pucBuffer: 样本缓冲区, 大小为 topicBUFFER_SIZE(uxSampleSize, uxQueueSize)
+ */
+void vTopicInit(Topic_t *const pxTopic,
+                const char *const pcName,
+                const UBaseType_t uxSampleSize,
+                const UBaseType_t uxQueueSize,
+                uint8_t *const pucBuffer)
+{
+    configASSERT(uxQueueSize >= 1U);
+
+    pxTopic->pcName = pcName;
+    pxTopic->pucBuffer = pucBuffer;
+    pxTopic->uxSampleSize = uxSampleSize;
+    pxTopic->uxQueueSize = uxQueueSize;
+    pxTopic->ulGeneration = 0UL;
+    pxTopic->pxWaitingList = NULL;
+}
+
+/**
+ * @brief 私有函数, 写入样本并唤醒所有等待的订阅者, 需在临界段内调用
+ *
+ * 只关心最新值的订阅者不登记在主题上, 发布的开销与这类订阅者的数量无关
+ *
+ * @param Topic_t *const pxTopic: 主题
+ * @param const void *const pvSample: 样本
+ * @param BaseType_t *const pxHigherPriorityTaskWoken: 唤醒了更高优先级任务时置为 pdTRUE
+ */
+static void prvTopicPublish(Topic_t *const pxTopic,
+                            const void *const pvSample,
+                            BaseType_t *const pxHigherPriorityTaskWoken)
+{
+    const uint32_t ulSample = pxTopic->ulGeneration;
+    const UBaseType_t uxSlot = (UBaseType_t)(ulSample % (pxTopic->uxQueueSize + 1U));
+    TopicSubscriber_t *pxSubscriber = pxTopic->pxWaitingList;
+
+    (void)memcpy(pxTopic->pucBuffer + (uxSlot * pxTopic->uxSampleSize),
+                 pvSample,
+                 (size_t)pxTopic->uxSampleSize);
+
+    // 样本写完之后才能对订阅者可见
+    portMEMORY_BARRIER();
+    pxTopic->ulGeneration = ulSample + 1UL;
+
+    while (pxSubscriber != NULL)
+    {
+        vTaskNotifyGiveFromISR(pxSubscriber->xWaitingTask, pxHigherPriorityTaskWoken);
+        pxSubscriber->xWaitingTask = NULL;
+        pxSubscriber = pxSubscriber->pxNextWaiting;
+    }
+    pxTopic->pxWaitingList = NULL;
+}
+
+/**
+ * @brief 发布样本
+ * @param Topic_t *const pxTopic: 主题
+ * @param const void *const pvSample: 样本, 按值拷贝进主题缓冲区
+ */
+void vTopicPublish(Topic_t *const pxTopic, const void *const pvSample)
+{
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+    taskENTER_CRITICAL();
+    {
+        prvTopicPublish(pxTopic, pvSample, &xHigherPriorityTaskWoken);
+
+        if (xHigherPriorityTaskWoken != pdFALSE)
+        {
+            taskYIELD();
+        }
+    }
+    taskEXIT_CRITICAL();
+}
+
+/**
+ * @brief 在中断中发布样本
+ * @param Topic_t *const pxTopic: 主题
+ * @param const void *const pvSample: 样本, 按值拷贝进主题缓冲区
+ * @param BaseType_t *const pxHigherPriorityTaskWoken: 唤醒了更高优先级任务时置为 pdTRUE, 中断退出前应调用 portYIELD()
+ */
+void vTopicPublishFromISR(Topic_t *const pxTopic,
+                          const void *const pvSample,
+                          BaseType_t *const pxHigherPriorityTaskWoken)
+{
+    uint32_t ulSavedInterruptStatus = 0;
+
+    ulSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+    {
+        prvTopicPublish(pxTopic, pvSample, pxHigherPriorityTaskWoken);
+    }
+    taskEXIT_CRITICAL_FROM_ISR(ulSavedInterruptStatus);
+}
+/******************************************************************************/
+
+/******************************************************************************/
+/**
+ * @brief 订阅主题, 订阅之后只能读到新发布的样本
+ * @param TopicSubscriber_t *const pxSubscriber: 订阅者
+ * @param Topic_t *const pxTopic: 主题
+ */
+void vTopicSubscribe(TopicSubscriber_t *const pxSubscriber, Topic_t *const pxTopic)
+{
+    pxSubscriber->pxTopic = pxTopic;
+    pxSubscriber->ulGeneration = pxTopic->ulGeneration;
+    pxSubscriber->ulLostSamples = 0UL;
+    pxSubscriber->xWaitingTask = NULL;
+    pxSubscriber->pxNextWaiting = NULL;
+}
+
+/**
+ * @brief 查询是否有未读的新样本, 不加锁
+ * @param const TopicSubscriber_t *const pxSubscriber: 订阅者
+ * @returns BaseType_t: pdTRUE 有新样本
+ */
+BaseType_t xTopicUpdated(const TopicSubscriber_t *const pxSubscriber)
+{
+    return (pxSubscriber->pxTopic->ulGeneration != pxSubscriber->ulGeneration) ? pdTRUE : pdFALSE;
+}
+
+/**
+ * @brief 私有函数, 不加锁地拷贝第 ulSample 个样本, 拷贝完成后检查期间该槽位是否被发布者改写
+ * @param const Topic_t *const pxTopic: 主题
+ * @param const uint32_t ulSample: 样本的代数, 必须小于主题当前的 ulGeneration
+ * @param void *const pvBuffer: 样本拷贝到的地址
+ * @returns BaseType_t: pdTRUE 拷贝到的样本完整, pdFALSE 拷贝期间被改写, 需重试
+ */
+static BaseType_t prvCopySample(const Topic_t *const pxTopic,
+                                const uint32_t ulSample,
+                                void *const pvBuffer)
+{
+    const UBaseType_t uxSlots = pxTopic->uxQueueSize + 1U;
+    const UBaseType_t uxSlot = (UBaseType_t)(ulSample % uxSlots);
+
+    (void)memcpy(pvBuffer,
+                 pxTopic->pucBuffer + (uxSlot * pxTopic->uxSampleSize),
+                 (size_t)pxTopic->uxSampleSize);
+
+    portMEMORY_BARRIER();
+
+    // 发布者最多正在写第 ulGeneration 个样本, 只有写到第 ulSample + uxSlots 个样本时才会改写同一槽位
+    return ((pxTopic->ulGeneration - ulSample) < (uint32_t)uxSlots) ? pdTRUE : pdFALSE;
+}
+
+/**
+ * @brief 读取最新的样本, 不加锁, 不屏蔽中断
+ * @param TopicSubscriber_t *const pxSubscriber: 订阅者
+ * @param void *const pvBuffer: 样本拷贝到的地址
+ * @returns BaseType_t: pdTRUE 读取成功, pdFALSE 主题尚未发布过样本
+ */
+BaseType_t xTopicCopyLatest(TopicSubscriber_t *const pxSubscriber, void *const pvBuffer)
+{
+    const Topic_t *const pxTopic = pxSubscriber->pxTopic;
+    uint32_t ulGeneration = 0UL;
+
+    for (;;)
+    {
+        ulGeneration = pxTopic->ulGeneration;
+        portMEMORY_BARRIER();
+
+        if (ulGeneration == 0UL)
+        {
+            return pdFALSE;
+        }
+
+        if (prvCopySample(pxTopic, ulGeneration - 1UL, pvBuffer) != pdFALSE)
+        {
+            pxSubscriber->ulGeneration = ulGeneration;
+            return pdTRUE;
+        }
+    }
+}
+
+/**
+ * @brief 按发布顺序读取下一个未读的样本, 不加锁, 不屏蔽中断
+ *
+ * 未读样本超过 uxQueueSize 个时, 最旧的样本已被覆盖, 跳过的个数累计到 ulLostSamples
+ *
+ * @param TopicSubscriber_t *const pxSubscriber: 订阅者
+ * @param void *const pvBuffer: 样本拷贝到的地址
+ * @returns BaseType_t: pdTRUE 读取成功, pdFALSE 没有未读的样本
+ */
+BaseType_t xTopicCopyNext(TopicSubscriber_t *const pxSubscriber, void *const pvBuffer)
+{
+    const Topic_t *const pxTopic = pxSubscriber->pxTopic;
+    uint32_t ulGeneration = 0UL;
+
+    for (;;)
+    {
+        ulGeneration = pxTopic->ulGeneration;
+        portMEMORY_BARRIER();
+
+        if (ulGeneration == pxSubscriber->ulGeneration)
+        {
+            return pdFALSE;
+        }
+
+        if ((ulGeneration - pxSubscriber->ulGeneration) > (uint32_t)pxTopic->uxQueueSize)
+        {
+            pxSubscriber->ulLostSamples += (ulGeneration - pxSubscriber->ulGeneration) -
+                                           (uint32_t)pxTopic->uxQueueSize;
+            pxSubscriber->ulGeneration = ulGeneration - (uint32_t)pxTopic->uxQueueSize;
+        }
+
+        if (prvCopySample(pxTopic, pxSubscriber->ulGeneration, pvBuffer) != pdFALSE)
+        {
+            pxSubscriber->ulGeneration++;
+            return pdTRUE;
+        }
+    }
+}
+
+/**
+ * @brief 私有函数, 超时或提前醒来时将订阅者从主题的等待链表中摘除, 需在临界段内调用
+ * @param TopicSubscriber_t *const pxSubscriber: 订阅者
+ */
+static void prvTopicRemoveWaiting(TopicSubscriber_t *const pxSubscriber)
+{
+    TopicSubscriber_t **ppxLink = NULL;
+
+    // 已被发布者唤醒时不在链表中
+    if (pxSubscriber->xWaitingTask == NULL)
+    {
+        return;
+    }
+
+    for (ppxLink = &(pxSubscriber->pxTopic->pxWaitingList);
+         *ppxLink != NULL;
+         ppxLink = &((*ppxLink)->pxNextWaiting))
+    {
+        if (*ppxLink == pxSubscriber)
+        {
+            *ppxLink = pxSubscriber->pxNextWaiting;
+            break;
+        }
+    }
+    pxSubscriber->xWaitingTask = NULL;
+}
+
+/**
+ * @brief 等待新样本, 由发布者通过任务通知唤醒
+ *
+ * 等待使用当前任务的通知计数值, 返回时计数值已被清零, 等待期间其他来源发来的通知会丢失,
+ * 同一任务不能同时用任务通知做其他同步. 计数值中残留的通知只会让任务提前醒来一次, 之后继续等待剩余的时间
+ *
+ * @param TopicSubscriber_t *const pxSubscriber: 订阅者
+ * @param TickType_t xTicksToWait: 最长等待时间, portMAX_DELAY 表示无限期等待
+ * @returns BaseType_t: pdTRUE 有新样本, pdFALSE 等待时间已到仍没有新样本
+ */
+BaseType_t xTopicWait(TopicSubscriber_t *const pxSubscriber, TickType_t xTicksToWait)
+{
+    Topic_t *const pxTopic = pxSubscriber->pxTopic;
+    BaseType_t xEntryTimeSet = pdFALSE;
+    TimeOut_t xTimeOut;
+
+    for (;;)
+    {
+        taskENTER_CRITICAL();
+        {
+            if (pxTopic->ulGeneration != pxSubscriber->ulGeneration)
+            {
+                taskEXIT_CRITICAL();
+                return pdTRUE;
+            }
+
+            if (xTicksToWait == (TickType_t)0)
+            {
+                taskEXIT_CRITICAL();
+                return pdFALSE;
+            }
+
+            if (xEntryTimeSet == pdFALSE)
+            {
+                vTaskSetTimeOutState(&xTimeOut);
+                xEntryTimeSet = pdTRUE;
+            }
+            else if (xTaskCheckForTimeOut(&xTimeOut, &xTicksToWait) != pdFALSE)
+            {
+                taskEXIT_CRITICAL();
+                return pdFALSE;
+            }
+
+            pxSubscriber->xWaitingTask = xTaskGetCurrentTaskHandle();
+            pxSubscriber->pxNextWaiting = pxTopic->pxWaitingList;
+            pxTopic->pxWaitingList = pxSubscriber;
+        }
+        taskEXIT_CRITICAL();
+
+        // 登记之后发布的样本一定会留下通知, 不会丢失唤醒; 但通知也可能是登记之前残留的
+        (void)ulTaskNotifyTake(pdTRUE, xTicksToWait);
+
+        taskENTER_CRITICAL();
+        {
+            prvTopicRemoveWaiting(pxSubscriber);
+        }
+        taskEXIT_CRITICAL();
+    }
+}
+/******************************************************************************/
+
+#endif
@@ -0,0 +1,57 @@
+#include "trace.h"
+#include "portmacro.h"
+#include "rtos_config.h"
+#include "projectdefs.h"
+#include "rtos.h"
+
+#if (configUSE_TRACE_FACILITY == 1)
+
+/******************************************************************************/
+// 跟踪记录器, 头部静态初始化, 调度器启动前创建任务时即可写入
+portDONT_DISCARD TraceRecorder_t xTraceRecorder = {
+    traceMAGIC,
+    traceVERSION,
+    (uint32_t)configTRACE_BUFFER_SIZE,
+    (uint32_t)configTRACE_MAX_TASKS,
+    (uint32_t)configMAX_TASK_NAME_LEN,
+    (uint32_t)portCYCLE_COUNTER_HZ,
+    0UL,
+    1UL,
+};
+
+TCB_t *pxTraceSwitchedOutTCB = NULL;
+/******************************************************************************/
+
+/******************************************************************************/
+/**
+ * @brief 为新任务分配跟踪编号, 记录名称和创建事件, 由 traceTASK_CREATE() 在临界段中调用
+ * @param TCB_t *const pxTCB
+ */
+void vTraceTaskCreate(TCB_t *const pxTCB)
+{
+    UBaseType_t x = 0U;
+    const uint32_t ulId = xTraceRecorder.ulNextTaskId;
+
+    // 编号超过 255 的任务共用 255, 不再区分
+    if (ulId < 255UL)
+    {
+        xTraceRecorder.ulNextTaskId = ulId + 1UL;
+    }
+    pxTCB->ucTraceId = (uint8_t)ulId;
+
+    if (ulId < (uint32_t)configTRACE_MAX_TASKS)
+    {
+        for (x = (UBaseType_t)0U; x < (UBaseType_t)configMAX_TASK_NAME_LEN; x++)
+        {
+            xTraceRecorder.pcTaskNames[ulId][x] = pxTCB->pcTaskName[x];
+
+            if (pxTCB->pcTaskName[x] == 0x00)
+                break;
+        }
+    }
+
+    vTraceRecord(traceEVT_TASK_CREATE, pxTCB->ucTraceId, pxTCB->uxPriority);
+}
+/******************************************************************************/
+
+#endif // configUSE_TRACE_FACILITY
@@ -0,0 +1,591 @@
+#include "workqueue.h"
+#include "task.h"
+#include "portmacro.h"
+#include "rtos_config.h"
+#include "projectdefs.h"
+#include "list.h"
+
+#if (configUSE_WORK_QUEUES == 1)
+
+/******************************************************************************/
+// 延时工作列表, 与任务延时列表一样分为两条, xTickCount 溢出时交换
+static List_t xDelayedWorkList1;
+static List_t xDelayedWorkList2;
+// 到期时刻没有溢出的延时工作
+static List_t *pxDelayedWorkList = NULL;
+// 到期时刻溢出了的延时工作
+static List_t *pxOverflowDelayedWorkList = NULL;
+
+extern TickType_t xTickCount;
+/******************************************************************************/
+
+/******************************************************************************/
+/**
+ * @brief 初始化工作项
+ * @param Work_t *const pxWork
+ * @param WorkHandler_t pxHandler: 处理函数
+ */
+void vWorkInit(Work_t *const pxWork, WorkHandler_t pxHandler)
+{
+    vListInitialiseItem(&(pxWork->xListItem));
+    listSET_LIST_ITEM_OWNER(&(pxWork->xListItem), pxWork);
+    pxWork->pxHandler = pxHandler;
+    pxWork->pxQueue = NULL;
+    pxWork->ucState = 0U;
+}
+
+/**
+ * @brief 初始化可延时工作项
+ * @param DelayableWork_t *const pxDelayableWork
+ * @param WorkHandler_t pxHandler: 处理函数, 收到的是 &pxDelayableWork->xWork
+ */
+void vDelayableWorkInit(DelayableWork_t *const pxDelayableWork, WorkHandler_t pxHandler)
+{
+    vWorkInit(&(pxDelayableWork->xWork), pxHandler);
+    vListInitialiseItem(&(pxDelayableWork->xTimerItem));
+    listSET_LIST_ITEM_OWNER(&(pxDelayableWork->xTimerItem), pxDelayableWork);
+}
+
+/**
+ * @brief 初始化工作队列, 之后用 xWorkQueueStartWorker() 为它创建工作线程
+ * @param WorkQueue_t *const pxQueue
+ */
+void vWorkQueueInit(WorkQueue_t *const pxQueue)
+{
+    vListInitialise(&(pxQueue->xPendingWork));
+    vListInitialise(&(pxQueue->xIdleWorkers));
+    vListInitialise(&(pxQueue->xFlushWaiting));
+    pxQueue->uxRunning = 0U;
+
+    taskENTER_CRITICAL();
+    {
+        if (pxDelayedWorkList == NULL)
+        {
+            vListInitialise(&xDelayedWorkList1);
+            vListInitialise(&xDelayedWorkList2);
+            pxDelayedWorkList = &xDelayedWorkList1;
+            pxOverflowDelayedWorkList = &xDelayedWorkList2;
+        }
+    }
+    taskEXIT_CRITICAL();
+}
+/******************************************************************************/
+
+/******************************************************************************/
+/**
+ * @brief 私有函数, 唤醒所有等待队列排空的任务, 需在临界段内调用
+ * @param WorkQueue_t *const pxQueue
+ * @returns BaseType_t: 唤醒了比当前任务优先级更高的任务时返回 pdTRUE
+ */
+static BaseType_t prvWakeFlushWaiters(WorkQueue_t *const pxQueue)
+{
+    BaseType_t xYieldRequired = pdFALSE;
+
+    if ((listLIST_IS_EMPTY(&(pxQueue->xPendingWork)) == pdFALSE) ||
+        (pxQueue->uxRunning != (UBaseType_t)0U))
+    {
+        return pdFALSE;
+    }
+
+    while (listLIST_IS_EMPTY(&(pxQueue->xFlushWaiting)) == pdFALSE)
+    {
+        if (xTaskRemoveFromEventList(&(pxQueue->xFlushWaiting)) != pdFALSE)
+        {
+            xYieldRequired = pdTRUE;
+        }
+    }
+
+    return xYieldRequired;
+}
+
+/**
+ * @brief 私有函数, 将工作项链入待处理列表并唤醒一个空闲的工作线程, 需在临界段内调用
+ * @param WorkQueue_t *const pxQueue
+ * @param Work_t *const pxWork
+ * @param BaseType_t *const pxYieldRequired: 唤醒了更高优先级任务时置为 pdTRUE
+ * @returns BaseType_t: pdTRUE 已提交, pdFALSE 工作项已在待处理列表中, 本次提交无效
+ */
+static BaseType_t prvSubmit(WorkQueue_t *const pxQueue,
+                            Work_t *const pxWork,
+                            BaseType_t *const pxYieldRequired)
+{
+    if ((pxWork->ucState & workSTATE_QUEUED) != 0U)
+    {
+        return pdFALSE;
+    }
+
+    pxWork->pxQueue = pxQueue;
+    pxWork->ucState |= workSTATE_QUEUED;
+    vListInsertEnd(&(pxQueue->xPendingWork), &(pxWork->xListItem));
+
+    if (listLIST_IS_EMPTY(&(pxQueue->xIdleWorkers)) == pdFALSE)
+    {
+        if (xTaskRemoveFromEventList(&(pxQueue->xIdleWorkers)) != pdFALSE)
+        {
+            *pxYieldRequired = pdTRUE;
+        }
+    }
+
+    return pdTRUE;
+}
+
+/**
+ * @brief 私有函数, 将可延时工作项挂入延时工作列表, 需在临界段内调用
+ * @param WorkQueue_t *const pxQueue
+ * @param DelayableWork_t *const pxDelayableWork
+ * @param const TickType_t xDelay: 延时, 为 0 时立即提交
+ * @param BaseType_t *const pxYieldRequired: 唤醒了更高优先级任务时置为 pdTRUE
+ * @returns BaseType_t: pdTRUE 已安排, pdFALSE 工作项已在等待到期或待处理, 本次安排无效
+ */
+static BaseType_t prvSchedule(WorkQueue_t *const pxQueue,
+                              DelayableWork_t *const pxDelayableWork,
+                              const TickType_t xDelay,
+                              BaseType_t *const pxYieldRequired)
+{
+    Work_t *const pxWork = &(pxDelayableWork->xWork);
+    const TickType_t xConstTickCount = xTickCount;
+    const TickType_t xTimeToRun = xConstTickCount + xDelay;
+
+    if ((pxWork->ucState & (workSTATE_QUEUED | workSTATE_DELAYED)) != 0U)
+    {
+        return pdFALSE;
+    }
+
+    if (xDelay == (TickType_t)0)
+    {
+        return prvSubmit(pxQueue, pxWork, pxYieldRequired);
+    }
+
+    pxWork->pxQueue = pxQueue;
+    pxWork->ucState |= workSTATE_DELAYED;
+    listSET_LIST_ITEM_VALUE(&(pxDelayableWork->xTimerItem), xTimeToRun);
+
+    if (xTimeToRun < xConstTickCount)
+    {
+        vListInsert(pxOverflowDelayedWorkList, &(pxDelayableWork->xTimerItem));
+    }
+    else
+    {
+        vListInsert(pxDelayedWorkList, &(pxDelayableWork->xTimerItem));
+    }
+
+    return pdTRUE;
+}
+
+/**
+ * @brief 私有函数, 从待处理列表中取出第一个没有在执行的工作项, 需在临界段内调用
+ *
+ * 工作项在执行期间被再次提交时, 其他工作线程跳过它, 保证同一工作项的处理函数不会并发执行
+ *
+ * @param WorkQueue_t *const pxQueue
+ * @returns Work_t *: 没有可执行的工作项时返回 NULL
+ */
+static Work_t *prvTakeNextWork(WorkQueue_t *const pxQueue)
+{
+    ListItem_t *pxItem = listGET_HEAD_ENTRY(&(pxQueue->xPendingWork));
+    Work_t *pxWork = NULL;
+
+    while (pxItem != (ListItem_t *)listGET_END_MARKER(&(pxQueue->xPendingWork)))
+    {
+        pxWork = (Work_t *)listGET_LIST_ITEM_OWNER(pxItem);
+
+        if ((pxWork->ucState & workSTATE_RUNNING) == 0U)
+        {
+            (void)uxListRemove(pxItem);
+            pxWork->ucState = (uint8_t)((pxWork->ucState & ~workSTATE_QUEUED) | workSTATE_RUNNING);
+            return pxWork;
+        }
+
+        pxItem = listGET_NEXT(pxItem);
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief 私有函数, 工作线程, 依次执行待处理的工作项, 没有工作项时阻塞
+ * @param void *pvParameters: 所属的工作队列
+ */
+static void prvWorkerTask(void *pvParameters)
+{
+    WorkQueue_t *const pxQueue = (WorkQueue_t *)pvParameters;
+    Work_t *pxWork = NULL;
+
+    for (;;)
+    {
+        taskENTER_CRITICAL();
+        {
+            pxWork = prvTakeNextWork(pxQueue);
+
+            if (pxWork == NULL)
+            {
+                vTaskPlaceOnEventList(&(pxQueue->xIdleWorkers), portMAX_DELAY);
+                taskYIELD();
+            }
+            else
+            {
+                pxQueue->uxRunning++;
+            }
+        }
+        taskEXIT_CRITICAL();
+
+        if (pxWork == NULL)
+        {
+            continue;
+        }
+
+        pxWork->pxHandler(pxWork);
+
+        taskENTER_CRITICAL();
+        {
+            pxWork->ucState &= (uint8_t)~workSTATE_RUNNING;
+            pxQueue->uxRunning--;
+
+            if (prvWakeFlushWaiters(pxQueue) != pdFALSE)
+            {
+                taskYIELD();
+            }
+        }
+        taskEXIT_CRITICAL();
+    }
+}
+
+/**
+ * @brief 为工作队列创建一个工作线程, 同一队列可以有多个不同优先级的工作线程
+ * @param WorkQueue_t *const pxQueue
+ * @param const char *const pcName: 任务名称
+ * @param const uint32_t ulStackDepth: 任务栈大小, 单位为字, 需容纳最深的处理函数
+ * @param UBaseType_t uxPriority: 任务优先级
+ * @param StackType_t *const puxStackBuffer: 任务栈
+ * @param TCB_t *const pxTaskBuffer: 任务控制块
+ * @returns TaskHandle_t: 工作线程的任务句柄
+ */
+TaskHandle_t xWorkQueueStartWorker(WorkQueue_t *const pxQueue,
+                                   const char *const pcName,
+                                   const uint32_t ulStackDepth,
+                                   UBaseType_t uxPriority,
+                                   StackType_t *const puxStackBuffer,
+                                   TCB_t *const pxTaskBuffer)
+{
+    return xTaskCreateStatic(prvWorkerTask,
+                             pcName,
+                             ulStackDepth,
+                             (void *)pxQueue,
+                             uxPriority,
+                             puxStackBuffer,
+                             pxTaskBuffer);
+}
+/******************************************************************************/
+
+/******************************************************************************/
+/**
+ * @brief 在任务中提交工作项, 已在待处理列表中的工作项重复提交无效
+ * @param WorkQueue_t *const pxQueue
+ * @param Work_t *const pxWork
+ * @returns BaseType_t: pdTRUE 已提交, pdFALSE 工作项已在待处理列表中
+ */
+BaseType_t xWorkSubmit(WorkQueue_t *const pxQueue, Work_t *const pxWork)
+{
+    BaseType_t xReturn = pdFALSE;
+    BaseType_t xYieldRequired = pdFALSE;
+
+    taskENTER_CRITICAL();
+    {
+        xReturn = prvSubmit(pxQueue, pxWork, &xYieldRequired);
+
+        if (xYieldRequired != pdFALSE)
+        {
+            taskYIELD();
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    return xReturn;
+}
+
+/**
+ * @brief 在中断中提交工作项, 已在待处理列表中的工作项重复提交无效
+ * @param WorkQueue_t *const pxQueue
+ * @param Work_t *const pxWork
+ * @param BaseType_t *const pxHigherPriorityTaskWoken: 唤醒了更高优先级任务时置为 pdTRUE, 中断退出前应调用 portYIELD()
+ * @returns BaseType_t: pdTRUE 已提交, pdFALSE 工作项已在待处理列表中
+ */
+BaseType_t xWorkSubmitFromISR(WorkQueue_t *const pxQueue,
+                              Work_t *const pxWork,
+                              BaseType_t *const pxHigherPriorityTaskWoken)
+{
+    BaseType_t xReturn = pdFALSE;
+    BaseType_t xYieldRequired = pdFALSE;
+    uint32_t ulSavedInterruptStatus = 0;
+
+    ulSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+    {
+        xReturn = prvSubmit(pxQueue, pxWork, &xYieldRequired);
+    }
+    taskEXIT_CRITICAL_FROM_ISR(ulSavedInterruptStatus);
+
+    if ((xYieldRequired != pdFALSE) && (pxHigherPriorityTaskWoken != NULL))
+    {
+        *pxHigherPriorityTaskWoken = pdTRUE;
+    }
+
+    return xReturn;
+}
+
+/**
+ * @brief 在任务中安排可延时工作项, xDelay 个 tick 后提交到工作队列
+ * @param WorkQueue_t *const pxQueue
+ * @param DelayableWork_t *const pxDelayableWork
+ * @param const TickType_t xDelay: 延时, 为 0 时立即提交
+ * @returns BaseType_t: pdTRUE 已安排, pdFALSE 工作项已在等待到期或待处理
+ */
+BaseType_t xWorkSchedule(WorkQueue_t *const pxQueue,
+                         DelayableWork_t *const pxDelayableWork,
+                         const TickType_t xDelay)
+{
+    BaseType_t xReturn = pdFALSE;
+    BaseType_t xYieldRequired = pdFALSE;
+
+    taskENTER_CRITICAL();
+    {
+        xReturn = prvSchedule(pxQueue, pxDelayableWork, xDelay, &xYieldRequired);
+
+        if (xYieldRequired != pdFALSE)
+        {
+            taskYIELD();
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    return xReturn;
+}
+
+/**
+ * @brief 在中断中安排可延时工作项, xDelay 个 tick 后提交到工作队列
+ * @param WorkQueue_t *const pxQueue
+ * @param DelayableWork_t *const pxDelayableWork
+ * @param const TickType_t xDelay: 延时, 为 0 时立即提交
+ * @param BaseType_t *const pxHigherPriorityTaskWoken: 唤醒了更高优先级任务时置为 pdTRUE, 中断退出前应调用 portYIELD()
+ * @returns BaseType_t: pdTRUE 已安排, pdFALSE 工作项已在等待到期或待处理
+ */
+BaseType_t xWorkScheduleFromISR(WorkQueue_t *const pxQueue,
+                                DelayableWork_t *const pxDelayableWork,
+                                const TickType_t xDelay,
+                                BaseType_t *const pxHigherPriorityTaskWoken)
+{
+    BaseType_t xReturn = pdFALSE;
+    BaseType_t xYieldRequired = pdFALSE;
+    uint32_t ulSavedInterruptStatus = 0;
+
+    ulSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+    {
+        xReturn = prvSchedule(pxQueue, pxDelayableWork, xDelay, &xYieldRequired);
+    }
+    taskEXIT_CRITICAL_FROM_ISR(ulSavedInterruptStatus);
+
+    if ((xYieldRequired != pdFALSE) && (pxHigherPriorityTaskWoken != NULL))
+    {
+        *pxHigherPriorityTaskWoken = pdTRUE;
+    }
+
+    return xReturn;
+}
+
+/**
+ * @brief 私有函数, 将工作项移出待处理列表, 需在临界段内调用
+ * @param Work_t *const pxWork
+ * @returns BaseType_t: pdTRUE 已取消, pdFALSE 工作项不在待处理列表中
+ */
+static BaseType_t prvCancel(Work_t *const pxWork)
+{
+    if ((pxWork->ucState & workSTATE_QUEUED) == 0U)
+    {
+        return pdFALSE;
+    }
+
+    (void)uxListRemove(&(pxWork->xListItem));
+    pxWork->ucState &= (uint8_t)~workSTATE_QUEUED;
+
+    // 取消的可能是队列中最后一个工作项
+    if (prvWakeFlushWaiters(pxWork->pxQueue) != pdFALSE)
+    {
+        taskYIELD();
+    }
+
+    return pdTRUE;
+}
+
+/**
+ * @brief 取消尚未执行的工作项, 正在执行的处理函数不受影响, 见 xWorkIsBusy()
+ * @param Work_t *const pxWork
+ * @returns BaseType_t: pdTRUE 已取消, pdFALSE 工作项不在待处理列表中
+ */
+BaseType_t xWorkCancel(Work_t *const pxWork)
+{
+    BaseType_t xReturn = pdFALSE;
+
+    taskENTER_CRITICAL();
+    {
+        xReturn = prvCancel(pxWork);
+    }
+    taskEXIT_CRITICAL();
+
+    return xReturn;
+}
+
+/**
+ * @brief 取消尚未到期或尚未执行的可延时工作项
+ * @param DelayableWork_t *const pxDelayableWork
+ * @returns BaseType_t: pdTRUE 已取消, pdFALSE 工作项既不在等待到期也不在待处理列表中
+ */
+BaseType_t xWorkCancelDelayable(DelayableWork_t *const pxDelayableWork)
+{
+    Work_t *const pxWork = &(pxDelayableWork->xWork);
+    BaseType_t xReturn = pdFALSE;
+
+    taskENTER_CRITICAL();
+    {
+        if ((pxWork->ucState & workSTATE_DELAYED) != 0U)
+        {
+            (void)uxListRemove(&(pxDelayableWork->xTimerItem));
+            pxWork->ucState &= (uint8_t)~workSTATE_DELAYED;
+            xReturn = pdTRUE;
+        }
+        else
+        {
+            xReturn = prvCancel(pxWork);
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    return xReturn;
+}
+
+/**
+ * @brief 查询工作项是否在等待到期, 待处理或正在执行
+ * @param const Work_t *const pxWork
+ * @returns BaseType_t: pdTRUE 忙, 此时不能释放或重新初始化工作项
+ */
+BaseType_t xWorkIsBusy(const Work_t *const pxWork)
+{
+    return (pxWork->ucState != 0U) ? pdTRUE : pdFALSE;
+}
+
+/**
+ * @brief 等待工作队列排空, 即没有待处理的工作项且没有处理函数正在执行, 不能在工作线程中调用
+ * @param WorkQueue_t *const pxQueue
+ * @param TickType_t xTicksToWait: 最长等待时间, 0 表示不等待, portMAX_DELAY 表示无限期等待
+ * @returns BaseType_t: pdPASS 已排空, pdFAIL 超时
+ */
+BaseType_t xWorkQueueFlush(WorkQueue_t *const pxQueue, TickType_t xTicksToWait)
+{
+    BaseType_t xEntryTimeSet = pdFALSE;
+    TimeOut_t xTimeOut;
+
+    for (;;)
+    {
+        taskENTER_CRITICAL();
+        {
+            if ((listLIST_IS_EMPTY(&(pxQueue->xPendingWork)) != pdFALSE) &&
+                (pxQueue->uxRunning == (UBaseType_t)0U))
+            {
+                taskEXIT_CRITICAL();
+                return pdPASS;
+            }
+
+            if (xTicksToWait == (TickType_t)0)
+            {
+                taskEXIT_CRITICAL();
+                return pdFAIL;
+            }
+
+            if (xEntryTimeSet == pdFALSE)
+            {
+                vTaskSetTimeOutState(&xTimeOut);
+                xEntryTimeSet = pdTRUE;
+            }
+            else if (xTaskCheckForTimeOut(&xTimeOut, &xTicksToWait) != pdFALSE)
+            {
+                taskEXIT_CRITICAL();
+                return pdFAIL;
+            }
+
+            vTaskPlaceOnEventList(&(pxQueue->xFlushWaiting), xTicksToWait);
+            taskYIELD();
+        }
+        taskEXIT_CRITICAL();
+    }
+}
+/******************************************************************************/
+
+/******************************************************************************/
+/**
+ * @brief 延时工作服务, 由 xTaskIncrementTick() 在每个 tick 中调用, 调用时中断已屏蔽
+ *
+ * 延时工作列表按到期时刻排序, 每个 tick 只检查列表头部, 到期的工作项提交到各自的工作队列
+ */
+void vWorkQueueTickFromISR(void)
+{
+    const TickType_t xConstTickCount = xTickCount;
+    List_t *pxTemp = NULL;
+    DelayableWork_t *pxDelayableWork = NULL;
+    BaseType_t xYieldRequired = pdFALSE;
+
+    if (pxDelayedWorkList == NULL)
+    {
+        return;
+    }
+
+    if (xConstTickCount == (TickType_t)0U)
+    {
+        pxTemp = pxDelayedWorkList;
+        pxDelayedWorkList = pxOverflowDelayedWorkList;
+        pxOverflowDelayedWorkList = pxTemp;
+    }
+
+    while (listLIST_IS_EMPTY(pxDelayedWorkList) == pdFALSE)
+    {
+        if (xConstTickCount < listGET_ITEM_VALUE_OF_HEAD_ENTRY(pxDelayedWorkList))
+        {
+            break;
+        }
+
+        pxDelayableWork = (DelayableWork_t *)listGET_OWNER_OF_HEAD_ENTRY(pxDelayedWorkList);
+        (void)uxListRemove(&(pxDelayableWork->xTimerItem));
+        pxDelayableWork->xWork.ucState &= (uint8_t)~workSTATE_DELAYED;
+
+        // tick 结束时总会触发任务切换, 不必处理 xYieldRequired
+        (void)prvSubmit(pxDelayableWork->xWork.pxQueue, &(pxDelayableWork->xWork), &xYieldRequired);
+    }
+}
+
+#if (configUSE_VIRTUAL_TIME == 1)
+/**
+ * @brief 距离最近一个延时工作到期还有多少个 tick, 调用时中断已屏蔽
+ * @returns TickType_t: 0 表示没有延时工作, 只有溢出列表中有延时工作时返回到 xTickCount 溢出的距离
+ */
+TickType_t xWorkQueueTicksToNextEvent(void)
+{
+    const TickType_t xConstTickCount = xTickCount;
+
+    if (pxDelayedWorkList == NULL)
+    {
+        return 0U;
+    }
+
+    if (listLIST_IS_EMPTY(pxDelayedWorkList) == pdFALSE)
+    {
+        return listGET_ITEM_VALUE_OF_HEAD_ENTRY(pxDelayedWorkList) - xConstTickCount;
+    }
+
+    if (listLIST_IS_EMPTY(pxOverflowDelayedWorkList) == pdFALSE)
+    {
+        return (xConstTickCount == (TickType_t)0U) ? portMAX_DELAY : (TickType_t)(0U - xConstTickCount);
+    }
+
+    return 0U;
+}
+#endif
+/******************************************************************************/
+
+#endif
@@ -0,0 +1,200 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+将内核跟踪记录器的导出文件转换为 Chrome 跟踪格式(JSON), 可直接在 https://ui.perfetto.dev 或 chrome://tracing 中打开.
+
+导出文件即 RAM 中的 xTraceRecorder 结构体(见 rtos/source/include/trace.h), 例如:
+    (gdb) dump binary value trace.bin xTraceRecorder
+    python3 tools/trace2perfetto.py trace.bin -o trace.json
+
+每个任务显示为一个线程, 运行区间为切片, 就绪/阻塞/创建为瞬时事件;
+编号 0 的线程显示中断(切片)和时基(瞬时事件).
+"""
+
+import argparse
+import json
+import struct
+import sys
+
+TRACE_MAGIC = 0x43525452
+TRACE_VERSION = 1
+
+# 与 trace.h 中的 traceEVT_XXX 一致
+EVT_TASK_CREATE = 1
+EVT_TASK_SWITCHED_IN = 2
+EVT_TASK_SWITCHED_OUT = 3
+EVT_TASK_READY = 4
+EVT_TASK_DELAYED = 5
+EVT_TICK = 6
+EVT_ISR_ENTER = 7
+EVT_ISR_EXIT = 8
+
+NO_TASK = 0
+PID = 1
+
+# 常见异常号的名称, 其余显示为 irq N
+IRQ_NAMES = {15: "SysTick"}
+
+HEADER = struct.Struct("<8I")
+RECORD = struct.Struct("<II")
+
+
+def parse(data):
+    """解析导出文件, 返回 (时钟频率, 任务名称表, 按写入顺序排列的记录列表)"""
+    if len(data) < HEADER.size:
+        raise ValueError("file too short for trace header")
+
+    magic, version, capacity, max_tasks, name_len, cycle_hz, head, _next_id = HEADER.unpack_from(data, 0)
+    if magic != TRACE_MAGIC:
+        raise ValueError("bad magic 0x%08x, not a trace recorder dump" % magic)
+    if version != TRACE_VERSION:
+        raise ValueError("unsupported trace version %d" % version)
+    if capacity == 0 or (capacity & (capacity - 1)) != 0:
+        raise ValueError("bad capacity %d" % capacity)
+
+    offset = HEADER.size
+    names = {}
+    for i in range(max_tasks):
+        raw = data[offset + i * name_len: offset + (i + 1) * name_len]
+        name = raw.split(b"\0", 1)[0].decode("utf-8", "replace")
+        if name:
+            names[i] = name
+    offset += max_tasks * name_len
+
+    if len(data) < offset + capacity * RECORD.size:
+        raise ValueError("file too short for %d records" % capacity)
+
+    # 缓冲区满后最旧的记录已被覆盖, 只取最近 capacity 条
+    count = min(head, capacity)
+    records = []
+    for seq in range(head - count, head):
+        timestamp, word = RECORD.unpack_from(data, offset + (seq & (capacity - 1)) * RECORD.size)
+        event = word & 0xff
+        if event == 0:
+            continue
+        records.append((timestamp, event, (word >> 8) & 0xff, word >> 16))
+
+    return cycle_hz, names, records
+
+
+def unwrap(records):
+    """按相邻记录的有符号差值展开 32 位时间戳, 中断抢占造成的少量乱序也能正确处理, 再按时间排序"""
+    result = []
+    previous_raw = None
+    now = 0
+    for seq, (timestamp, event, task, param) in enumerate(records):
+        if previous_raw is not None:
+            delta = (timestamp - previous_raw) & 0xffffffff
+            if delta >= 0x80000000:
+                delta -= 0x100000000
+            now += delta
+        previous_raw = timestamp
+        result.append((now, seq, event, task, param))
+    result.sort()
+    return result
+
+
+def task_name(names, task):
+    if task == NO_TASK:
+        return "ISR/kernel"
+    return names.get(task, "task%d" % task)
+
+
+def convert(cycle_hz, names, records):
+    """生成 Chrome 跟踪格式的事件列表, 时间单位为微秒"""
+    events = []
+    timeline = unwrap(records)
+    if not timeline:
+        return events
+
+    origin = timeline[0][0]
+    scale = 1e6 / float(cycle_hz)
+
+    def us(t):
+        return (t - origin) * scale
+
+    seen_tasks = set([NO_TASK])
+    running = None
+    running_since = 0
+    isr_stack = []
+
+    for t, _seq, event, task, param in timeline:
+        seen_tasks.add(task)
+
+        if event == EVT_TASK_SWITCHED_IN:
+            # 切出后又选中同一个任务时视为一直在运行
+            if running != task:
+                if running is not None:
+                    events.append({"name": task_name(names, running), "ph": "X", "pid": PID, "tid": running,
+                                   "ts": us(running_since), "dur": us(t) - us(running_since)})
+                running = task
+                running_since = t
+        elif event == EVT_TASK_SWITCHED_OUT:
+            pass
+        elif event == EVT_TASK_READY:
+            events.append({"name": "ready", "ph": "i", "s": "t", "pid": PID, "tid": task, "ts": us(t),
+                           "args": {"priority": param}})
+        elif event == EVT_TASK_DELAYED:
+            events.append({"name": "block", "ph": "i", "s": "t", "pid": PID, "tid": task, "ts": us(t),
+                           "args": {"ticks": "forever" if param == 0xffff else param}})
+        elif event == EVT_TASK_CREATE:
+            events.append({"name": "create", "ph": "i", "s": "t", "pid": PID, "tid": task, "ts": us(t),
+                           "args": {"priority": param}})
+        elif event == EVT_TICK:
+            events.append({"name": "tick", "ph": "i", "s": "t", "pid": PID, "tid": NO_TASK, "ts": us(t),
+                           "args": {"tick": param}})
+        elif event == EVT_ISR_ENTER:
+            isr_stack.append((param, t))
+        elif event == EVT_ISR_EXIT:
+            # 缓冲区开头可能缺少对应的进入记录
+            if isr_stack and isr_stack[-1][0] == param:
+                _irq, since = isr_stack.pop()
+                events.append({"name": IRQ_NAMES.get(param, "irq %d" % param), "ph": "X", "pid": PID,
+                               "tid": NO_TASK, "ts": us(since), "dur": us(t) - us(since)})
+
+    # 最后一个运行区间截止到最后一条记录
+    last = timeline[-1][0]
+    if running is not None:
+        events.append({"name": task_name(names, running), "ph": "X", "pid": PID, "tid": running,
+                       "ts": us(running_since), "dur": us(last) - us(running_since)})
+
+    events.append({"name": "process_name", "ph": "M", "pid": PID, "args": {"name": "rtos"}})
+    for task in sorted(seen_tasks):
+        events.append({"name": "thread_name", "ph": "M", "pid": PID, "tid": task,
+                       "args": {"name": task_name(names, task)}})
+        events.append({"name": "thread_sort_index", "ph": "M", "pid": PID, "tid": task,
+                       "args": {"sort_index": task}})
+
+    return events
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Convert an RTOS trace recorder dump to Chrome/Perfetto JSON.")
+    parser.add_argument("input", help="binary dump of xTraceRecorder")
+    parser.add_argument("-o", "--output", help="output JSON file, default: stdout")
+    args = parser.parse_args()
+
+    with open(args.input, "rb") as f:
+        data = f.read()
+
+    try:
+        cycle_hz, names, records = parse(data)
+    except ValueError as e:
+        sys.stderr.write("%s: %s\n" % (args.input, e))
+        return 1
+
+    trace = {"traceEvents": convert(cycle_hz, names, records), "displayTimeUnit": "ns"}
+
+    if args.output:
+        with open(args.output, "w") as f:
+            json.dump(trace, f)
+    else:
+        json.dump(trace, sys.stdout)
+        sys.stdout.write("\n")
+
+    sys.stderr.write("%d records, %d Hz, %d tasks named\n" % (len(records), cycle_hz, len(names)))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,878 @@
+#include <stdio.h>
+
+#include "portmacro.h"
+#include "rtos_config.h"
+#include "projectdefs.h"
+#include "task.h"
+#include "rtos.h"
+#include "list.h"
+#include "queue.h"
+#include "semphr.h"
+#include "rwlock.h"
+#include "active_object.h"
+
+// 内核路径基准测试, 代替 main.c 编译, 用 portGET_CYCLE_COUNT() 计时:
+// Cortex-M3/M4F 上为 DWT CYCCNT, Cortex-M0 和 QEMU 上由 SysTick 拼出, POSIX 模拟器上为纳秒.
+// 每项测试输出一行 JSON, 包含最小值, 平均值, 百分位数和最大值, 单位为周期计数器的计数, 频率见 "hz",
+// 所有数值已减去两次连续读取周期计数器本身的开销, 便于在不同提交之间直接比较.
+// 打开 configUSE_TRACE_FACILITY 时增加一项写入跟踪记录的开销, 其他各项包含跟踪钩子的开销;
+// 能结束调度器的移植(POSIX)在测试结束后将跟踪记录器写入当前目录下的 trace.bin.
+// 打开 configGENERATE_RUN_TIME_STATS 时最后输出各任务占用 CPU 的比例, 其他各项包含统计的开销.
+// 打开 configUSE_RWLOCKS 时增加读写锁与互斥量的读者开销和吞吐量对比,
+// 打开 configUSE_ACTIVE_OBJECTS 时增加活动对象事件投递和分发的吞吐量
+
+#if ((configUSE_TICK_HOOK == 0) || (configUSE_TASK_NOTIFICATIONS == 0))
+#error "benchmark requires configUSE_TICK_HOOK and configUSE_TASK_NOTIFICATIONS"
+#endif
+
+extern TickType_t xTickCount;
+
+// 每项测试的样本数
+#define benchSAMPLES 128
+// 时基中断测试每种唤醒数量的轮数, 每轮约需 4 个时基周期
+#define benchTICK_ROUNDS 32
+// 时基中断测试中最多同时到期的任务数
+#define benchMAX_SLEEPERS 8
+// 批量收发测试的最大批量, 即队列长度
+#define benchMAX_BATCH 64
+// 活动对象测试每个样本连续投递的事件数, 即事件队列长度
+#define benchAO_BURST 16
+
+// 优先级: 测试任务最高, 同优先级让出测试的对手与之相同, 定时到期的任务次之
+#define benchPRIORITY (configMAX_PRIORITIES - 1)
+#define benchSLEEPER_PRIORITY (configMAX_PRIORITIES - 2)
+// 抢占切换测试中唤醒测试任务的任务, 优先级低于测试任务
+#define benchWAKER_PRIORITY (configMAX_PRIORITIES - 2)
+
+// 测试任务要调用 printf, 栈给大一些
+#define benchSTACK_SIZE 512
+#define benchPEER_STACK_SIZE 128
+#define benchSLEEPER_STACK_SIZE 96
+
+// idle task
+TCB_t IdleTaskTCB = {0};
+StackType_t IdleTaskStack[configMINIMAL_STACK_SIZE];
+
+TCB_t BenchTCB = {0};
+StackType_t BenchStack[benchSTACK_SIZE];
+TaskHandle_t Bench_Handle = NULL;
+
+TCB_t PeerTCB = {0};
+StackType_t PeerStack[benchPEER_STACK_SIZE];
+TaskHandle_t Peer_Handle = NULL;
+
+#if (configUSE_RWLOCKS == 1)
+TCB_t ReaderTCB = {0};
+StackType_t ReaderStack[benchPEER_STACK_SIZE];
+TaskHandle_t Reader_Handle = NULL;
+#endif
+
+#if (configUSE_ACTIVE_OBJECTS == 1)
+ActiveObject_t BenchAO;
+StackType_t BenchAOStack[benchPEER_STACK_SIZE];
+static const Event_t *pxBenchAOQueue[benchAO_BURST];
+#endif
+
+TCB_t WakerTCB = {0};
+StackType_t WakerStack[benchPEER_STACK_SIZE];
+TaskHandle_t Waker_Handle = NULL;
+
+TCB_t SleeperTCB[benchMAX_SLEEPERS];
+StackType_t SleeperStack[benchMAX_SLEEPERS][benchSLEEPER_STACK_SIZE];
+TaskHandle_t Sleeper_Handle[benchMAX_SLEEPERS];
+
+static uint32_t ulSamples[benchSAMPLES];
+static volatile uint32_t ulSampleCount = 0;
+// 两次连续读取周期计数器的开销
+static uint32_t ulCounterOverhead = 0;
+
+// 同优先级让出: 让出前写入的时间戳, 由另一方在恢复运行后读取
+static volatile uint32_t ulYieldStamp = 0;
+static volatile BaseType_t xYieldDone = pdFALSE;
+// 让出前先做一次浮点运算, 在带 FPU 的移植(Cortex-M4F)上任务切换要保存和恢复浮点寄存器
+static volatile BaseType_t xYieldUseFpu = pdFALSE;
+static volatile float fYieldFloat = 1.0f;
+
+// 抢占切换: 低优先级任务唤醒测试任务之前写入的时间戳
+static volatile uint32_t ulSwitchStamp = 0;
+
+// 时基钩子中记录的时间戳, 以及由时基中断发送任务通知的目标
+static volatile uint32_t ulTickStamp = 0;
+static volatile uint32_t ulNotifyStamp = 0;
+static TaskHandle_t volatile xNotifyTarget = NULL;
+
+// 定时任务共同的到期时刻
+static volatile TickType_t xSleepTarget = 0;
+
+// 批量收发测试的队列和收发缓冲区
+static Queue_t xBatchQueueBuffer;
+static uint8_t ucBatchQueueStorage[benchMAX_BATCH * sizeof(uint32_t)];
+static QueueHandle_t xBatchQueue = NULL;
+static uint32_t ulBatchItems[benchMAX_BATCH];
+
+#if (configUSE_RWLOCKS == 1)
+// 读者测试: 读写锁和作对比的互斥量, 以及两者保护的共享数据
+static RWLock_t xBenchRWLock;
+static Queue_t xBenchMutexBuffer;
+static SemaphoreHandle_t xBenchMutex = NULL;
+static volatile uint32_t ulSharedData[4];
+// 读者测试用互斥量代替读写锁
+static volatile BaseType_t xReadUseMutex = pdFALSE;
+// 读者测试结束, 另一个读者回到等待状态
+static volatile BaseType_t xReadDone = pdFALSE;
+static volatile BaseType_t xReaderIdle = pdTRUE;
+// 另一个读者完成的读操作数
+static volatile uint32_t ulReaderReads = 0;
+#endif
+
+#if (configUSE_ACTIVE_OBJECTS == 1)
+// 活动对象测试: 静态事件, 事件池, 以及本批已分发的事件数
+static const Event_t xBenchStaticEvent = {aoUSER_SIG, 0U, 0U};
+static EventPool_t xBenchEventPool;
+// 每块放一个 Event_t, 大小对齐到指针. 最后一个事件在通知测试任务之后才回收, 留出两批的余量
+static void *pvBenchEventPoolStorage[2 * benchAO_BURST];
+static volatile uint32_t ulAODispatched = 0;
+#endif
+
+/******************************************************************************/
+/**
+ * @brief 时基钩子, 在时基中断中运行
+ */
+void vApplicationTickHook(void)
+{
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+    ulTickStamp = portGET_CYCLE_COUNT();
+
+    if (xNotifyTarget != NULL)
+    {
+        ulNotifyStamp = ulTickStamp;
+        vTaskNotifyGiveFromISR(xNotifyTarget, &xHigherPriorityTaskWoken);
+        xNotifyTarget = NULL;
+    }
+
+    // 时基中断结束时总会触发一次任务切换
+    (void)xHigherPriorityTaskWoken;
+}
+
+/**
+ * @brief 记录一个样本, 扣除读取周期计数器本身的开销
+ * @param uint32_t ulElapsed: 两次读数之差
+ */
+static void prvRecord(uint32_t ulElapsed)
+{
+    if (ulSampleCount < benchSAMPLES)
+    {
+        ulSamples[ulSampleCount] = (ulElapsed > ulCounterOverhead) ? (ulElapsed - ulCounterOverhead) : 0UL;
+        ulSampleCount++;
+    }
+}
+
+/**
+ * @brief 对已记录的样本排序, 输出一行 JSON, 然后清空样本
+ * @param const char *pcName: 测试名称
+ * @param int32_t lSleepers: 时基中断测试中到期的任务数, 其他测试传入 -1
+ */
+static void prvReport(const char *pcName, int32_t lSleepers)
+{
+    const uint32_t ulCount = ulSampleCount;
+    uint64_t ullSum = 0;
+    uint32_t i, j, ulValue;
+
+    // 样本不多, 插入排序即可
+    for (i = 1; i < ulCount; i++)
+    {
+        ulValue = ulSamples[i];
+        for (j = i; (j > 0) && (ulSamples[j - 1] > ulValue); j--)
+        {
+            ulSamples[j] = ulSamples[j - 1];
+        }
+        ulSamples[j] = ulValue;
+    }
+
+    for (i = 0; i < ulCount; i++)
+    {
+        ullSum += ulSamples[i];
+    }
+
+    printf("{\"bench\":\"%s\"", pcName);
+    if (lSleepers >= 0)
+    {
+        printf(",\"sleepers\":%ld", (long)lSleepers);
+    }
+    printf(",\"hz\":%lu,\"n\":%lu", (unsigned long)portCYCLE_COUNTER_HZ, (unsigned long)ulCount);
+    if (ulCount != 0)
+    {
+        printf(",\"min\":%lu,\"avg\":%lu,\"p50\":%lu,\"p90\":%lu,\"p99\":%lu,\"max\":%lu",
+               (unsigned long)ulSamples[0],
+               (unsigned long)(ullSum / ulCount),
+               (unsigned long)ulSamples[((ulCount - 1) * 50U) / 100U],
+               (unsigned long)ulSamples[((ulCount - 1) * 90U) / 100U],
+               (unsigned long)ulSamples[((ulCount - 1) * 99U) / 100U],
+               (unsigned long)ulSamples[ulCount - 1]);
+    }
+    printf("}\n");
+    fflush(stdout);
+
+    ulSampleCount = 0;
+}
+/******************************************************************************/
+
+/******************************************************************************/
+/**
+ * @brief 两次连续读取周期计数器的开销, 取最小值
+ */
+static void prvBenchCounterOverhead(void)
+{
+    uint32_t i, ulStart, ulElapsed;
+
+    ulCounterOverhead = 0xffffffffUL;
+    for (i = 0; i < benchSAMPLES; i++)
+    {
+        ulStart = portGET_CYCLE_COUNT();
+        ulElapsed = portGET_CYCLE_COUNT() - ulStart;
+        if (ulElapsed < ulCounterOverhead)
+        {
+            ulCounterOverhead = ulElapsed;
+        }
+    }
+
+    // 开销本身作为一项输出, 不做扣除
+    printf("{\"bench\":\"counter_overhead\",\"hz\":%lu,\"value\":%lu}\n",
+           (unsigned long)portCYCLE_COUNTER_HZ, (unsigned long)ulCounterOverhead);
+}
+
+/**
+ * @brief 进出一次临界段的开销
+ */
+static void prvBenchCritical(void)
+{
+    uint32_t i, ulStart;
+
+    for (i = 0; i < benchSAMPLES; i++)
+    {
+        ulStart = portGET_CYCLE_COUNT();
+        portENTER_CRITICAL();
+        portEXIT_CRITICAL();
+        prvRecord(portGET_CYCLE_COUNT() - ulStart);
+    }
+
+    prvReport("critical_enter_exit", -1);
+}
+
+#if (configUSE_TRACE_FACILITY == 1)
+/**
+ * @brief 写入一条跟踪记录的开销
+ */
+static void prvBenchTraceRecord(void)
+{
+    uint32_t i, ulStart;
+
+    for (i = 0; i < benchSAMPLES; i++)
+    {
+        ulStart = portGET_CYCLE_COUNT();
+        vTraceRecord(traceEVT_ISR_ENTER, traceNO_TASK, 0UL);
+        prvRecord(portGET_CYCLE_COUNT() - ulStart);
+    }
+
+    prvReport("trace_record", -1);
+}
+
+#ifdef portEND_SCHEDULER
+/**
+ * @brief 将跟踪记录器原样写入文件, 用 tools/trace2perfetto.py 转换
+ * @param const char *pcPath: 文件路径
+ */
+static void prvDumpTrace(const char *pcPath)
+{
+    FILE *pxFile = fopen(pcPath, "wb");
+
+    if (pxFile != NULL)
+    {
+        (void)fwrite(&xTraceRecorder, sizeof(xTraceRecorder), 1, pxFile);
+        (void)fclose(pxFile);
+    }
+}
+#endif
+#endif
+
+#if (configGENERATE_RUN_TIME_STATS == 1)
+/**
+ * @brief 输出一个任务的运行时间占比, 单位为万分之一. newlib-nano 的 printf 不支持 64 位整数, 只输出比例
+ * @param const char *pcName: 任务名称
+ * @param TaskHandle_t xTask: 任务句柄
+ * @param configRUN_TIME_COUNTER_TYPE ulTotal: 总运行时间
+ */
+static void prvReportRunTime(const char *pcName, TaskHandle_t xTask, configRUN_TIME_COUNTER_TYPE ulTotal)
+{
+    const configRUN_TIME_COUNTER_TYPE ulCounter = ulTaskGetRunTimeCounter(xTask);
+
+    printf("{\"bench\":\"run_time\",\"task\":\"%s\",\"basis_points\":%lu}\n",
+           pcName, (unsigned long)((ulTotal != 0U) ? ((ulCounter * 10000U) / ulTotal) : 0U));
+}
+#endif
+
+/**
+ * @brief 同优先级让出: 从一个任务调用 taskYIELD() 到同优先级的另一个任务恢复运行
+ * @param const char *pcName: 测试名称
+ * @param BaseType_t xUseFpu: pdTRUE 双方每次让出前都使用浮点寄存器.
+ *        Cortex-M4F 上任务用过 FPU 之后一直带浮点上下文, 该测试要放在其他测试之后
+ */
+static void prvBenchYield(const char *pcName, BaseType_t xUseFpu)
+{
+    xYieldDone = pdFALSE;
+    xYieldUseFpu = xUseFpu;
+    // 对手就绪但优先级相同, 不会抢占
+    (void)xTaskNotifyGive(Peer_Handle);
+
+    while (ulSampleCount < benchSAMPLES)
+    {
+        if (xYieldUseFpu != pdFALSE)
+        {
+            fYieldFloat = fYieldFloat * 1.5f;
+        }
+        ulYieldStamp = portGET_CYCLE_COUNT();
+        taskYIELD();
+        prvRecord(portGET_CYCLE_COUNT() - ulYieldStamp);
+    }
+
+    // 让对手回到等待状态
+    xYieldDone = pdTRUE;
+    taskYIELD();
+
+    prvReport(pcName, -1);
+}
+
+/**
+ * @brief 让出给自己: 同优先级没有其他就绪任务时调用 taskYIELD(), PendSV 选中的仍是当前任务,
+ *        走不保存恢复寄存器的快速路径. 与 yield_same_priority 之差即为一次真正切换上下文的开销
+ */
+static void prvBenchYieldNoSwitch(void)
+{
+    uint32_t i, ulStart;
+
+    for (i = 0; i < benchSAMPLES; i++)
+    {
+        ulStart = portGET_CYCLE_COUNT();
+        taskYIELD();
+        prvRecord(portGET_CYCLE_COUNT() - ulStart);
+    }
+
+    prvReport("yield_no_switch", -1);
+}
+
+/**
+ * @brief 任务切换延迟: 从低优先级任务调用 xTaskNotifyGive() 唤醒等待通知的测试任务, 到测试任务恢复运行,
+ *        包括发送通知, 触发 PendSV, 保存低优先级任务的上下文, 选择任务和恢复测试任务的上下文
+ */
+static void prvBenchPreemptSwitch(void)
+{
+    while (ulSampleCount < benchSAMPLES)
+    {
+        // 唤醒任务优先级更低, 就绪后等到本任务阻塞才运行
+        (void)xTaskNotifyGive(Waker_Handle);
+        // 带超时等待: 虚拟时间模式下无限期等待会被当作所有任务都已阻塞而结束模拟
+        if (ulTaskNotifyTake(pdTRUE, 2) != 0UL)
+        {
+            prvRecord(portGET_CYCLE_COUNT() - ulSwitchStamp);
+        }
+    }
+
+    prvReport("preempt_switch", -1);
+}
+
+/**
+ * @brief 延时唤醒: 从时基中断中 xTickCount 更新到延时到期的最高优先级任务恢复运行
+ */
+static void prvBenchDelayWake(void)
+{
+    while (ulSampleCount < benchSAMPLES)
+    {
+        vTaskDelay(1);
+        prvRecord(portGET_CYCLE_COUNT() - ulTickStamp);
+    }
+
+    prvReport("delay_wake", -1);
+}
+
+/**
+ * @brief 中断唤醒: 从中断中发送任务通知到等待通知的最高优先级任务恢复运行, 中断源为时基中断
+ */
+static void prvBenchIsrWake(void)
+{
+    while (ulSampleCount < benchSAMPLES)
+    {
+        // 紧跟在一次时基中断之后设置通知目标, 保证在下一次时基中断之前已经进入等待
+        vTaskDelay(1);
+        xNotifyTarget = xTaskGetCurrentTaskHandle();
+        // 带超时等待: 虚拟时间模式下无限期等待会被当作所有任务都已阻塞而结束模拟
+        if (ulTaskNotifyTake(pdTRUE, 2) != 0UL)
+        {
+            prvRecord(portGET_CYCLE_COUNT() - ulNotifyStamp);
+        }
+    }
+
+    prvReport("isr_wake", -1);
+}
+
+/**
+ * @brief 批量收发吞吐量: 每个样本发送一批消息再全部接收, 输出每批的耗时分布和每秒收发的消息数
+ * @param const char *pcName: 耗时分布的测试名称
+ * @param UBaseType_t uxBatch: 每批的消息数, 1 即逐条收发
+ */
+static void prvBenchQueueBatch(const char *pcName, UBaseType_t uxBatch)
+{
+    uint32_t i, ulStart, ulElapsed;
+    uint64_t ullTotal = 0;
+
+    for (i = 0; i < benchSAMPLES; i++)
+    {
+        ulStart = portGET_CYCLE_COUNT();
+        (void)uxQueueSendMultiple(xBatchQueue, ulBatchItems, uxBatch, 0);
+        (void)uxQueueReceiveMultiple(xBatchQueue, ulBatchItems, uxBatch, 0);
+        ulElapsed = portGET_CYCLE_COUNT() - ulStart;
+        prvRecord(ulElapsed);
+        ullTotal += (ulElapsed > ulCounterOverhead) ? (ulElapsed - ulCounterOverhead) : 0UL;
+    }
+
+    // 发送和接收各算一次, 与逐条收发的次数可比
+    printf("{\"bench\":\"queue_batch_throughput\",\"batch\":%lu,\"items_per_sec\":%lu}\n",
+           (unsigned long)uxBatch,
+           (unsigned long)((ullTotal != 0U) ? (((uint64_t)benchSAMPLES * uxBatch * 2U * portCYCLE_COUNTER_HZ) / ullTotal) : 0U));
+    prvReport(pcName, -1);
+}
+
+#if (configUSE_RWLOCKS == 1)
+/**
+ * @brief 无竞争时加读锁, 读共享数据, 解锁的开销, 与互斥量获取, 读, 释放对比
+ * @param const char *pcName: 测试名称
+ * @param BaseType_t xUseMutex: pdTRUE 使用互斥量
+ */
+static void prvBenchReadLock(const char *pcName, BaseType_t xUseMutex)
+{
+    uint32_t i, ulStart, ulValue;
+
+    for (i = 0; i < benchSAMPLES; i++)
+    {
+        ulStart = portGET_CYCLE_COUNT();
+        if (xUseMutex != pdFALSE)
+        {
+            (void)xSemaphoreTake(xBenchMutex, portMAX_DELAY);
+            ulValue = ulSharedData[0];
+            (void)xSemaphoreGive(xBenchMutex);
+        }
+        else
+        {
+            (void)xRWLockReadLock(&xBenchRWLock, portMAX_DELAY);
+            ulValue = ulSharedData[0];
+            vRWLockReadUnlock(&xBenchRWLock);
+        }
+        prvRecord(portGET_CYCLE_COUNT() - ulStart);
+    }
+
+    (void)ulValue;
+    prvReport(pcName, -1);
+}
+
+/**
+ * @brief 一次读操作: 加锁后读共享数据, 持有锁时让出给同优先级的另一个读者, 再解锁
+ */
+static void prvReadSection(void)
+{
+    uint32_t x, ulSum = 0;
+
+    if (xReadUseMutex != pdFALSE)
+    {
+        (void)xSemaphoreTake(xBenchMutex, portMAX_DELAY);
+    }
+    else
+    {
+        (void)xRWLockReadLock(&xBenchRWLock, portMAX_DELAY);
+    }
+
+    for (x = 0; x < (sizeof(ulSharedData) / sizeof(ulSharedData[0])); x++)
+    {
+        ulSum += ulSharedData[x];
+    }
+    // 读到一半被切换出去, 另一个读者此时来读
+    taskYIELD();
+    (void)ulSum;
+
+    if (xReadUseMutex != pdFALSE)
+    {
+        (void)xSemaphoreGive(xBenchMutex);
+    }
+    else
+    {
+        vRWLockReadUnlock(&xBenchRWLock);
+    }
+}
+
+/**
+ * @brief 两个同优先级读者的吞吐量: 读者在持有锁时被切换出去, 读写锁允许另一个读者同时读, 互斥量则让它阻塞.
+ *        样本为本任务每次读操作的耗时, 吞吐量为两个读者在测试期间完成的读操作总数
+ * @param const char *pcName: 测试名称
+ * @param BaseType_t xUseMutex: pdTRUE 使用互斥量
+ */
+static void prvBenchReaders(const char *pcName, BaseType_t xUseMutex)
+{
+    uint32_t i, ulStart, ulSectionStart, ulElapsed;
+
+    xReadUseMutex = xUseMutex;
+    xReadDone = pdFALSE;
+    ulReaderReads = 0;
+    xReaderIdle = pdFALSE;
+    // 另一个读者就绪但优先级相同, 不会抢占
+    (void)xTaskNotifyGive(Reader_Handle);
+
+    ulStart = portGET_CYCLE_COUNT();
+    for (i = 0; i < benchSAMPLES; i++)
+    {
+        ulSectionStart = portGET_CYCLE_COUNT();
+        prvReadSection();
+        prvRecord(portGET_CYCLE_COUNT() - ulSectionStart);
+    }
+    ulElapsed = portGET_CYCLE_COUNT() - ulStart;
+
+    printf("{\"bench\":\"%s\",\"reads_per_sec\":%lu}\n",
+           pcName,
+           (unsigned long)((ulElapsed != 0U) ? (((uint64_t)(benchSAMPLES + ulReaderReads) * portCYCLE_COUNTER_HZ) / ulElapsed) : 0U));
+    prvReport(pcName, -1);
+
+    // 让另一个读者做完手上的读操作后回到等待状态
+    xReadDone = pdTRUE;
+    while (xReaderIdle == pdFALSE)
+    {
+        taskYIELD();
+    }
+}
+#endif
+
+#if (configUSE_ACTIVE_OBJECTS == 1)
+/**
+ * @brief 活动对象的分发函数, 每分发完一批事件通知测试任务
+ * @param ActiveObject_t *const pxAO
+ * @param const Event_t *const pxEvent
+ */
+static void prvBenchAODispatch(ActiveObject_t *const pxAO, const Event_t *const pxEvent)
+{
+    (void)pxAO;
+
+    if (pxEvent->xSignal == aoUSER_SIG)
+    {
+        ulAODispatched++;
+        if (ulAODispatched == benchAO_BURST)
+        {
+            ulAODispatched = 0;
+            (void)xTaskNotifyGive(Bench_Handle);
+        }
+    }
+}
+
+/**
+ * @brief 活动对象事件吞吐量: 向优先级更低的活动对象连续投递一批事件, 然后等待它全部分发完毕.
+ *        样本为一批的耗时, 包括投递, 两次任务切换, 出队, 分发和回收
+ * @param const char *pcName: 测试名称
+ * @param BaseType_t xUsePool: pdTRUE 每个事件从事件池分配, pdFALSE 投递静态事件
+ */
+static void prvBenchActiveObject(const char *pcName, BaseType_t xUsePool)
+{
+    uint32_t i, x, ulStart, ulElapsed;
+    uint64_t ullTotal = 0;
+    const Event_t *pxEvent = &xBenchStaticEvent;
+
+    for (i = 0; i < benchSAMPLES; i++)
+    {
+        ulStart = portGET_CYCLE_COUNT();
+        for (x = 0; x < benchAO_BURST; x++)
+        {
+            if (xUsePool != pdFALSE)
+            {
+                pxEvent = pxActiveObjectNewEvent(sizeof(Event_t), aoUSER_SIG);
+            }
+            (void)xActiveObjectPost(&BenchAO, pxEvent);
+        }
+        (void)ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        ulElapsed = portGET_CYCLE_COUNT() - ulStart;
+        prvRecord(ulElapsed);
+        ullTotal += (ulElapsed > ulCounterOverhead) ? (ulElapsed - ulCounterOverhead) : 0UL;
+    }
+
+    printf("{\"bench\":\"%s\",\"burst\":%lu,\"events_per_sec\":%lu}\n",
+           pcName,
+           (unsigned long)benchAO_BURST,
+           (unsigned long)((ullTotal != 0U) ? (((uint64_t)benchSAMPLES * benchAO_BURST * portCYCLE_COUNTER_HZ) / ullTotal) : 0U));
+    prvReport(pcName, -1);
+}
+#endif
+
+/**
+ * @brief 时基中断处理时长: 在临界段中直接调用 xTaskIncrementTick(), 该时基上恰好有 uxSleepers 个任务延时到期
+ * @param UBaseType_t uxSleepers: 同时到期的任务数
+ */
+static void prvBenchTick(UBaseType_t uxSleepers)
+{
+    uint32_t ulRound, ulStart, ulElapsed;
+    UBaseType_t x;
+    BaseType_t xValid;
+
+    for (ulRound = 0; ulRound < benchTICK_ROUNDS; ulRound++)
+    {
+        // 从一个时基周期的开始处出发, 定时任务在本周期内全部进入延时
+        vTaskDelay(1);
+        xSleepTarget = xTickCount + 3;
+        for (x = 0; x < uxSleepers; x++)
+        {
+            (void)xTaskNotifyGive(Sleeper_Handle[x]);
+        }
+
+        // 在到期前一个时基醒来, 由本任务代替时基中断推进到到期时刻
+        vTaskDelay(2);
+
+        xValid = pdFALSE;
+        ulElapsed = 0;
+        portENTER_CRITICAL();
+        if ((TickType_t)(xTickCount + 1) == xSleepTarget)
+        {
+            ulStart = portGET_CYCLE_COUNT();
+            xTaskIncrementTick();
+            ulElapsed = portGET_CYCLE_COUNT() - ulStart;
+            xValid = pdTRUE;
+        }
+        portEXIT_CRITICAL();
+
+        // 真实的时基中断抢先到达时丢弃本轮
+        if (xValid != pdFALSE)
+        {
+            prvRecord(ulElapsed);
+        }
+    }
+
+    prvReport("tick_handler", (int32_t)uxSleepers);
+}
+/******************************************************************************/
+
+/******************************************************************************/
+/**
+ * @brief 测试任务, 依次运行所有测试
+ */
+void Bench_Entry(void *p_arg)
+{
+    static const UBaseType_t uxSleeperCounts[] = {0, 1, 2, 4, benchMAX_SLEEPERS};
+    uint32_t i;
+
+    (void)p_arg;
+
+    // 对手与本任务同优先级, 先让它运行到等待通知的位置
+    taskYIELD();
+
+    prvBenchCounterOverhead();
+#if (configUSE_TRACE_FACILITY == 1)
+    prvBenchTraceRecord();
+#endif
+    prvBenchCritical();
+    prvBenchYield("yield_same_priority", pdFALSE);
+    prvBenchYieldNoSwitch();
+    prvBenchPreemptSwitch();
+    prvBenchDelayWake();
+    prvBenchIsrWake();
+    xBatchQueue = xQueueCreateStatic(benchMAX_BATCH, sizeof(uint32_t), ucBatchQueueStorage, &xBatchQueueBuffer);
+    prvBenchQueueBatch("queue_batch_1", 1);
+    prvBenchQueueBatch("queue_batch_8", 8);
+    prvBenchQueueBatch("queue_batch_64", benchMAX_BATCH);
+#if (configUSE_RWLOCKS == 1)
+    vRWLockInit(&xBenchRWLock);
+    xBenchMutex = xSemaphoreCreateMutexStatic(&xBenchMutexBuffer);
+    prvBenchReadLock("rwlock_read_uncontended", pdFALSE);
+    prvBenchReadLock("mutex_read_uncontended", pdTRUE);
+    prvBenchReaders("rwlock_two_readers", pdFALSE);
+    prvBenchReaders("mutex_two_readers", pdTRUE);
+#endif
+#if (configUSE_ACTIVE_OBJECTS == 1)
+    prvBenchActiveObject("ao_dispatch_static", pdFALSE);
+    prvBenchActiveObject("ao_dispatch_pool", pdTRUE);
+#endif
+    for (i = 0; i < (sizeof(uxSleeperCounts) / sizeof(uxSleeperCounts[0])); i++)
+    {
+        prvBenchTick(uxSleeperCounts[i]);
+    }
+    prvBenchYield("yield_same_priority_fpu", pdTRUE);
+
+#if (configGENERATE_RUN_TIME_STATS == 1)
+    {
+        const configRUN_TIME_COUNTER_TYPE ulTotal = ulTaskGetTotalRunTime();
+
+        prvReportRunTime("Bench", Bench_Handle, ulTotal);
+        prvReportRunTime("Peer", Peer_Handle, ulTotal);
+        prvReportRunTime("Waker", Waker_Handle, ulTotal);
+#if (configUSE_RWLOCKS == 1)
+        prvReportRunTime("Reader", Reader_Handle, ulTotal);
+#endif
+#if (configUSE_ACTIVE_OBJECTS == 1)
+        prvReportRunTime("BenchAO", BenchAO.xTask, ulTotal);
+#endif
+        for (i = 0; i < benchMAX_SLEEPERS; i++)
+        {
+            prvReportRunTime("Sleeper", Sleeper_Handle[i], ulTotal);
+        }
+        prvReportRunTime("IDLE", xTaskGetIdleTaskHandle(), ulTotal);
+    }
+#endif
+
+    printf("{\"bench\":\"done\"}\n");
+    fflush(stdout);
+
+#ifdef portEND_SCHEDULER
+#if (configUSE_TRACE_FACILITY == 1)
+    prvDumpTrace("trace.bin");
+#endif
+    portEND_SCHEDULER();
+#endif
+
+    for (;;)
+    {
+        vTaskDelay(100);
+    }
+}
+
+/**
+ * @brief 同优先级让出测试的对手
+ */
+void Peer_Entry(void *p_arg)
+{
+    (void)p_arg;
+
+    for (;;)
+    {
+        (void)ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        for (;;)
+        {
+            if (xYieldUseFpu != pdFALSE)
+            {
+                fYieldFloat = fYieldFloat * 1.5f;
+            }
+            ulYieldStamp = portGET_CYCLE_COUNT();
+            taskYIELD();
+            if (xYieldDone != pdFALSE)
+            {
+                break;
+            }
+            prvRecord(portGET_CYCLE_COUNT() - ulYieldStamp);
+        }
+    }
+}
+
+#if (configUSE_RWLOCKS == 1)
+/**
+ * @brief 读者测试中的另一个读者, 收到通知后不停地读, 直到测试结束
+ */
+void Reader_Entry(void *p_arg)
+{
+    (void)p_arg;
+
+    for (;;)
+    {
+        (void)ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        while (xReadDone == pdFALSE)
+        {
+            prvReadSection();
+            ulReaderReads++;
+        }
+        xReaderIdle = pdTRUE;
+    }
+}
+#endif
+
+/**
+ * @brief 抢占切换测试中唤醒测试任务的任务
+ */
+void Waker_Entry(void *p_arg)
+{
+    (void)p_arg;
+
+    for (;;)
+    {
+        (void)ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        ulSwitchStamp = portGET_CYCLE_COUNT();
+        (void)xTaskNotifyGive(Bench_Handle);
+    }
+}
+
+/**
+ * @brief 时基中断测试中的定时任务, 收到通知后延时到共同的到期时刻
+ */
+void Sleeper_Entry(void *p_arg)
+{
+    (void)p_arg;
+
+    for (;;)
+    {
+        (void)ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        vTaskDelay((TickType_t)(xSleepTarget - xTickCount));
+    }
+}
+/******************************************************************************/
+
+int main(void)
+{
+    uint32_t i;
+
+    Bench_Handle = xTaskCreateStatic((TaskFuntion_t)Bench_Entry,
+                                     (char *)"Bench",
+                                     (uint32_t)benchSTACK_SIZE,
+                                     (void *)NULL,
+                                     (UBaseType_t)benchPRIORITY,
+                                     (StackType_t *)BenchStack,
+                                     (TCB_t *)&BenchTCB);
+    Peer_Handle = xTaskCreateStatic((TaskFuntion_t)Peer_Entry,
+                                    (char *)"Peer",
+                                    (uint32_t)benchPEER_STACK_SIZE,
+                                    (void *)NULL,
+                                    (UBaseType_t)benchPRIORITY,
+                                    (StackType_t *)PeerStack,
+                                    (TCB_t *)&PeerTCB);
+    Waker_Handle = xTaskCreateStatic((TaskFuntion_t)Waker_Entry,
+                                     (char *)"Waker",
+                                     (uint32_t)benchPEER_STACK_SIZE,
+                                     (void *)NULL,
+                                     (UBaseType_t)benchWAKER_PRIORITY,
+                                     (StackType_t *)WakerStack,
+                                     (TCB_t *)&WakerTCB);
+#if (configUSE_RWLOCKS == 1)
+    Reader_Handle = xTaskCreateStatic((TaskFuntion_t)Reader_Entry,
+                                      (char *)"Reader",
+                                      (uint32_t)benchPEER_STACK_SIZE,
+                                      (void *)NULL,
+                                      (UBaseType_t)benchPRIORITY,
+                                      (StackType_t *)ReaderStack,
+                                      (TCB_t *)&ReaderTCB);
+#endif
+#if (configUSE_ACTIVE_OBJECTS == 1)
+    vActiveObjectPoolInit(&xBenchEventPool, pvBenchEventPoolStorage, sizeof(pvBenchEventPoolStorage), sizeof(Event_t));
+    vActiveObjectStart(&BenchAO,
+                       prvBenchAODispatch,
+                       "BenchAO",
+                       (UBaseType_t)benchSLEEPER_PRIORITY,
+                       pxBenchAOQueue,
+                       (UBaseType_t)benchAO_BURST,
+                       BenchAOStack,
+                       (uint32_t)benchPEER_STACK_SIZE);
+#endif
+    for (i = 0; i < benchMAX_SLEEPERS; i++)
+    {
+        Sleeper_Handle[i] = xTaskCreateStatic((TaskFuntion_t)Sleeper_Entry,
+                                              (char *)"Sleeper",
+                                              (uint32_t)benchSLEEPER_STACK_SIZE,
+                                              (void *)NULL,
+                                              (UBaseType_t)benchSLEEPER_PRIORITY,
+                                              (StackType_t *)SleeperStack[i],
+                                              (TCB_t *)&SleeperTCB[i]);
+    }
+
+    vTaskStartScheduler();
+
+    return 0;
+}
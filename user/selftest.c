@@ -0,0 +1,1415 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "portmacro.h"
+#include "rtos_config.h"
+#include "projectdefs.h"
+#include "task.h"
+#include "rtos.h"
+#include "list.h"
+#include "queue.h"
+#include "semphr.h"
+#include "mailbox.h"
+#include "topic.h"
+#include "seqlock.h"
+#include "mpmc_queue.h"
+
+// 内核自测, 代替 main.c 编译, 只在能结束调度器的移植(POSIX 模拟器)上运行:
+//   cd project/posix && make TEST=1 run
+// 每项测试输出一行 JSON, 失败时附带出错的行号和实际值, 全部结束后调度器退出, 有失败时进程返回非 0.
+// 测试任务运行在最低优先级, 由两个更高优先级的辅助任务制造抢占和竞争, 压力测试由时基钩子在中断中制造竞争.
+// 虚拟时间模式下时基中断不会打断正在运行的任务, 压力测试只在真实时间模式下运行
+// 时基回绕测试要快进约 2^32 个时基, 只在虚拟时间模式下运行
+
+#ifndef portEND_SCHEDULER
+#error "selftest requires a port that can end the scheduler"
+#endif
+
+#if ((configUSE_MUTEXES == 0) || (configUSE_TASK_NOTIFICATIONS == 0))
+#error "selftest requires configUSE_MUTEXES and configUSE_TASK_NOTIFICATIONS"
+#endif
+
+#if ((configUSE_TICK_HOOK == 0) || (configUSE_MAILBOXES == 0) || (configUSE_TOPICS == 0) || \
+     (configUSE_MPMC_QUEUES == 0) || (configUSE_BASIC_TASKS == 0))
+#error "selftest requires configUSE_TICK_HOOK, configUSE_MAILBOXES, configUSE_TOPICS, configUSE_MPMC_QUEUES and configUSE_BASIC_TASKS"
+#endif
+
+extern TickType_t xTickCount;
+extern List_t *pxOverflowDelayedTaskList;
+
+// 优先级: 测试任务与空闲任务相同, 辅助任务 0 和 1 依次更高
+#define testPRIORITY tskIDLE_PRIORITY
+#define testHELPER_COUNT 2
+
+#define testSTACK_SIZE 512
+#define testHELPER_STACK_SIZE 256
+
+// 压力测试持续的时基数
+#define testSTRESS_TICKS 100
+
+// idle task
+TCB_t IdleTaskTCB = {0};
+StackType_t IdleTaskStack[configMINIMAL_STACK_SIZE];
+
+TCB_t TestTCB = {0};
+StackType_t TestStack[testSTACK_SIZE];
+TaskHandle_t Test_Handle = NULL;
+
+TCB_t HelperTCB[testHELPER_COUNT];
+StackType_t HelperStack[testHELPER_COUNT][testHELPER_STACK_SIZE];
+TaskHandle_t Helper_Handle[testHELPER_COUNT];
+
+// 辅助任务收到通知后执行的函数
+typedef void (*TestJob_t)(void);
+static TestJob_t volatile pxHelperJob[testHELPER_COUNT];
+// 时基钩子在中断中执行的函数
+static TestJob_t volatile pxTickJob = NULL;
+
+// 当前测试的名称和结果
+static const char *pcTestName = NULL;
+static BaseType_t xTestFailed = pdFALSE;
+static uint32_t ulPassed = 0;
+static uint32_t ulFailed = 0;
+
+// 检查条件, 失败时输出行号和实际值, 当前测试继续运行
+#define testCHECK(xCondition, lActual)                                   \
+    do                                                                   \
+    {                                                                    \
+        if (!(xCondition))                                               \
+        {                                                                \
+            prvFail(__LINE__, #xCondition, (long)(lActual));             \
+        }                                                                \
+    } while (0)
+
+/******************************************************************************/
+/**
+ * @brief 记录一次检查失败
+ * @param int iLine: 行号
+ * @param const char *pcCondition: 检查的条件
+ * @param long lActual: 实际值
+ */
+static void prvFail(int iLine, const char *pcCondition, long lActual)
+{
+    xTestFailed = pdTRUE;
+    printf("{\"test\":\"%s\",\"line\":%d,\"check\":\"%s\",\"actual\":%ld}\n",
+           pcTestName, iLine, pcCondition, lActual);
+    fflush(stdout);
+}
+
+/**
+ * @brief 运行一项测试并输出结果
+ * @param const char *pcName: 测试名称
+ * @param TestJob_t pxTest: 测试函数
+ */
+static void prvRun(const char *pcName, TestJob_t pxTest)
+{
+    pcTestName = pcName;
+    xTestFailed = pdFALSE;
+
+    pxTest();
+
+    if (xTestFailed == pdFALSE)
+    {
+        ulPassed++;
+    }
+    else
+    {
+        ulFailed++;
+    }
+
+    printf("{\"test\":\"%s\",\"result\":\"%s\"}\n", pcName, (xTestFailed == pdFALSE) ? "pass" : "fail");
+    fflush(stdout);
+}
+
+/**
+ * @brief 让辅助任务执行一个函数, 辅助任务优先级高于测试任务, 返回时它已经运行到阻塞或执行完毕
+ * @param UBaseType_t uxHelper: 辅助任务编号
+ * @param TestJob_t pxJob
+ */
+static void prvStartHelper(UBaseType_t uxHelper, TestJob_t pxJob)
+{
+    pxHelperJob[uxHelper] = pxJob;
+    (void)xTaskNotifyGive(Helper_Handle[uxHelper]);
+}
+
+/**
+ * @brief 时基钩子, 在时基中断中执行测试任务指定的函数
+ */
+void vApplicationTickHook(void)
+{
+    const TestJob_t pxJob = pxTickJob;
+
+    if (pxJob != NULL)
+    {
+        pxJob();
+    }
+}
+
+/**
+ * @brief 任务当前的优先级
+ * @param TaskHandle_t xTask
+ * @returns UBaseType_t
+ */
+static UBaseType_t prvPriorityOf(TaskHandle_t xTask)
+{
+    return ((TCB_t *)xTask)->uxPriority;
+}
+/******************************************************************************/
+
+/******************************************************************************/
+// 互斥量测试共用的互斥量, 天花板 1 和天花板 2 各一个, 以及一个优先级继承互斥量和一个递归互斥量
+static Queue_t xCeiling1Buffer;
+static Queue_t xCeiling2Buffer;
+static Queue_t xInheritBuffer;
+static Queue_t xRecursiveBuffer;
+static SemaphoreHandle_t xCeiling1 = NULL;
+static SemaphoreHandle_t xCeiling2 = NULL;
+static SemaphoreHandle_t xInherit = NULL;
+static SemaphoreHandle_t xRecursive = NULL;
+
+/**
+ * @brief 辅助任务: 获取优先级继承互斥量后立即释放
+ */
+static void prvTakeGiveInherit(void)
+{
+    if (xSemaphoreTake(xInherit, portMAX_DELAY) == pdPASS)
+    {
+        (void)xSemaphoreGive(xInherit);
+    }
+}
+
+/**
+ * @brief 持有天花板互斥量时释放优先级继承互斥量, 优先级不能低于仍持有的天花板
+ */
+static void prvTestInheritGiveUnderCeiling(void)
+{
+    testCHECK(xSemaphoreTake(xCeiling2, 0) == pdPASS, 0);
+    testCHECK(prvPriorityOf(Test_Handle) == 2U, prvPriorityOf(Test_Handle));
+
+    testCHECK(xSemaphoreTake(xInherit, 0) == pdPASS, 0);
+    testCHECK(xSemaphoreGive(xInherit) == pdPASS, 0);
+    testCHECK(prvPriorityOf(Test_Handle) == 2U, prvPriorityOf(Test_Handle));
+
+    testCHECK(xSemaphoreGive(xCeiling2) == pdPASS, 0);
+    testCHECK(prvPriorityOf(Test_Handle) == testPRIORITY, prvPriorityOf(Test_Handle));
+    testCHECK(((TCB_t *)Test_Handle)->uxMutexesHeld == 0U, ((TCB_t *)Test_Handle)->uxMutexesHeld);
+}
+
+/**
+ * @brief 持有优先级继承互斥量并已继承优先级时释放天花板互斥量, 保持继承的优先级
+ */
+static void prvTestCeilingGiveKeepsInherited(void)
+{
+    testCHECK(xSemaphoreTake(xInherit, 0) == pdPASS, 0);
+
+    // 辅助任务 0 阻塞在互斥量上, 测试任务继承其优先级
+    prvStartHelper(0U, prvTakeGiveInherit);
+    testCHECK(prvPriorityOf(Test_Handle) == prvPriorityOf(Helper_Handle[0]), prvPriorityOf(Test_Handle));
+
+    testCHECK(xSemaphoreTake(xCeiling2, 0) == pdPASS, 0);
+    testCHECK(prvPriorityOf(Test_Handle) == 2U, prvPriorityOf(Test_Handle));
+    testCHECK(xSemaphoreGive(xCeiling2) == pdPASS, 0);
+    testCHECK(prvPriorityOf(Test_Handle) == prvPriorityOf(Helper_Handle[0]), prvPriorityOf(Test_Handle));
+
+    // 释放后辅助任务立即抢占, 获取并释放互斥量
+    testCHECK(xSemaphoreGive(xInherit) == pdPASS, 0);
+    testCHECK(prvPriorityOf(Test_Handle) == testPRIORITY, prvPriorityOf(Test_Handle));
+    testCHECK(xSemaphoreGetMutexHolder(xInherit) == NULL, 0);
+}
+
+/**
+ * @brief 天花板互斥量按获得顺序释放, 优先级降到仍持有的最高天花板
+ */
+static void prvTestCeilingNestedInOrder(void)
+{
+    testCHECK(xSemaphoreTake(xCeiling1, 0) == pdPASS, 0);
+    testCHECK(prvPriorityOf(Test_Handle) == 1U, prvPriorityOf(Test_Handle));
+    testCHECK(xSemaphoreTake(xCeiling2, 0) == pdPASS, 0);
+    testCHECK(prvPriorityOf(Test_Handle) == 2U, prvPriorityOf(Test_Handle));
+
+    testCHECK(xSemaphoreGive(xCeiling2) == pdPASS, 0);
+    testCHECK(prvPriorityOf(Test_Handle) == 1U, prvPriorityOf(Test_Handle));
+    testCHECK(xSemaphoreGive(xCeiling1) == pdPASS, 0);
+    testCHECK(prvPriorityOf(Test_Handle) == testPRIORITY, prvPriorityOf(Test_Handle));
+}
+
+/**
+ * @brief 天花板互斥量不按获得顺序释放, 优先级仍降到仍持有的最高天花板, 全部释放后回到基础优先级
+ */
+static void prvTestCeilingNestedOutOfOrder(void)
+{
+    testCHECK(xSemaphoreTake(xCeiling1, 0) == pdPASS, 0);
+    testCHECK(xSemaphoreTake(xCeiling2, 0) == pdPASS, 0);
+    testCHECK(prvPriorityOf(Test_Handle) == 2U, prvPriorityOf(Test_Handle));
+
+    testCHECK(xSemaphoreGive(xCeiling1) == pdPASS, 0);
+    testCHECK(prvPriorityOf(Test_Handle) == 2U, prvPriorityOf(Test_Handle));
+    testCHECK(xSemaphoreGive(xCeiling2) == pdPASS, 0);
+    testCHECK(prvPriorityOf(Test_Handle) == testPRIORITY, prvPriorityOf(Test_Handle));
+    testCHECK(((TCB_t *)Test_Handle)->uxMutexesHeld == 0U, ((TCB_t *)Test_Handle)->uxMutexesHeld);
+}
+
+// 竞争测试中辅助任务的获取结果和等待的时基数
+static volatile BaseType_t xHelperResult = pdFAIL;
+static volatile TickType_t xHelperWaited = 0;
+static volatile UBaseType_t uxHelperPriority = 0;
+
+/**
+ * @brief 辅助任务: 无限期等待天花板 1 的互斥量, 获得后记下自己的优先级再释放
+ */
+static void prvTakeCeilingForever(void)
+{
+    const TickType_t xStart = xTickCount;
+
+    xHelperResult = xSemaphoreTake(xCeiling1, portMAX_DELAY);
+    xHelperWaited = xTickCount - xStart;
+    if (xHelperResult == pdPASS)
+    {
+        uxHelperPriority = prvPriorityOf(xTaskGetCurrentTaskHandle());
+        (void)xSemaphoreGive(xCeiling1);
+    }
+}
+
+/**
+ * @brief 辅助任务: 等待天花板 1 的互斥量 2 个时基
+ */
+static void prvTakeCeilingTimeout(void)
+{
+    const TickType_t xStart = xTickCount;
+
+    xHelperResult = xSemaphoreTake(xCeiling1, 2);
+    xHelperWaited = xTickCount - xStart;
+    if (xHelperResult == pdPASS)
+    {
+        (void)xSemaphoreGive(xCeiling1);
+    }
+}
+
+/**
+ * @brief 持有者阻塞时天花板互斥量被竞争, 获取者阻塞等待, 释放后获得互斥量并提升到天花板
+ */
+static void prvTestCeilingContendedBlocks(void)
+{
+    xHelperResult = pdFAIL;
+    testCHECK(xSemaphoreTake(xCeiling1, 0) == pdPASS, 0);
+
+    // 辅助任务 0 与天花板同优先级, 在测试任务持有互斥量并阻塞时运行
+    prvStartHelper(0U, prvTakeCeilingForever);
+    vTaskDelay(3);
+    testCHECK(xHelperResult == pdFAIL, xHelperResult);
+
+    // 释放后辅助任务立即抢占
+    testCHECK(xSemaphoreGive(xCeiling1) == pdPASS, 0);
+    testCHECK(xHelperResult == pdPASS, xHelperResult);
+    testCHECK(xHelperWaited >= 2U, xHelperWaited);
+    testCHECK(uxHelperPriority == 1U, uxHelperPriority);
+    testCHECK(prvPriorityOf(Helper_Handle[0]) == 1U, prvPriorityOf(Helper_Handle[0]));
+    testCHECK(xSemaphoreGetMutexHolder(xCeiling1) == NULL, 0);
+}
+
+/**
+ * @brief 天花板互斥量被竞争时等待超时, 返回 errQUEUE_EMPTY 且确实等待了指定的时基数
+ */
+static void prvTestCeilingContendedTimeout(void)
+{
+    xHelperResult = pdPASS;
+    testCHECK(xSemaphoreTake(xCeiling1, 0) == pdPASS, 0);
+
+    prvStartHelper(0U, prvTakeCeilingTimeout);
+    vTaskDelay(5);
+    testCHECK(xHelperResult == errQUEUE_EMPTY, xHelperResult);
+    testCHECK(xHelperWaited >= 2U, xHelperWaited);
+
+    testCHECK(xSemaphoreGive(xCeiling1) == pdPASS, 0);
+    testCHECK(prvPriorityOf(Test_Handle) == testPRIORITY, prvPriorityOf(Test_Handle));
+}
+
+// 递归互斥量测试中嵌套获取的层数
+#define testRECURSIVE_DEPTH 3
+
+/**
+ * @brief 辅助任务: 不等待地获取递归互斥量, 获得后立即释放
+ */
+static void prvTakeRecursiveNoWait(void)
+{
+    xHelperResult = xSemaphoreTakeRecursive(xRecursive, 0);
+    if (xHelperResult == pdPASS)
+    {
+        (void)xSemaphoreGiveRecursive(xRecursive);
+    }
+}
+
+/**
+ * @brief 辅助任务: 无限期等待递归互斥量, 获得后记下自己的优先级再释放
+ */
+static void prvTakeRecursiveForever(void)
+{
+    xHelperResult = xSemaphoreTakeRecursive(xRecursive, portMAX_DELAY);
+    if (xHelperResult == pdPASS)
+    {
+        uxHelperPriority = prvPriorityOf(xTaskGetCurrentTaskHandle());
+        (void)xSemaphoreGiveRecursive(xRecursive);
+    }
+}
+
+/**
+ * @brief 辅助任务: 释放不属于自己的递归互斥量
+ */
+static void prvGiveRecursiveNotHolder(void)
+{
+    xHelperResult = xSemaphoreGiveRecursive(xRecursive);
+}
+
+/**
+ * @brief 递归互斥量嵌套获取, 每次释放计数减一, 只有最外层释放才真正释放互斥量
+ */
+static void prvTestRecursiveNesting(void)
+{
+    const Queue_t *const pxRecursive = (const Queue_t *)xRecursive;
+    UBaseType_t x;
+
+    for (x = 1; x <= testRECURSIVE_DEPTH; x++)
+    {
+        testCHECK(xSemaphoreTakeRecursive(xRecursive, 0) == pdPASS, 0);
+        testCHECK(pxRecursive->uxRecursiveCallCount == x, pxRecursive->uxRecursiveCallCount);
+    }
+    testCHECK(((TCB_t *)Test_Handle)->uxMutexesHeld == 1U, ((TCB_t *)Test_Handle)->uxMutexesHeld);
+
+    for (x = testRECURSIVE_DEPTH - 1U; x > 0U; x--)
+    {
+        testCHECK(xSemaphoreGiveRecursive(xRecursive) == pdPASS, 0);
+        testCHECK(pxRecursive->uxRecursiveCallCount == x, pxRecursive->uxRecursiveCallCount);
+        testCHECK(xSemaphoreGetMutexHolder(xRecursive) == Test_Handle, 0);
+
+        // 仍被持有, 其他任务获取不到
+        xHelperResult = pdPASS;
+        prvStartHelper(0U, prvTakeRecursiveNoWait);
+        testCHECK(xHelperResult == errQUEUE_EMPTY, xHelperResult);
+    }
+
+    testCHECK(xSemaphoreGiveRecursive(xRecursive) == pdPASS, 0);
+    testCHECK(pxRecursive->uxRecursiveCallCount == 0U, pxRecursive->uxRecursiveCallCount);
+    testCHECK(xSemaphoreGetMutexHolder(xRecursive) == NULL, 0);
+    testCHECK(((TCB_t *)Test_Handle)->uxMutexesHeld == 0U, ((TCB_t *)Test_Handle)->uxMutexesHeld);
+
+    xHelperResult = pdFAIL;
+    prvStartHelper(0U, prvTakeRecursiveNoWait);
+    testCHECK(xHelperResult == pdPASS, xHelperResult);
+}
+
+/**
+ * @brief 高优先级任务阻塞在嵌套持有的递归互斥量上, 持有者在整个嵌套期间保持继承的优先级,
+ *        直到最外层释放时等待者才运行, 持有者恢复基础优先级
+ */
+static void prvTestRecursiveInheritThroughNesting(void)
+{
+    UBaseType_t x;
+
+    for (x = 0; x < testRECURSIVE_DEPTH; x++)
+    {
+        testCHECK(xSemaphoreTakeRecursive(xRecursive, 0) == pdPASS, 0);
+    }
+
+    // 辅助任务 1 优先级最高, 阻塞后测试任务继承其优先级
+    xHelperResult = pdFAIL;
+    uxHelperPriority = 0U;
+    prvStartHelper(1U, prvTakeRecursiveForever);
+    testCHECK(xHelperResult == pdFAIL, xHelperResult);
+    testCHECK(prvPriorityOf(Test_Handle) == prvPriorityOf(Helper_Handle[1]), prvPriorityOf(Test_Handle));
+
+    for (x = testRECURSIVE_DEPTH - 1U; x > 0U; x--)
+    {
+        testCHECK(xSemaphoreGiveRecursive(xRecursive) == pdPASS, 0);
+        testCHECK(xHelperResult == pdFAIL, xHelperResult);
+        testCHECK(prvPriorityOf(Test_Handle) == prvPriorityOf(Helper_Handle[1]), prvPriorityOf(Test_Handle));
+    }
+
+    // 最外层释放后辅助任务立即抢占, 获取并释放互斥量
+    testCHECK(xSemaphoreGiveRecursive(xRecursive) == pdPASS, 0);
+    testCHECK(xHelperResult == pdPASS, xHelperResult);
+    testCHECK(uxHelperPriority == prvPriorityOf(Helper_Handle[1]), uxHelperPriority);
+    testCHECK(prvPriorityOf(Test_Handle) == testPRIORITY, prvPriorityOf(Test_Handle));
+    testCHECK(xSemaphoreGetMutexHolder(xRecursive) == NULL, 0);
+}
+
+/**
+ * @brief 非持有者释放递归互斥量返回 pdFAIL, 不改变计数和持有者
+ */
+static void prvTestRecursiveGiveNotHolder(void)
+{
+    const Queue_t *const pxRecursive = (const Queue_t *)xRecursive;
+
+    // 无人持有
+    testCHECK(xSemaphoreGiveRecursive(xRecursive) == pdFAIL, 0);
+
+    testCHECK(xSemaphoreTakeRecursive(xRecursive, 0) == pdPASS, 0);
+    testCHECK(xSemaphoreTakeRecursive(xRecursive, 0) == pdPASS, 0);
+
+    xHelperResult = pdPASS;
+    prvStartHelper(0U, prvGiveRecursiveNotHolder);
+    testCHECK(xHelperResult == pdFAIL, xHelperResult);
+    testCHECK(pxRecursive->uxRecursiveCallCount == 2U, pxRecursive->uxRecursiveCallCount);
+    testCHECK(xSemaphoreGetMutexHolder(xRecursive) == Test_Handle, 0);
+
+    testCHECK(xSemaphoreGiveRecursive(xRecursive) == pdPASS, 0);
+    testCHECK(xSemaphoreGiveRecursive(xRecursive) == pdPASS, 0);
+    testCHECK(xSemaphoreGetMutexHolder(xRecursive) == NULL, 0);
+    testCHECK(xSemaphoreGiveRecursive(xRecursive) == pdFAIL, 0);
+}
+/******************************************************************************/
+
+/******************************************************************************/
+// 批量收发测试共用的队列, 长度 2
+#define testBATCH_LENGTH 2
+static Queue_t xBatchQueueBuffer;
+static uint8_t ucBatchQueueStorage[testBATCH_LENGTH * sizeof(uint32_t)];
+static QueueHandle_t xBatchQueue = NULL;
+
+// 每个辅助任务收发成功的消息数
+static volatile uint32_t ulHelperItems[testHELPER_COUNT];
+
+/**
+ * @brief 辅助任务: 从批量收发队列接收一条消息, 最多等待 5 个时基
+ * @param UBaseType_t uxHelper: 辅助任务编号
+ */
+static void prvReceiveOne(UBaseType_t uxHelper)
+{
+    uint32_t ulItem = 0;
+
+    if (xQueueReceive(xBatchQueue, &ulItem, 5) == pdPASS)
+    {
+        ulHelperItems[uxHelper]++;
+    }
+}
+
+static void prvReceiveOne0(void)
+{
+    prvReceiveOne(0U);
+}
+
+static void prvReceiveOne1(void)
+{
+    prvReceiveOne(1U);
+}
+
+/**
+ * @brief 辅助任务: 向批量收发队列发送一条消息, 最多等待 5 个时基
+ * @param UBaseType_t uxHelper: 辅助任务编号
+ */
+static void prvSendOne(UBaseType_t uxHelper)
+{
+    const uint32_t ulItem = (uint32_t)uxHelper;
+
+    if (xQueueSend(xBatchQueue, &ulItem, 5) == pdPASS)
+    {
+        ulHelperItems[uxHelper]++;
+    }
+}
+
+static void prvSendOne0(void)
+{
+    prvSendOne(0U);
+}
+
+static void prvSendOne1(void)
+{
+    prvSendOne(1U);
+}
+
+/**
+ * @brief 两个接收者阻塞在空队列上时批量发送 2 条消息, 两个接收者都被唤醒并各取走一条
+ */
+static void prvTestBatchSendWakesAllReceivers(void)
+{
+    const uint32_t ulItems[testBATCH_LENGTH] = {1UL, 2UL};
+
+    ulHelperItems[0] = 0;
+    ulHelperItems[1] = 0;
+    prvStartHelper(0U, prvReceiveOne0);
+    prvStartHelper(1U, prvReceiveOne1);
+
+    // 被唤醒的辅助任务优先级更高, 返回时已经取走消息, 不能靠等待超时后重试
+    testCHECK(uxQueueSendMultiple(xBatchQueue, ulItems, testBATCH_LENGTH, 0) == testBATCH_LENGTH, 0);
+    testCHECK(ulHelperItems[0] == 1UL, ulHelperItems[0]);
+    testCHECK(ulHelperItems[1] == 1UL, ulHelperItems[1]);
+    vTaskDelay(6);
+    testCHECK(uxQueueMessagesWaiting(xBatchQueue) == 0U, uxQueueMessagesWaiting(xBatchQueue));
+}
+
+/**
+ * @brief 两个发送者阻塞在满队列上时批量接收 2 条消息, 两个发送者都被唤醒并各写入一条
+ */
+static void prvTestBatchReceiveWakesAllSenders(void)
+{
+    const uint32_t ulItems[testBATCH_LENGTH] = {1UL, 2UL};
+    uint32_t ulBuffer[testBATCH_LENGTH];
+
+    testCHECK(uxQueueSendMultiple(xBatchQueue, ulItems, testBATCH_LENGTH, 0) == testBATCH_LENGTH, 0);
+
+    ulHelperItems[0] = 0;
+    ulHelperItems[1] = 0;
+    prvStartHelper(0U, prvSendOne0);
+    prvStartHelper(1U, prvSendOne1);
+
+    testCHECK(uxQueueReceiveMultiple(xBatchQueue, ulBuffer, testBATCH_LENGTH, 0) == testBATCH_LENGTH, 0);
+    testCHECK(ulHelperItems[0] == 1UL, ulHelperItems[0]);
+    testCHECK(ulHelperItems[1] == 1UL, ulHelperItems[1]);
+    vTaskDelay(6);
+    testCHECK(uxQueueMessagesWaiting(xBatchQueue) == 2U, uxQueueMessagesWaiting(xBatchQueue));
+
+    (void)uxQueueReceiveMultiple(xBatchQueue, ulBuffer, testBATCH_LENGTH, 0);
+}
+/******************************************************************************/
+
+/******************************************************************************/
+/**
+ * @brief 邮箱版本号回绕: 从最大版本号再写入一次, 新版本号跳过 mailboxNO_VERSION, 读者照常读到新值
+ */
+static void prvTestMailboxVersionWrap(void)
+{
+    static Mailbox_t xMailbox;
+    static uint32_t ulStorage;
+    const uint32_t ulValue = 0x5a5aUL;
+    uint32_t ulBuffer = 0;
+    uint32_t ulLastVersion = 0x7fffffffUL;
+
+    vMailboxInit(&xMailbox, (uint8_t *)&ulStorage, sizeof(ulStorage));
+    // 相当于已经写入了 0x7fffffff 次
+    xMailbox.xLock.ulSequence = 0xfffffffeUL;
+    testCHECK(ulMailboxGetVersion(&xMailbox) == 0x7fffffffUL, ulMailboxGetVersion(&xMailbox));
+
+    vMailboxOverwrite(&xMailbox, &ulValue);
+    testCHECK(ulMailboxGetVersion(&xMailbox) == 1UL, ulMailboxGetVersion(&xMailbox));
+    testCHECK(ulMailboxPeek(&xMailbox, &ulBuffer) == 1UL, 0);
+    testCHECK(ulBuffer == ulValue, ulBuffer);
+
+    ulBuffer = 0;
+    testCHECK(xMailboxReceive(&xMailbox, &ulBuffer, &ulLastVersion, 0) == pdPASS, 0);
+    testCHECK(ulBuffer == ulValue, ulBuffer);
+    testCHECK(ulLastVersion == 1UL, ulLastVersion);
+
+    vMailboxOverwrite(&xMailbox, &ulValue);
+    testCHECK(ulMailboxGetVersion(&xMailbox) == 2UL, ulMailboxGetVersion(&xMailbox));
+}
+/******************************************************************************/
+
+/******************************************************************************/
+// 主题测试共用的主题, 样本为 uint32_t, 只保留最新值
+static Topic_t xTopic;
+static uint8_t ucTopicBuffer[topicBUFFER_SIZE(sizeof(uint32_t), 1U)];
+
+/**
+ * @brief 辅助任务: 2 个时基后发布一个样本
+ */
+static void prvPublishLater(void)
+{
+    const uint32_t ulSample = 1UL;
+
+    vTaskDelay(2);
+    vTopicPublish(&xTopic, &ulSample);
+}
+
+/**
+ * @brief 任务通知计数值中有残留的通知时等待主题, 不能提前报告超时, 之后发布的样本仍能等到
+ */
+static void prvTestTopicWaitStaleNotification(void)
+{
+    TopicSubscriber_t xSubscriber;
+    TickType_t xStart = 0;
+
+    vTopicSubscribe(&xSubscriber, &xTopic);
+
+    // 没有发布: 等满 3 个时基才返回超时
+    (void)xTaskNotifyGive(Test_Handle);
+    xStart = xTickCount;
+    testCHECK(xTopicWait(&xSubscriber, 3) == pdFALSE, 0);
+    testCHECK((TickType_t)(xTickCount - xStart) >= 3U, xTickCount - xStart);
+
+    // 等待期间发布: 残留的通知不会让等待提前结束
+    (void)xTaskNotifyGive(Test_Handle);
+    prvStartHelper(0U, prvPublishLater);
+    xStart = xTickCount;
+    testCHECK(xTopicWait(&xSubscriber, 10) == pdTRUE, 0);
+    testCHECK((TickType_t)(xTickCount - xStart) >= 2U, xTickCount - xStart);
+    testCHECK(xTopic.pxWaitingList == NULL, 0);
+    testCHECK(ulTaskNotifyTake(pdTRUE, 0) == 0UL, 0);
+}
+/******************************************************************************/
+
+/******************************************************************************/
+// 基本任务测试: A 和 B 的优先级为 1, C 和 D 的优先级为 2, 都高于测试任务.
+// 每个基本任务开始时在日志中记下自己的大写字母, 结束时记下小写字母
+#define testBASIC_COUNT 4
+#define testBASIC_LOG_LENGTH 16
+
+TCB_t BasicTCB[testBASIC_COUNT];
+TaskHandle_t Basic_Handle[testBASIC_COUNT];
+
+// 基本任务开始后执行的函数
+static TestJob_t volatile pxBasicJob[testBASIC_COUNT];
+// 基本任务最近一次运行时的栈帧位置和它抢占的基本任务
+static StackType_t *volatile pxBasicFrame[testBASIC_COUNT];
+static TCB_t *volatile pxBasicPreempted[testBASIC_COUNT];
+
+static char cBasicLog[testBASIC_LOG_LENGTH + 1];
+static volatile UBaseType_t uxBasicLogLength = 0;
+
+/**
+ * @brief 在基本任务日志末尾记下一个字符
+ * @param char cEvent
+ */
+static void prvBasicLog(char cEvent)
+{
+    if (uxBasicLogLength < testBASIC_LOG_LENGTH)
+    {
+        cBasicLog[uxBasicLogLength] = cEvent;
+        uxBasicLogLength++;
+        cBasicLog[uxBasicLogLength] = '\0';
+    }
+}
+
+/**
+ * @brief 清空基本任务日志和各基本任务要执行的函数
+ */
+static void prvBasicReset(void)
+{
+    UBaseType_t x;
+
+    for (x = 0; x < testBASIC_COUNT; x++)
+    {
+        pxBasicJob[x] = NULL;
+        pxBasicFrame[x] = NULL;
+        pxBasicPreempted[x] = NULL;
+    }
+    uxBasicLogLength = 0;
+    cBasicLog[0] = '\0';
+}
+
+/**
+ * @brief 基本任务, 记下栈帧位置后执行测试任务指定的函数, 运行至完成
+ */
+void Basic_Entry(void *p_arg)
+{
+    const UBaseType_t uxBasic = (UBaseType_t)(uintptr_t)p_arg;
+    const TCB_t *const pxTCB = (const TCB_t *)Basic_Handle[uxBasic];
+
+    prvBasicLog((char)('A' + uxBasic));
+    // POSIX 移植的 pxTopOfStack 就是栈帧在共享栈上的位置, 运行期间不变
+    pxBasicFrame[uxBasic] = (StackType_t *)pxTCB->pxTopOfStack;
+    pxBasicPreempted[uxBasic] = pxTCB->pxPreemptedBasicTask;
+
+    if (pxBasicJob[uxBasic] != NULL)
+    {
+        pxBasicJob[uxBasic]();
+    }
+
+    prvBasicLog((char)('a' + uxBasic));
+}
+
+static void prvActivateBasicB(void)
+{
+    (void)xTaskActivate(Basic_Handle[1]);
+}
+
+static void prvActivateBasicC(void)
+{
+    (void)xTaskActivate(Basic_Handle[2]);
+}
+
+static void prvActivateBasicCThenD(void)
+{
+    (void)xTaskActivate(Basic_Handle[2]);
+    (void)xTaskActivate(Basic_Handle[3]);
+}
+
+static void prvActivateBasicA(void)
+{
+    (void)xTaskActivate(Basic_Handle[0]);
+}
+
+/**
+ * @brief 基本任务激活更高优先级的基本任务, 后者立即在共享栈上嵌套运行, 完成后返回前者
+ */
+static void prvTestBasicNestedActivation(void)
+{
+    prvBasicReset();
+    pxBasicJob[0] = prvActivateBasicC;
+
+    testCHECK(xTaskActivate(Basic_Handle[0]) == pdPASS, 0);
+    testCHECK(strcmp(cBasicLog, "ACca") == 0, uxBasicLogLength);
+    testCHECK(pxBasicPreempted[0] == NULL, 0);
+    testCHECK(pxBasicPreempted[2] == (TCB_t *)Basic_Handle[0], 0);
+    testCHECK(pxBasicFrame[2] < pxBasicFrame[0], pxBasicFrame[0] - pxBasicFrame[2]);
+}
+
+/**
+ * @brief 基本任务激活同等或更低优先级的基本任务, 后者等前者完成后才开始运行
+ */
+static void prvTestBasicDeferredActivation(void)
+{
+    // 同等优先级
+    prvBasicReset();
+    pxBasicJob[0] = prvActivateBasicB;
+    testCHECK(xTaskActivate(Basic_Handle[0]) == pdPASS, 0);
+    testCHECK(strcmp(cBasicLog, "AaBb") == 0, uxBasicLogLength);
+    testCHECK(pxBasicPreempted[1] == NULL, 0);
+
+    // 更低优先级
+    prvBasicReset();
+    pxBasicJob[2] = prvActivateBasicA;
+    testCHECK(xTaskActivate(Basic_Handle[2]) == pdPASS, 0);
+    testCHECK(strcmp(cBasicLog, "CcAa") == 0, uxBasicLogLength);
+    testCHECK(pxBasicPreempted[0] == NULL, 0);
+
+    // 全部完成后不在就绪列表中
+    testCHECK(((TCB_t *)Basic_Handle[0])->xStateListItem.pvContainer == NULL, 0);
+    testCHECK(((TCB_t *)Basic_Handle[2])->xStateListItem.pvContainer == NULL, 0);
+}
+
+/**
+ * @brief 共享栈后进先出: 先后嵌套的两个基本任务使用同一个栈帧位置, 共享栈为空时从栈底开始
+ */
+static void prvTestBasicStackLifo(void)
+{
+    StackType_t *pxBottom = NULL;
+
+    prvBasicReset();
+    pxBasicJob[0] = prvActivateBasicCThenD;
+    testCHECK(xTaskActivate(Basic_Handle[0]) == pdPASS, 0);
+    testCHECK(strcmp(cBasicLog, "ACcDda") == 0, uxBasicLogLength);
+    testCHECK(pxBasicFrame[2] < pxBasicFrame[0], pxBasicFrame[0] - pxBasicFrame[2]);
+    testCHECK(pxBasicFrame[3] == pxBasicFrame[2], pxBasicFrame[3] - pxBasicFrame[2]);
+    pxBottom = pxBasicFrame[0];
+
+    // 共享栈已空, 单独运行的基本任务从栈底开始
+    prvBasicReset();
+    testCHECK(xTaskActivate(Basic_Handle[3]) == pdPASS, 0);
+    testCHECK(strcmp(cBasicLog, "Dd") == 0, uxBasicLogLength);
+    testCHECK(pxBasicFrame[3] == pxBottom, pxBasicFrame[3] - pxBottom);
+    testCHECK(pxBasicPreempted[3] == NULL, 0);
+}
+
+#if (configUSE_VIRTUAL_TIME == 0)
+// 时基钩子中激活基本任务的结果, 依次为: 激活 A, 在 A 运行期间再次激活 A, 在 A 运行期间激活 C
+static volatile BaseType_t xBasicIsrResult[3];
+static volatile UBaseType_t uxBasicIsrStep = 0;
+
+/**
+ * @brief 时基钩子: 第一个时基激活 A, 之后 A 仍在运行时再次激活 A 并激活 C
+ */
+static void prvActivateBasicFromTick(void)
+{
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+    if (uxBasicIsrStep == 0U)
+    {
+        xBasicIsrResult[0] = xTaskActivateFromISR(Basic_Handle[0], &xHigherPriorityTaskWoken);
+        uxBasicIsrStep = 1U;
+    }
+    else if (uxBasicIsrStep == 2U)
+    {
+        xBasicIsrResult[1] = xTaskActivateFromISR(Basic_Handle[0], &xHigherPriorityTaskWoken);
+        xBasicIsrResult[2] = xTaskActivateFromISR(Basic_Handle[2], &xHigherPriorityTaskWoken);
+        uxBasicIsrStep = 3U;
+        pxTickJob = NULL;
+    }
+
+    // 时基中断结束时总会触发一次任务切换
+    (void)xHigherPriorityTaskWoken;
+}
+
+/**
+ * @brief A 的函数: 等时基钩子在它运行期间再次激活它并激活 C
+ */
+static void prvBasicWaitForTick(void)
+{
+    uxBasicIsrStep = 2U;
+    while (uxBasicIsrStep != 3U)
+    {
+    }
+}
+
+/**
+ * @brief 在中断中激活基本任务: 正在运行的基本任务不能再次激活, 更高优先级的基本任务在中断返回时嵌套运行,
+ *        运行结束后可以再次激活
+ */
+static void prvTestBasicReactivateFromISR(void)
+{
+    const TickType_t xStart = xTickCount;
+
+    prvBasicReset();
+    pxBasicJob[0] = prvBasicWaitForTick;
+    xBasicIsrResult[0] = pdFAIL;
+    xBasicIsrResult[1] = pdPASS;
+    xBasicIsrResult[2] = pdFAIL;
+    uxBasicIsrStep = 0U;
+    pxTickJob = prvActivateBasicFromTick;
+
+    // 测试任务优先级最低, A 被激活后立即抢占, 到这里 A 已经完成
+    while ((uxBasicIsrStep != 3U) && ((TickType_t)(xTickCount - xStart) < 10U))
+    {
+        vTaskDelay(1);
+    }
+    pxTickJob = NULL;
+
+    testCHECK(xBasicIsrResult[0] == pdPASS, xBasicIsrResult[0]);
+    testCHECK(xBasicIsrResult[1] == pdFAIL, xBasicIsrResult[1]);
+    testCHECK(xBasicIsrResult[2] == pdPASS, xBasicIsrResult[2]);
+    testCHECK(strcmp(cBasicLog, "ACca") == 0, uxBasicLogLength);
+    testCHECK(pxBasicPreempted[2] == (TCB_t *)Basic_Handle[0], 0);
+
+    // 运行结束后可以再次激活
+    prvBasicReset();
+    testCHECK(xTaskActivate(Basic_Handle[0]) == pdPASS, 0);
+    testCHECK(strcmp(cBasicLog, "Aa") == 0, uxBasicLogLength);
+}
+#endif
+/******************************************************************************/
+
+/******************************************************************************/
+#if (configUSE_VIRTUAL_TIME == 0)
+// 顺序锁压力测试的快照, 每个字都写入同一个值, 读到不同的值即为读到了不完整的数据
+#define testSNAPSHOT_WORDS 32
+typedef struct
+{
+    uint32_t ulWords[testSNAPSHOT_WORDS];
+} TestSample_t;
+
+seqlockDEFINE_SNAPSHOT(TestSnapshot, TestSample_t)
+
+static TestSnapshot_t xSnapshot;
+static volatile uint32_t ulSnapshotWrites = 0;
+
+/**
+ * @brief 时基钩子: 写入下一个快照
+ */
+static void prvWriteSnapshotFromTick(void)
+{
+    TestSample_t xSample;
+    const uint32_t ulValue = ulSnapshotWrites + 1UL;
+    uint32_t x;
+
+    for (x = 0; x < testSNAPSHOT_WORDS; x++)
+    {
+        xSample.ulWords[x] = ulValue;
+    }
+    vTestSnapshotWrite(&xSnapshot, &xSample);
+    ulSnapshotWrites = ulValue;
+}
+
+/**
+ * @brief 检查读到的快照是否完整, 且不早于上一次读到的快照
+ * @param const TestSample_t *pxSample
+ * @param uint32_t *pulLast: 上一次读到的值, 检查后更新
+ * @returns BaseType_t: pdTRUE 完整
+ */
+static BaseType_t prvSampleConsistent(const TestSample_t *pxSample, uint32_t *pulLast)
+{
+    uint32_t x;
+
+    for (x = 1; x < testSNAPSHOT_WORDS; x++)
+    {
+        if (pxSample->ulWords[x] != pxSample->ulWords[0])
+        {
+            return pdFALSE;
+        }
+    }
+
+    if (pxSample->ulWords[0] < *pulLast)
+    {
+        return pdFALSE;
+    }
+    *pulLast = pxSample->ulWords[0];
+
+    return pdTRUE;
+}
+
+/**
+ * @brief 中断每个时基写入一次快照, 任务不停地读取, 不能读到不完整的快照.
+ *        交替使用快照读函数和顺序锁的原始接口, 后者统计重试次数, 证明读取确实被写入打断过
+ */
+static void prvTestSeqlockTornRead(void)
+{
+    TestSample_t xSample;
+    uint32_t ulSequence = 0, ulLast = 0, ulReads = 0, ulRetries = 0, ulTorn = 0;
+    const TickType_t xStart = xTickCount;
+
+    vTestSnapshotInit(&xSnapshot);
+    ulSnapshotWrites = 0;
+    pxTickJob = prvWriteSnapshotFromTick;
+
+    while ((TickType_t)(xTickCount - xStart) < testSTRESS_TICKS)
+    {
+        if ((ulReads & 1UL) == 0UL)
+        {
+            vTestSnapshotRead(&xSnapshot, &xSample);
+        }
+        else
+        {
+            ulSequence = ulSeqLockReadBegin(&(xSnapshot.xLock));
+            xSample = xSnapshot.xValue;
+            if (xSeqLockReadRetry(&(xSnapshot.xLock), ulSequence) != pdFALSE)
+            {
+                ulRetries++;
+                continue;
+            }
+        }
+
+        ulReads++;
+        if (prvSampleConsistent(&xSample, &ulLast) == pdFALSE)
+        {
+            ulTorn++;
+        }
+    }
+
+    pxTickJob = NULL;
+
+    testCHECK(ulTorn == 0UL, ulTorn);
+    testCHECK(ulSnapshotWrites >= (testSTRESS_TICKS - 1UL), ulSnapshotWrites);
+    testCHECK(ulRetries > 0UL, ulRetries);
+}
+
+// MPMC 压力测试: 生产者为时基中断和测试任务, 消费者为测试任务和辅助任务 0.
+// 消息为生产者编号和该生产者的序号, 每个消费者分别统计收到每条消息的次数
+#define testMPMC_CAPACITY 16
+#define testMPMC_PRODUCERS 2
+#define testMPMC_CONSUMERS 2
+#define testMPMC_MAX_SEQUENCE 4096
+// 时基中断每个时基最多发送的消息数, 实际数量随机
+#define testMPMC_MAX_PER_TICK 8
+// 测试任务每个时基最多发送的消息数
+#define testMPMC_TASK_PER_TICK 20
+#define testMPMC_ITEM(ulProducer, ulSequence) (((ulProducer) << 24) | (ulSequence))
+
+static MPMCQueue_t xMPMCQueue;
+static uint32_t ulMPMCStorage[mpmcSTORAGE_SIZE(testMPMC_CAPACITY, sizeof(uint32_t)) / sizeof(uint32_t)];
+static uint8_t ucMPMCSeen[testMPMC_CONSUMERS][testMPMC_PRODUCERS][testMPMC_MAX_SEQUENCE];
+// 各消费者收到的消息数
+static volatile uint32_t ulMPMCReceived[testMPMC_CONSUMERS];
+// 各生产者成功发送的消息数, 即下一条消息的序号
+static volatile uint32_t ulMPMCSent[testMPMC_PRODUCERS];
+// 序号超出范围或生产者编号错误的消息数
+static volatile uint32_t ulMPMCInvalid = 0;
+static volatile uint32_t ulMPMCIsrFull = 0;
+static volatile BaseType_t xMPMCDone = pdFALSE;
+static uint32_t ulMPMCRandom = 1UL;
+
+/**
+ * @brief 记录消费者收到的一条消息
+ * @param UBaseType_t uxConsumer: 消费者编号
+ * @param uint32_t ulItem
+ */
+static void prvMPMCRecord(UBaseType_t uxConsumer, uint32_t ulItem)
+{
+    const uint32_t ulProducer = ulItem >> 24;
+    const uint32_t ulSequence = ulItem & 0xffffffUL;
+
+    if ((ulProducer >= testMPMC_PRODUCERS) || (ulSequence >= ulMPMCSent[ulProducer]))
+    {
+        ulMPMCInvalid++;
+        return;
+    }
+
+    ucMPMCSeen[uxConsumer][ulProducer][ulSequence]++;
+    ulMPMCReceived[uxConsumer]++;
+}
+
+/**
+ * @brief 时基钩子: 发送随机条数的消息, 队列满时放弃本时基剩余的消息
+ */
+static void prvMPMCSendFromTick(void)
+{
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+    uint32_t ulItem, ulCount;
+
+    // 线性同余伪随机数, 取高位
+    ulMPMCRandom = (ulMPMCRandom * 1103515245UL) + 12345UL;
+    ulCount = (ulMPMCRandom >> 16) % (testMPMC_MAX_PER_TICK + 1UL);
+
+    while ((ulCount > 0UL) && (ulMPMCSent[0] < testMPMC_MAX_SEQUENCE))
+    {
+        ulItem = testMPMC_ITEM(0UL, ulMPMCSent[0]);
+        // 先计入已发送, 消费者可能在本函数返回之前就收到这条消息
+        ulMPMCSent[0]++;
+        if (xMPMCQueueSendFromISR(&xMPMCQueue, &ulItem, &xHigherPriorityTaskWoken) != pdPASS)
+        {
+            ulMPMCSent[0]--;
+            ulMPMCIsrFull++;
+            break;
+        }
+        ulCount--;
+    }
+
+    // 时基中断结束时总会触发一次任务切换
+    (void)xHigherPriorityTaskWoken;
+}
+
+/**
+ * @brief 辅助任务: 阻塞接收消息, 直到测试结束. 每收到几条消息休眠一个时基, 让测试任务也能收到消息
+ */
+static void prvMPMCConsume(void)
+{
+    uint32_t ulItem = 0, ulReceived = 0;
+
+    while (xMPMCDone == pdFALSE)
+    {
+        if (xMPMCQueueReceive(&xMPMCQueue, &ulItem, 1) == pdPASS)
+        {
+            prvMPMCRecord(1U, ulItem);
+            ulReceived++;
+            if ((ulReceived % 8UL) == 0UL)
+            {
+                vTaskDelay(1);
+            }
+        }
+    }
+}
+
+/**
+ * @brief 时基中断随机地向队列注入消息, 与任务生产者和两个消费者并发, 每条消息恰好被收到一次
+ */
+static void prvTestMPMCStress(void)
+{
+    const TickType_t xStart = xTickCount;
+    uint32_t ulItem = 0, ulProducer, ulSequence, ulCount, ulLost = 0, ulDuplicated = 0;
+    UBaseType_t uxConsumer;
+
+    vMPMCQueueInit(&xMPMCQueue, (uint8_t *)ulMPMCStorage, testMPMC_CAPACITY, sizeof(uint32_t));
+    ulMPMCSent[0] = 0;
+    ulMPMCSent[1] = 0;
+    ulMPMCReceived[0] = 0;
+    ulMPMCReceived[1] = 0;
+    xMPMCDone = pdFALSE;
+
+    prvStartHelper(0U, prvMPMCConsume);
+    pxTickJob = prvMPMCSendFromTick;
+
+    while ((TickType_t)(xTickCount - xStart) < testSTRESS_TICKS)
+    {
+        // 限速发送, 使任务生产者的消息分布在整个测试期间
+        if (ulMPMCSent[1] < (((uint32_t)(xTickCount - xStart) + 1UL) * testMPMC_TASK_PER_TICK))
+        {
+            ulItem = testMPMC_ITEM(1UL, ulMPMCSent[1]);
+            ulMPMCSent[1]++;
+            if (xMPMCQueueSend(&xMPMCQueue, &ulItem) != pdPASS)
+            {
+                ulMPMCSent[1]--;
+            }
+        }
+
+        if (xMPMCQueueTryReceive(&xMPMCQueue, &ulItem) == pdPASS)
+        {
+            prvMPMCRecord(0U, ulItem);
+        }
+    }
+
+    pxTickJob = NULL;
+    xMPMCDone = pdTRUE;
+    // 等辅助任务超时退出
+    vTaskDelay(3);
+
+    while (xMPMCQueueTryReceive(&xMPMCQueue, &ulItem) == pdPASS)
+    {
+        prvMPMCRecord(0U, ulItem);
+    }
+
+    for (ulProducer = 0; ulProducer < testMPMC_PRODUCERS; ulProducer++)
+    {
+        for (ulSequence = 0; ulSequence < ulMPMCSent[ulProducer]; ulSequence++)
+        {
+            ulCount = 0;
+            for (uxConsumer = 0; uxConsumer < testMPMC_CONSUMERS; uxConsumer++)
+            {
+                ulCount += ucMPMCSeen[uxConsumer][ulProducer][ulSequence];
+            }
+
+            if (ulCount == 0UL)
+            {
+                ulLost++;
+            }
+            else if (ulCount > 1UL)
+            {
+                ulDuplicated++;
+            }
+        }
+    }
+
+    testCHECK(ulLost == 0UL, ulLost);
+    testCHECK(ulDuplicated == 0UL, ulDuplicated);
+    testCHECK(ulMPMCInvalid == 0UL, ulMPMCInvalid);
+    // 两个生产者和两个消费者都确实参与了
+    testCHECK(ulMPMCSent[0] > 0UL, ulMPMCSent[0]);
+    testCHECK(ulMPMCSent[1] > 0UL, ulMPMCSent[1]);
+    testCHECK(ulMPMCReceived[0] > 0UL, ulMPMCReceived[0]);
+    testCHECK(ulMPMCReceived[1] > 0UL, ulMPMCReceived[1]);
+    testCHECK(xMPMCQueue.ulWaitingConsumers == 0UL, xMPMCQueue.ulWaitingConsumers);
+}
+#endif
+/******************************************************************************/
+
+/******************************************************************************/
+#if (configUSE_VIRTUAL_TIME == 1)
+// 时基回绕测试: 从 testWRAP_BASE 开始的一组定时事件跨过 xTickCount 溢出, 记录每个事件发生时距 testWRAP_BASE 的时基数
+#define testWRAP_BASE ((TickType_t)0xfffffff0UL)
+#define testWRAP_DELAY 20U
+#define testWRAP_QUEUE_TIMEOUT 24U
+#define testWRAP_NOTIFY_TIMEOUT 28U
+#define testWRAP_EVENTS 4U
+
+// 事件编号
+#define testWRAP_EVENT_DELAY 1U
+#define testWRAP_EVENT_QUEUE 2U
+#define testWRAP_EVENT_NOTIFY 3U
+
+typedef struct
+{
+    uint32_t ulEvent;
+    TickType_t xOffset;
+    long lResult;
+} TestWrapEvent_t;
+
+static TestWrapEvent_t xWrapLog[testWRAP_EVENTS];
+static volatile UBaseType_t uxWrapEvents = 0;
+
+/**
+ * @brief 记录一个事件和它发生时的时基
+ * @param uint32_t ulEvent: 事件编号
+ * @param long lResult: 等待函数的返回值
+ */
+static void prvWrapRecord(uint32_t ulEvent, long lResult)
+{
+    if (uxWrapEvents < testWRAP_EVENTS)
+    {
+        xWrapLog[uxWrapEvents].ulEvent = ulEvent;
+        xWrapLog[uxWrapEvents].xOffset = (TickType_t)(xTickCount - testWRAP_BASE);
+        xWrapLog[uxWrapEvents].lResult = lResult;
+    }
+    uxWrapEvents++;
+}
+
+/**
+ * @brief 辅助任务: 在空队列上等待到超时, 超时时刻在回绕之后
+ */
+static void prvWrapQueueTimeout(void)
+{
+    uint32_t ulItem = 0;
+
+    prvWrapRecord(testWRAP_EVENT_QUEUE, (long)xQueueReceive(xBatchQueue, &ulItem, testWRAP_QUEUE_TIMEOUT));
+}
+
+/**
+ * @brief 辅助任务: 等待任务通知到超时, 超时时刻在回绕之后
+ */
+static void prvWrapNotifyTimeout(void)
+{
+    prvWrapRecord(testWRAP_EVENT_NOTIFY, (long)ulTaskNotifyTake(pdTRUE, testWRAP_NOTIFY_TIMEOUT));
+}
+
+/**
+ * @brief 快进到 testWRAP_BASE, 然后让延时, 队列超时和通知超时同时跨过 xTickCount 溢出
+ * @param TestWrapEvent_t *pxLog: 输出, 本轮的事件记录
+ */
+static void prvWrapRound(TestWrapEvent_t *pxLog)
+{
+    const BaseType_t xOverflows = xNumOfOverflows;
+    UBaseType_t x;
+
+    // 只有测试任务在延时, 虚拟时间一步跳到 testWRAP_BASE, 不足 2^32 个时基, 不会溢出
+    vTaskDelay((TickType_t)(testWRAP_BASE - xTickCount));
+    testCHECK(xTickCount == testWRAP_BASE, xTickCount);
+    testCHECK(xNumOfOverflows == xOverflows, xNumOfOverflows);
+
+    uxWrapEvents = 0;
+    prvStartHelper(0U, prvWrapQueueTimeout);
+    prvStartHelper(1U, prvWrapNotifyTimeout);
+
+    // 三个到期时刻都在回绕之后, 等待中的任务都在溢出延时列表中
+    testCHECK(((TCB_t *)Helper_Handle[0])->xStateListItem.pvContainer == (void *)pxOverflowDelayedTaskList, 0);
+    testCHECK(((TCB_t *)Helper_Handle[1])->xStateListItem.pvContainer == (void *)pxOverflowDelayedTaskList, 0);
+
+    vTaskDelay(testWRAP_DELAY);
+    prvWrapRecord(testWRAP_EVENT_DELAY, 0L);
+    testCHECK(xTickCount == (TickType_t)(testWRAP_BASE + testWRAP_DELAY), xTickCount);
+    testCHECK(xNumOfOverflows == (xOverflows + 1), xNumOfOverflows);
+
+    // 等两个辅助任务都超时
+    vTaskDelay(testWRAP_NOTIFY_TIMEOUT);
+    testCHECK(uxWrapEvents == 3U, uxWrapEvents);
+    testCHECK(xNumOfOverflows == (xOverflows + 1), xNumOfOverflows);
+
+    for (x = 0; x < testWRAP_EVENTS; x++)
+    {
+        pxLog[x] = xWrapLog[x];
+    }
+}
+
+/**
+ * @brief 虚拟时间下两次快进到 xTickCount 回绕前, 检查跨过回绕的延时和超时恰好在预期的时基到期,
+ *        xNumOfOverflows 每次回绕加 1, 两轮的事件序列完全相同
+ */
+static void prvTestVirtualTimeTickWrap(void)
+{
+    static const TestWrapEvent_t xExpected[testWRAP_EVENTS] = {
+        {testWRAP_EVENT_DELAY, testWRAP_DELAY, 0L},
+        {testWRAP_EVENT_QUEUE, testWRAP_QUEUE_TIMEOUT, (long)errQUEUE_EMPTY},
+        {testWRAP_EVENT_NOTIFY, testWRAP_NOTIFY_TIMEOUT, 0L},
+        {0U, 0U, 0L},
+    };
+    static TestWrapEvent_t xFirst[testWRAP_EVENTS];
+    static TestWrapEvent_t xSecond[testWRAP_EVENTS];
+    const BaseType_t xOverflows = xNumOfOverflows;
+    UBaseType_t x;
+
+    memset(xWrapLog, 0, sizeof(xWrapLog));
+    prvWrapRound(xFirst);
+    testCHECK(xNumOfOverflows == (xOverflows + 1), xNumOfOverflows);
+
+    for (x = 0; x < testWRAP_EVENTS; x++)
+    {
+        testCHECK(xFirst[x].ulEvent == xExpected[x].ulEvent, xFirst[x].ulEvent);
+        testCHECK(xFirst[x].xOffset == xExpected[x].xOffset, xFirst[x].xOffset);
+        testCHECK(xFirst[x].lResult == xExpected[x].lResult, xFirst[x].lResult);
+    }
+
+    memset(xWrapLog, 0, sizeof(xWrapLog));
+    prvWrapRound(xSecond);
+    testCHECK(xNumOfOverflows == (xOverflows + 2), xNumOfOverflows);
+    testCHECK(memcmp(xFirst, xSecond, sizeof(xFirst)) == 0, 0);
+}
+#endif
+/******************************************************************************/
+
+/******************************************************************************/
+// 辅助任务开始延时时的时基计数值
+static volatile TickType_t xHelperDelayStart = 0;
+
+/**
+ * @brief 辅助任务: 延时 portMAX_DELAY 个时基
+ */
+static void prvDelayForever(void)
+{
+    xHelperDelayStart = xTickCount;
+    vTaskDelay(portMAX_DELAY);
+}
+
+/**
+ * @brief vTaskDelay(portMAX_DELAY) 是 0xffffffff 个时基的延时, 任务在溢出延时列表中等待到期, 而不是被永久挂起;
+ *        事件等待中的 portMAX_DELAY 仍是无限期等待, 不加入延时列表.
+ *        辅助任务 1 从此不再运行, 本测试必须最后运行
+ */
+static void prvTestDelayMaxIsFinite(void)
+{
+    const TCB_t *const pxHelper = (const TCB_t *)Helper_Handle[1];
+
+    prvStartHelper(1U, prvDelayForever);
+    testCHECK(pxHelper->xStateListItem.pvContainer == (void *)pxOverflowDelayedTaskList, 0);
+    testCHECK(pxHelper->xStateListItem.xItemValue == (TickType_t)(xHelperDelayStart + portMAX_DELAY),
+              pxHelper->xStateListItem.xItemValue);
+
+    // 辅助任务 0 正在无限期等待任务通知
+    testCHECK(((const TCB_t *)Helper_Handle[0])->xStateListItem.pvContainer == NULL, 0);
+}
+/******************************************************************************/
+
+/******************************************************************************/
+/**
+ * @brief 测试任务, 依次运行所有测试, 然后结束调度器
+ */
+void Test_Entry(void *p_arg)
+{
+    (void)p_arg;
+
+    xCeiling1 = xSemaphoreCreateCeilingMutexStatic(1U, &xCeiling1Buffer);
+    xCeiling2 = xSemaphoreCreateCeilingMutexStatic(2U, &xCeiling2Buffer);
+    xInherit = xSemaphoreCreateMutexStatic(&xInheritBuffer);
+    xRecursive = xSemaphoreCreateRecursiveMutexStatic(&xRecursiveBuffer);
+    vTopicInit(&xTopic, "test", sizeof(uint32_t), 1U, ucTopicBuffer);
+    xBatchQueue = xQueueCreateStatic(testBATCH_LENGTH, sizeof(uint32_t), ucBatchQueueStorage, &xBatchQueueBuffer);
+
+    prvRun("mutex_inherit_give_under_ceiling", prvTestInheritGiveUnderCeiling);
+    prvRun("mutex_ceiling_give_keeps_inherited", prvTestCeilingGiveKeepsInherited);
+    prvRun("mutex_ceiling_nested_in_order", prvTestCeilingNestedInOrder);
+    prvRun("mutex_ceiling_nested_out_of_order", prvTestCeilingNestedOutOfOrder);
+    prvRun("mutex_ceiling_contended_blocks", prvTestCeilingContendedBlocks);
+    prvRun("mutex_ceiling_contended_timeout", prvTestCeilingContendedTimeout);
+    prvRun("mutex_recursive_nesting", prvTestRecursiveNesting);
+    prvRun("mutex_recursive_inherit_through_nesting", prvTestRecursiveInheritThroughNesting);
+    prvRun("mutex_recursive_give_not_holder", prvTestRecursiveGiveNotHolder);
+    prvRun("queue_batch_send_wakes_all_receivers", prvTestBatchSendWakesAllReceivers);
+    prvRun("queue_batch_receive_wakes_all_senders", prvTestBatchReceiveWakesAllSenders);
+    prvRun("mailbox_version_wrap", prvTestMailboxVersionWrap);
+    prvRun("topic_wait_stale_notification", prvTestTopicWaitStaleNotification);
+    prvRun("basic_task_nested_activation", prvTestBasicNestedActivation);
+    prvRun("basic_task_deferred_activation", prvTestBasicDeferredActivation);
+    prvRun("basic_task_stack_lifo", prvTestBasicStackLifo);
+#if (configUSE_VIRTUAL_TIME == 0)
+    prvRun("basic_task_reactivate_from_isr", prvTestBasicReactivateFromISR);
+    prvRun("seqlock_torn_read_stress", prvTestSeqlockTornRead);
+    prvRun("mpmc_isr_stress", prvTestMPMCStress);
+#else
+    prvRun("virtual_time_tick_wrap", prvTestVirtualTimeTickWrap);
+#endif
+
+    prvRun("task_delay_max_is_finite", prvTestDelayMaxIsFinite);
+
+    printf("{\"test\":\"done\",\"passed\":%lu,\"failed\":%lu}\n",
+           (unsigned long)ulPassed, (unsigned long)ulFailed);
+    fflush(stdout);
+
+    portEND_SCHEDULER();
+}
+
+/**
+ * @brief 辅助任务, 收到通知后执行测试任务指定的函数
+ */
+void Helper_Entry(void *p_arg)
+{
+    const UBaseType_t uxHelper = (UBaseType_t)(uintptr_t)p_arg;
+
+    for (;;)
+    {
+        (void)ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        if (pxHelperJob[uxHelper] != NULL)
+        {
+            pxHelperJob[uxHelper]();
+        }
+    }
+}
+/******************************************************************************/
+
+int main(void)
+{
+    UBaseType_t x;
+
+    Test_Handle = xTaskCreateStatic((TaskFuntion_t)Test_Entry,
+                                    (char *)"Test",
+                                    (uint32_t)testSTACK_SIZE,
+                                    (void *)NULL,
+                                    (UBaseType_t)testPRIORITY,
+                                    (StackType_t *)TestStack,
+                                    (TCB_t *)&TestTCB);
+    for (x = 0; x < testHELPER_COUNT; x++)
+    {
+        Helper_Handle[x] = xTaskCreateStatic((TaskFuntion_t)Helper_Entry,
+                                             (char *)"Helper",
+                                             (uint32_t)testHELPER_STACK_SIZE,
+                                             (void *)(uintptr_t)x,
+                                             (UBaseType_t)(testPRIORITY + 1U + x),
+                                             (StackType_t *)HelperStack[x],
+                                             (TCB_t *)&HelperTCB[x]);
+    }
+
+    for (x = 0; x < testBASIC_COUNT; x++)
+    {
+        Basic_Handle[x] = xTaskCreateBasic((TaskFuntion_t)Basic_Entry,
+                                           (char *)"Basic",
+                                           (void *)(uintptr_t)x,
+                                           (UBaseType_t)(testPRIORITY + 1U + (x / 2U)),
+                                           (TCB_t *)&BasicTCB[x]);
+    }
+
+    vTaskStartScheduler();
+
+    return (ulFailed == 0U) ? 0 : 1;
+}